@@ -0,0 +1,67 @@
+/*
+	File: Benchmark.cpp
+	Contains: main, operator new
+*/
+
+#include <cstdlib>
+#include <new>
+#include "Benchmark.h"
+
+/// <summary>
+/// Replaces the global operator new to count allocations for the self-checks and the allocation benchmarks.
+/// Array new calls this one, so it is counted too. Aligned new isn't replaced or counted.
+/// </summary>
+/// <param name="bytes">The number of bytes to allocate.</param>
+/// <returns>The memory.</returns>
+void* operator new(size_t bytes)
+{
+	Benchmark::allocations.fetch_add(1, memory_order_relaxed);
+	void* memory = malloc(bytes > 0 ? bytes : 1);
+	if (memory == nullptr)
+		throw bad_alloc();
+	return memory;
+}
+
+/// <summary>
+/// Replaces the nothrow operator new, so it matches the replacement delete even where the runtime's own version doesn't call the one above (e.g. under AddressSanitizer).
+/// </summary>
+/// <param name="bytes">The number of bytes to allocate.</param>
+/// <returns>The memory, or nullptr if it couldn't be allocated.</returns>
+void* operator new(size_t bytes, const nothrow_t&) noexcept
+{
+	Benchmark::allocations.fetch_add(1, memory_order_relaxed);
+	return malloc(bytes > 0 ? bytes : 1);
+}
+
+//GCC sees the malloc in the replacement operator new and warns that free doesn't match new once it inlines these
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, const nothrow_t&) noexcept
+{
+	free(memory);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+/// <summary>
+/// Runs the benchmarks headless. See Benchmark::ParseArguments for the options.
+/// </summary>
+int main(int argc, char** argv)
+{
+	return Benchmark::Main(argc, argv);
+}
\ No newline at end of file
@@ -0,0 +1,2680 @@
+/*
+	File: Benchmark.h
+	Contains: Benchmark
+*/
+
+#pragma once
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <filesystem>
+#include <list>
+#include <vector>
+#include "DynamicList.h"
+#include "LinkedList.h"
+#include "Dequeue.h"
+#include "UnrolledLinkedList.h"
+#include "BinaryTree.h"
+#include "SearchIndex.h"
+#include "SegmentedList.h"
+#include "ExternalSort.h"
+#include "MappedList.h"
+#include "SmallList.h"
+#include "Stack.h"
+#include "BinaryHeap.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/// <summary>
+/// Benchmarks for the sorts and searches in the data structures library, measured against the standard library.
+/// Runs headless: Benchmark.cpp is its main function, built as the benchmark target by the CMakeLists.txt at the root of the repository.
+/// Each algorithm is timed on plain ints, then run once more on Counted ints to count its comparisons and element moves.
+/// Cache misses are read from the hardware counters where the platform allows it (perf_event_open on Linux).
+/// </summary>
+namespace Benchmark
+{
+	/// <summary>
+	/// The order of the values that a sort is given.
+	/// </summary>
+	enum DISTRIBUTION
+	{
+		RANDOM,				//Uniformly random values
+		SORTED,				//Already in ascending order
+		REVERSED,			//In descending order
+		NEARLY_SORTED,		//Ascending order with 1% of the values swapped at random
+		FEW_UNIQUE,			//Random values drawn from only 16 distinct values
+		ORGAN_PIPE,			//Ascending up to the middle, then descending
+		DISTRIBUTION_COUNT
+	};
+
+	/// <summary>
+	/// The format the results are written in.
+	/// </summary>
+	enum OUTPUT_FORMAT
+	{
+		CSV,
+		JSON
+	};
+
+	/// <summary>
+	/// How an algorithm's running time grows, so the slow ones can be kept to sizes that finish.
+	/// </summary>
+	enum COMPLEXITY
+	{
+		N_LOG_N,				//Fast on every input
+		QUADRATIC,				//O(n^2) on every input, only run up to the quadratic limit
+		QUADRATIC_WORST_CASE	//O(n^2) on ordered inputs (e.g. a last-element pivot), only run past the quadratic limit on random input
+	};
+
+	static const char* DISTRIBUTION_NAMES[DISTRIBUTION_COUNT] = { "random", "sorted", "reversed", "nearly_sorted", "few_unique", "organ_pipe" };
+
+	static const unsigned long long LINEAR_SEARCH_BUDGET = 200000000;	//The most elements the linear searches will visit for one size
+	static const unsigned long long KERNEL_BUDGET = 1 << 24;			//The elements each kernel measurement scans, over repeated passes of its array
+	static const int FRAME_SPREAD = 16;		//The frame benchmark's values are drawn from [0, FRAME_SPREAD * size)
+	static const int FRAME_JITTER = 8;		//The most a value in the frame benchmark changes by between frames
+
+	inline atomic<unsigned long long> comparisons(0);	//The number of comparisons made by Counted values
+	inline atomic<unsigned long long> moves(0);			//The number of copies and moves made by Counted values
+	inline atomic<unsigned long long> copies(0);		//The number of copies made by Counted values, which are also counted as moves
+	inline atomic<unsigned long long> allocations(0);	//The number of calls to operator new, counted by the replacement in Benchmark.cpp
+
+	/// <summary>
+	/// A value that counts how many times it is compared, copied and moved.
+	/// Every swap shows up as three moves, and every shift of an insertion as one. Copies are counted again on their own.
+	/// The counters are atomic so the parallel sort can be counted too.
+	/// </summary>
+	template <typename T>
+	struct Counted
+	{
+		T value;
+
+		Counted() : value() {}
+		Counted(const T& _value) : value(_value) {}
+		Counted(const Counted& other) : value(other.value) { moves.fetch_add(1, memory_order_relaxed); copies.fetch_add(1, memory_order_relaxed); }
+		Counted(Counted&& other) noexcept : value(move(other.value)) { moves.fetch_add(1, memory_order_relaxed); }
+
+		Counted& operator= (const Counted& other)
+		{
+			value = other.value;
+			moves.fetch_add(1, memory_order_relaxed);
+			copies.fetch_add(1, memory_order_relaxed);
+			return *this;
+		}
+
+		Counted& operator= (Counted&& other) noexcept
+		{
+			value = move(other.value);
+			moves.fetch_add(1, memory_order_relaxed);
+			return *this;
+		}
+
+		friend bool operator< (const Counted& a, const Counted& b) { comparisons.fetch_add(1, memory_order_relaxed); return a.value < b.value; }
+		friend bool operator> (const Counted& a, const Counted& b) { comparisons.fetch_add(1, memory_order_relaxed); return a.value > b.value; }
+		friend bool operator<= (const Counted& a, const Counted& b) { comparisons.fetch_add(1, memory_order_relaxed); return a.value <= b.value; }
+		friend bool operator>= (const Counted& a, const Counted& b) { comparisons.fetch_add(1, memory_order_relaxed); return a.value >= b.value; }
+		friend bool operator== (const Counted& a, const Counted& b) { comparisons.fetch_add(1, memory_order_relaxed); return a.value == b.value; }
+		friend bool operator!= (const Counted& a, const Counted& b) { comparisons.fetch_add(1, memory_order_relaxed); return a.value != b.value; }
+
+		friend ostream& operator<< (ostream& os, const Counted& counted)
+		{
+			return os << counted.value;
+		}
+	};
+
+	/// <summary>
+	/// Reads the number of cache misses from the processor's hardware counters.
+	/// Counts the calling thread and any threads it starts while counting.
+	/// Not every platform (or virtual machine) exposes the counters, in which case Stop() returns -1.
+	/// </summary>
+	class CacheMissCounter
+	{
+	private:
+		int fd;		//The perf event file descriptor, or -1 if the counter isn't available
+
+	public:
+		/// <summary>
+		/// Default constructor.
+		/// Opens the hardware counter if it is available.
+		/// </summary>
+		CacheMissCounter()
+		{
+			fd = -1;
+#ifdef __linux__
+			perf_event_attr attr;
+			memset(&attr, 0, sizeof(attr));
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.size = sizeof(attr);
+			attr.config = PERF_COUNT_HW_CACHE_MISSES;
+			attr.disabled = 1;
+			attr.inherit = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+		}
+
+		CacheMissCounter(const CacheMissCounter&) = delete;
+		CacheMissCounter& operator= (const CacheMissCounter&) = delete;
+
+		/// <summary>
+		/// Deconstructor.
+		/// </summary>
+		~CacheMissCounter()
+		{
+#ifdef __linux__
+			if (fd != -1)
+				close(fd);
+#endif
+		}
+
+		/// <summary>
+		/// Check if the hardware counter could be opened.
+		/// </summary>
+		/// <returns>True if cache misses can be counted.</returns>
+		bool Available() const
+		{
+			return fd != -1;
+		}
+
+		/// <summary>
+		/// Reset the counter and start counting.
+		/// </summary>
+		void Start()
+		{
+#ifdef __linux__
+			if (fd != -1)
+			{
+				ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+				ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+			}
+#endif
+		}
+
+		/// <summary>
+		/// Stop counting.
+		/// </summary>
+		/// <returns>The number of cache misses since Start(), or -1 if they can't be counted.</returns>
+		long long Stop()
+		{
+#ifdef __linux__
+			if (fd != -1)
+			{
+				ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+				long long count = 0;
+				if (read(fd, &count, sizeof(count)) == (ssize_t)sizeof(count))
+					return count;
+			}
+#endif
+			return -1;
+		}
+	};
+
+	/// <summary>
+	/// The sizes, inputs and output of a benchmark run.
+	/// </summary>
+	struct Config
+	{
+		List<size_t> sizes;					//The number of elements to sort and search
+		List<size_t> pushSizes;				//The number of elements pushed by the amortised push benchmark
+		List<size_t> searchSizes;			//The sizes of the lists searched to find where Find() should switch searches
+		List<size_t> kernelSizes;			//The sizes of the arrays the vectorised kernels scan, small enough to stay in the L1 or L2 cache
+		List<DISTRIBUTION> distributions;	//The inputs to give the sorts
+		unsigned int repetitions;			//The number of times each measurement is taken, the fastest is reported
+		size_t quadraticLimit;				//The largest size the O(n^2) sorts are run on
+		size_t queries;						//The number of searches timed for each size
+		unsigned int frames;				//The number of frames the frame benchmark re-sorts the list for
+		unsigned long long seed;			//The seed of the random inputs, so runs can be repeated
+		OUTPUT_FORMAT format;				//The format the results are written in
+		bool check;							//Run the self-checks instead of the benchmarks
+		size_t externalSortBytes;			//The size of the file to external sort and verify instead of running the benchmarks, or 0
+		size_t memoryBudget;				//The memory budget of the external sort, in bytes
+		string tempDirectory;				//Where the external sort writes its files, the system's temporary directory if empty
+
+		/// <summary>
+		/// Default constructor.
+		/// Runs every distribution on 1,000, 10,000 and 100,000 elements.
+		/// </summary>
+		Config()
+		{
+			sizes.Push(1000);
+			sizes.Push(10000);
+			sizes.Push(100000);
+			for (size_t size = 1000; size <= 10000000; size *= 10)
+				pushSizes.Push(size);
+			for (size_t size = 16; size <= 65536; size *= 2)
+				searchSizes.Push(size);
+			kernelSizes.Push(1024);		//4 KB of ints or floats
+			kernelSizes.Push(4096);		//16 KB, still in L1
+			kernelSizes.Push(32768);	//128 KB, in L2
+			for (int i = 0; i < DISTRIBUTION_COUNT; ++i)
+				distributions.Push((DISTRIBUTION)i);
+			repetitions = 5;
+			quadraticLimit = 20000;
+			queries = 100000;
+			frames = 60;
+			seed = 2019;
+			format = CSV;
+			check = false;
+			externalSortBytes = 0;
+			memoryBudget = ExternalSort<int>::DEFAULT_MEMORY_BUDGET;
+		}
+	};
+
+	/// <summary>
+	/// One measurement of one algorithm.
+	/// </summary>
+	struct Result
+	{
+		string algorithm;				//The name of the algorithm, e.g. List::QuickSort
+		string input;					//The distribution that was sorted, "frames" for the frame benchmark, "queries" for the searches, "uniform_queries"/"skewed_queries" for the search crossovers, "scan" for the vectorised kernels, "push_p99"/"push_max" for the push latencies, "push_amortised" for filling a list, "fill_unreserved"/"fill_reserved"/"push_pop_steady" for the reallocation counts, "construct_1m" for building many small lists, "erase_every_other", or "push_pop"/"push_clear" for the node churn
+		size_t size;					//The number of elements in the container
+		double nsPerElement;			//Nanoseconds per element sorted (per frame for the frame benchmark), per search, for one push, or per element of the list erased from, or per node pushed
+		double comparisons;				//Comparisons per element sorted, or per search
+		double moves;					//Element copies and moves per element sorted, or per search
+		long long cacheMisses;			//Cache misses in the fastest timed run, or -1 if they can't be counted
+		long long allocations;			//Calls to operator new in one run, or -1 if they aren't counted
+	};
+
+	/// <summary>
+	/// Generate the values for a sort.
+	/// </summary>
+	/// <param name="distribution">The order of the values.</param>
+	/// <param name="size">The number of values.</param>
+	/// <param name="rng">The random number generator.</param>
+	/// <returns>The values.</returns>
+	inline List<int> Generate(DISTRIBUTION distribution, size_t size, mt19937_64& rng)
+	{
+		List<int> values(size);
+		uniform_int_distribution<int> any(numeric_limits<int>::min(), numeric_limits<int>::max());
+		uniform_int_distribution<int> few(0, 15);
+
+		for (size_t i = 0; i < size; ++i)
+			switch (distribution)
+			{
+			case RANDOM:
+				values.Push(any(rng));
+				break;
+			case REVERSED:
+				values.Push((int)(size - i));
+				break;
+			case FEW_UNIQUE:
+				values.Push(few(rng));
+				break;
+			case ORGAN_PIPE:
+				values.Push((int)(i < size / 2 ? i : size - i));
+				break;
+			default:
+				values.Push((int)i);
+				break;
+			}
+
+		if (distribution == NEARLY_SORTED && size > 1)
+		{
+			uniform_int_distribution<size_t> index(0, size - 1);
+			for (size_t i = 0; i < size / 100 + 1; ++i)
+				swap(values[index(rng)], values[index(rng)]);
+		}
+		return values;
+	}
+
+	/// <summary>
+	/// Fill a list with values.
+	/// </summary>
+	/// <param name="container">The empty list to fill.</param>
+	/// <param name="values">The values.</param>
+	template <typename T>
+	void Load(List<T>& container, const List<int>& values)
+	{
+		container.Reserve(values.Size());
+		for (size_t i = 0; i < values.Size(); ++i)
+			container.Push(T(values[i]));
+	}
+
+	/// <summary>
+	/// Fill a linked list with values.
+	/// </summary>
+	/// <param name="container">The empty linked list to fill.</param>
+	/// <param name="values">The values.</param>
+	template <typename T, typename Allocator>
+	void Load(LinkedList<T, Allocator>& container, const List<int>& values)
+	{
+		for (size_t i = 0; i < values.Size(); ++i)
+			container.PushBack(T(values[i]));
+	}
+
+	/// <summary>
+	/// Fill an unrolled linked list with values.
+	/// </summary>
+	/// <param name="container">The empty unrolled linked list to fill.</param>
+	/// <param name="values">The values.</param>
+	template <typename T, size_t K, typename Allocator>
+	void Load(UnrolledLinkedList<T, K, Allocator>& container, const List<int>& values)
+	{
+		for (size_t i = 0; i < values.Size(); ++i)
+			container.PushBack(T(values[i]));
+	}
+
+	/// <summary>
+	/// Check that a list is in ascending order.
+	/// </summary>
+	/// <param name="container">The list to check.</param>
+	/// <returns>True if the list is sorted.</returns>
+	template <typename T>
+	bool IsSorted(const List<T>& container)
+	{
+		for (size_t i = 1; i < container.Size(); ++i)
+			if (container[i] < container[i - 1])
+				return false;
+		return true;
+	}
+
+	/// <summary>
+	/// Check that a linked list is in ascending order.
+	/// </summary>
+	/// <param name="container">The linked list to check.</param>
+	/// <returns>True if the linked list is sorted.</returns>
+	template <typename T, typename Allocator>
+	bool IsSorted(const LinkedList<T, Allocator>& container)
+	{
+		if (container.Empty())
+			return true;
+		auto previous = container.Begin();
+		auto iter = previous;
+		for (++iter; iter != container.End(); ++iter, ++previous)
+			if (*iter < *previous)
+				return false;
+		return true;
+	}
+
+	/// <summary>
+	/// Check that an unrolled linked list is in ascending order.
+	/// </summary>
+	/// <param name="container">The unrolled linked list to check.</param>
+	/// <returns>True if the unrolled linked list is sorted.</returns>
+	template <typename T, size_t K, typename Allocator>
+	bool IsSorted(const UnrolledLinkedList<T, K, Allocator>& container)
+	{
+		if (container.Empty())
+			return true;
+		auto previous = container.Begin();
+		auto iter = previous;
+		for (++iter; iter != container.End(); ++iter, ++previous)
+			if (*iter < *previous)
+				return false;
+		return true;
+	}
+
+	/// <summary>
+	/// Time a sort on every size and distribution, then count its comparisons and moves.
+	/// </summary>
+	/// <param name="algorithm">The name of the sort.</param>
+	/// <param name="complexity">How the sort's running time grows.</param>
+	/// <param name="sort">Sorts a container of either type.</param>
+	/// <param name="config">The sizes and distributions to run.</param>
+	/// <param name="results">Receives the measurements.</param>
+	template <typename Container, typename CountedContainer, typename SortFn>
+	void RunSort(const char* algorithm, COMPLEXITY complexity, SortFn sort, const Config& config, List<Result>& results)
+	{
+		CacheMissCounter cacheMisses;
+		for (size_t s = 0; s < config.sizes.Size(); ++s)
+			for (size_t d = 0; d < config.distributions.Size(); ++d)
+			{
+				size_t size = config.sizes[s];
+				DISTRIBUTION distribution = config.distributions[d];
+				if (size == 0)
+					continue;
+				if (size > config.quadraticLimit && (complexity == QUADRATIC || (complexity == QUADRATIC_WORST_CASE && distribution != RANDOM)))
+					continue;
+
+				mt19937_64 rng(config.seed + size * DISTRIBUTION_COUNT + distribution);
+				List<int> values = Generate(distribution, size, rng);
+
+				Result result;
+				result.algorithm = algorithm;
+				result.input = DISTRIBUTION_NAMES[distribution];
+				result.size = size;
+				result.nsPerElement = numeric_limits<double>::max();
+				result.cacheMisses = -1;
+				result.allocations = -1;
+
+				for (unsigned int r = 0; r < config.repetitions || r == 0; ++r)
+				{
+					Container container;
+					Load(container, values);
+
+					cacheMisses.Start();
+					auto start = chrono::steady_clock::now();
+					sort(container);
+					auto end = chrono::steady_clock::now();
+					long long misses = cacheMisses.Stop();
+
+					if (!IsSorted(container))
+						throw logic_error(string(algorithm) + " did not sort the " + result.input + " input.");
+
+					double ns = (double)chrono::duration_cast<chrono::nanoseconds>(end - start).count() / size;
+					if (ns < result.nsPerElement)
+					{
+						result.nsPerElement = ns;
+						result.cacheMisses = misses;
+					}
+				}
+
+				//Count on a separate run so the counting doesn't slow down the timed runs
+				CountedContainer counted;
+				Load(counted, values);
+				comparisons = 0;
+				moves = 0;
+				sort(counted);
+				result.comparisons = (double)comparisons / size;
+				result.moves = (double)moves / size;
+
+				results.Push(result);
+			}
+	}
+
+	/// <summary>
+	/// Replay a list that is re-sorted every frame after its values change a little, like sprites sorted by depth.
+	/// Every frame each value moves by up to FRAME_JITTER, then the list is sorted again.
+	/// The frames are seeded so every sort sees the same changes.
+	/// </summary>
+	/// <param name="list">The list to replay, already sorted.</param>
+	/// <param name="sort">Sorts the list.</param>
+	/// <param name="config">The number of frames to replay.</param>
+	/// <param name="seed">The seed of the changes.</param>
+	/// <returns>The nanoseconds spent sorting over all of the frames.</returns>
+	template <typename T, typename SortFn>
+	long long ReplayFrames(List<T>& list, SortFn sort, const Config& config, unsigned long long seed)
+	{
+		mt19937_64 rng(seed);
+		uniform_int_distribution<int> jitter(-FRAME_JITTER, FRAME_JITTER);
+		long long ns = 0;
+		for (unsigned int f = 0; f < config.frames; ++f)
+		{
+			for (size_t i = 0; i < list.Size(); ++i)
+				if constexpr (is_same_v<T, int>)
+					list[i] += jitter(rng);
+				else
+					list[i].value += jitter(rng);
+
+			auto start = chrono::steady_clock::now();
+			sort(list);
+			auto end = chrono::steady_clock::now();
+			ns += chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+		}
+		return ns;
+	}
+
+	/// <summary>
+	/// Time a sort on every size re-sorting a list each frame after small changes, then count its comparisons and moves.
+	/// Only the sorts of the changed frames are measured, not the first sort of the random values.
+	/// </summary>
+	/// <param name="algorithm">The name of the sort.</param>
+	/// <param name="sort">Sorts a list of either type.</param>
+	/// <param name="config">The sizes and number of frames to run.</param>
+	/// <param name="results">Receives the measurements.</param>
+	template <typename SortFn>
+	void RunFrames(const char* algorithm, SortFn sort, const Config& config, List<Result>& results)
+	{
+		if (config.frames == 0)
+			return;
+
+		for (size_t s = 0; s < config.sizes.Size(); ++s)
+		{
+			size_t size = config.sizes[s];
+			if (size == 0)
+				continue;
+
+			mt19937_64 rng(config.seed + size);
+			uniform_int_distribution<int> any(0, (int)(FRAME_SPREAD * size));
+			List<int> values(size);
+			for (size_t i = 0; i < size; ++i)
+				values.Push(any(rng));
+
+			Result result;
+			result.algorithm = algorithm;
+			result.input = "frames";
+			result.size = size;
+			result.nsPerElement = numeric_limits<double>::max();
+			result.cacheMisses = -1;
+			result.allocations = -1;
+
+			for (unsigned int r = 0; r < config.repetitions || r == 0; ++r)
+			{
+				List<int> list = values;
+				sort(list);
+				double ns = (double)ReplayFrames(list, sort, config, config.seed + size) / ((double)size * config.frames);
+				if (!IsSorted(list))
+					throw logic_error(string(algorithm) + " did not sort the frames input.");
+				if (ns < result.nsPerElement)
+					result.nsPerElement = ns;
+			}
+
+			//Count on a separate run so the counting doesn't slow down the timed runs
+			List<Counted<int>> counted;
+			Load(counted, values);
+			sort(counted);
+			comparisons = 0;
+			moves = 0;
+			ReplayFrames(counted, sort, config, config.seed + size);
+			result.comparisons = (double)comparisons / ((double)size * config.frames);
+			result.moves = (double)moves / ((double)size * config.frames);
+
+			results.Push(result);
+		}
+	}
+
+	/// <summary>
+	/// Time a search on every size, then count its comparisons and moves.
+	/// The container holds the even numbers 0, 2, ..., 2(size - 1) and the queries are drawn from [0, 2 * size), so half of them are found.
+	/// </summary>
+	/// <param name="algorithm">The name of the search.</param>
+	/// <param name="linear">True if the search is O(n), which limits the number of queries.</param>
+	/// <param name="build">Builds the container to search from the sorted values and the same values in random order.</param>
+	/// <param name="search">Searches the container for a value, returning something that depends on the result.</param>
+	/// <param name="config">The sizes to run.</param>
+	/// <param name="results">Receives the measurements.</param>
+	template <typename BuildFn, typename SearchFn>
+	void RunSearch(const char* algorithm, bool linear, BuildFn build, SearchFn search, const Config& config, List<Result>& results)
+	{
+		CacheMissCounter cacheMisses;
+		volatile long long sink = 0;	//Stops the compiler throwing away the searches
+		for (size_t s = 0; s < config.sizes.Size(); ++s)
+		{
+			size_t size = config.sizes[s];
+			if (size == 0)
+				continue;
+
+			size_t count = config.queries;
+			if (linear && count > LINEAR_SEARCH_BUDGET / size)
+				count = LINEAR_SEARCH_BUDGET / size > 0 ? (size_t)(LINEAR_SEARCH_BUDGET / size) : 1;
+			if (count == 0)
+				continue;
+
+			mt19937_64 rng(config.seed + size);
+			List<int> sorted(size);
+			for (size_t i = 0; i < size; ++i)
+				sorted.Push((int)(2 * i));
+			List<int> shuffled = sorted;
+			shuffle(&shuffled[0], &shuffled[0] + size, rng);
+			uniform_int_distribution<int> any(0, (int)(2 * size - 1));
+			List<int> queries(count);
+			for (size_t i = 0; i < count; ++i)
+				queries.Push(any(rng));
+
+			Result result;
+			result.algorithm = algorithm;
+			result.input = "queries";
+			result.size = size;
+			result.nsPerElement = numeric_limits<double>::max();
+			result.cacheMisses = -1;
+			result.allocations = -1;
+
+			auto container = build(sorted, shuffled);
+			for (unsigned int r = 0; r < config.repetitions || r == 0; ++r)
+			{
+				long long total = 0;
+				cacheMisses.Start();
+				auto start = chrono::steady_clock::now();
+				for (size_t i = 0; i < count; ++i)
+					total += search(container, queries[i]);
+				auto end = chrono::steady_clock::now();
+				long long misses = cacheMisses.Stop();
+				sink = sink + total;
+
+				double ns = (double)chrono::duration_cast<chrono::nanoseconds>(end - start).count() / count;
+				if (ns < result.nsPerElement)
+				{
+					result.nsPerElement = ns;
+					result.cacheMisses = misses;
+				}
+			}
+
+			//Count on a separate run so the counting doesn't slow down the timed runs
+			List<Counted<int>> countedSorted;
+			List<Counted<int>> countedShuffled;
+			Load(countedSorted, sorted);
+			Load(countedShuffled, shuffled);
+			auto counted = build(countedSorted, countedShuffled);
+			Counted<int> query;
+			long long total = 0;
+			comparisons = 0;
+			moves = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				query.value = queries[i];
+				total += search(counted, query);
+			}
+			sink = sink + total;
+			result.comparisons = (double)comparisons / count;
+			result.moves = (double)moves / count;
+
+			results.Push(result);
+		}
+	}
+
+	/// <summary>
+	/// A 256-byte record sorted by its key, for the sorts of large values.
+	/// The key can be a Counted<int>, so moving a record counts one move.
+	/// </summary>
+	template <typename Key>
+	struct LargeRecord
+	{
+		Key key;
+		char payload[256 - sizeof(Key)] = {};
+
+		LargeRecord() : key() {}
+		LargeRecord(int value) : key(value) {}
+
+		friend bool operator< (const LargeRecord& a, const LargeRecord& b) { return a.key < b.key; }
+	};
+
+	/// <summary>
+	/// A search key the vectorised scan doesn't support, so Find() uses the scalar thresholds for it.
+	/// </summary>
+	struct SearchKey
+	{
+		int value;
+
+		friend bool operator== (const SearchKey& a, const SearchKey& b) { return a.value == b.value; }
+		friend bool operator!= (const SearchKey& a, const SearchKey& b) { return a.value != b.value; }
+		friend bool operator< (const SearchKey& a, const SearchKey& b) { return a.value < b.value; }
+		friend bool operator> (const SearchKey& a, const SearchKey& b) { return a.value > b.value; }
+	};
+
+	/// <summary>
+	/// Time a search of a sorted list on each of the search sizes, which straddle the sizes Find() switches between searches at.
+	/// The uniform input holds the even numbers 0, 2, ..., 2(size - 1). The skewed input holds even numbers that grow exponentially,
+	/// so most of them bunch up at the start of the range. Half of the queries are found.
+	/// The comparisons and moves aren't counted, as the searches need a plain number to interpolate.
+	/// </summary>
+	/// <param name="algorithm">The name of the search.</param>
+	/// <param name="linear">True if the search is O(n), which limits the number of queries.</param>
+	/// <param name="skewed">Whether to search the skewed input rather than the uniform one.</param>
+	/// <param name="search">Searches the list for a value, returning something that depends on the result.</param>
+	/// <param name="config">The sizes to run.</param>
+	/// <param name="results">Receives the measurements.</param>
+	template <typename T, typename SearchFn>
+	void RunSearchCrossover(const char* algorithm, bool linear, bool skewed, SearchFn search, const Config& config, List<Result>& results)
+	{
+		CacheMissCounter cacheMisses;
+		volatile long long sink = 0;	//Stops the compiler throwing away the searches
+		for (size_t s = 0; s < config.searchSizes.Size(); ++s)
+		{
+			size_t size = config.searchSizes[s];
+			if (size == 0)
+				continue;
+
+			size_t count = config.queries;
+			if (linear && count > LINEAR_SEARCH_BUDGET / size)
+				count = LINEAR_SEARCH_BUDGET / size > 0 ? (size_t)(LINEAR_SEARCH_BUDGET / size) : 1;
+			if (count == 0)
+				continue;
+
+			mt19937_64 rng(config.seed + size);
+			List<int> values(size);
+			for (size_t i = 0; i < size; ++i)
+				values.Push(skewed ? 2 * ((int)i + (int)exp(20.0 * i / size)) : (int)(2 * i));
+			List<T> list(size);
+			for (size_t i = 0; i < size; ++i)
+				list.Push(T{ values[i] });
+			list.CheckSorted();
+
+			//Odd queries are never in the list
+			uniform_int_distribution<size_t> any(0, size - 1);
+			List<T> queries(count);
+			for (size_t i = 0; i < count; ++i)
+				queries.Push(T{ values[any(rng)] + (int)(rng() & 1) });
+
+			Result result;
+			result.algorithm = algorithm;
+			result.input = skewed ? "skewed_queries" : "uniform_queries";
+			result.size = size;
+			result.nsPerElement = numeric_limits<double>::max();
+			result.comparisons = 0;
+			result.moves = 0;
+			result.cacheMisses = -1;
+			result.allocations = -1;
+
+			for (unsigned int r = 0; r < config.repetitions || r == 0; ++r)
+			{
+				long long total = 0;
+				cacheMisses.Start();
+				auto start = chrono::steady_clock::now();
+				for (size_t i = 0; i < count; ++i)
+					total += search(list, queries[i]);
+				auto end = chrono::steady_clock::now();
+				long long misses = cacheMisses.Stop();
+				sink = sink + total;
+
+				double ns = (double)chrono::duration_cast<chrono::nanoseconds>(end - start).count() / count;
+				if (ns < result.nsPerElement)
+				{
+					result.nsPerElement = ns;
+					result.cacheMisses = misses;
+				}
+			}
+
+			results.Push(result);
+		}
+	}
+
+	/// <summary>
+	/// Time each vectorised kernel against its scalar version on arrays small enough to stay in the L1 or L2 cache.
+	/// Every instruction set the processor supports is run, scanning the same array until KERNEL_BUDGET elements have been read.
+	/// FindFirst and Count look for a value that isn't in the array, so they scan all of it.
+	/// The time is per element scanned, and the comparisons and moves aren't counted.
+	/// </summary>
+	/// <param name="typeName">The name of T in the results.</param>
+	/// <param name="config">The sizes to run.</param>
+	/// <param name="results">Receives the measurements.</param>
+	template <typename T>
+	void RunKernels(const char* typeName, const Config& config, List<Result>& results)
+	{
+		const char* kernelNames[] = { "FindFirst", "Count", "Sum", "MinMax" };
+		const char* levelNames[] = { "scalar", "sse4.2", "avx2" };
+		volatile double sink = 0;	//Stops the compiler throwing away the kernels
+		for (size_t s = 0; s < config.kernelSizes.Size(); ++s)
+		{
+			size_t size = config.kernelSizes[s];
+			if (size == 0)
+				continue;
+
+			mt19937_64 rng(config.seed + size);
+			List<T> values(size);
+			for (size_t i = 0; i < size; ++i)
+				values.Push((T)(rng() % 1000));
+			const T missing = (T)-1;
+			const T* volatile array = &values[0];	//Read again on every pass, so the passes can't be merged
+			size_t passes = KERNEL_BUDGET / size > 0 ? (size_t)(KERNEL_BUDGET / size) : 1;
+
+			for (int level = SimdKernels::SIMD_SCALAR; level <= SimdKernels::Level(); ++level)
+				for (int kernel = 0; kernel < 4; ++kernel)
+				{
+					SimdKernels::SIMD_LEVEL limit = (SimdKernels::SIMD_LEVEL)level;
+					Result result;
+					result.algorithm = string("SimdKernels::") + kernelNames[kernel] + "<" + typeName + ">(" + levelNames[level] + ")";
+					result.input = "scan";
+					result.size = size;
+					result.nsPerElement = numeric_limits<double>::max();
+					result.comparisons = 0;
+					result.moves = 0;
+					result.cacheMisses = -1;
+					result.allocations = -1;
+
+					for (unsigned int r = 0; r < config.repetitions || r == 0; ++r)
+					{
+						double total = 0;
+						auto start = chrono::steady_clock::now();
+						for (size_t pass = 0; pass < passes; ++pass)
+						{
+							const T* data = array;
+							if (kernel == 0)
+								total += (double)SimdKernels::FindFirst(data, size, missing, limit);
+							else if (kernel == 1)
+								total += (double)SimdKernels::Count(data, size, missing, limit);
+							else if (kernel == 2)
+								total += (double)SimdKernels::Sum(data, size, limit);
+							else
+							{
+								T smallest;
+								T largest;
+								SimdKernels::MinMax(data, size, smallest, largest, limit);
+								total += (double)smallest + (double)largest;
+							}
+						}
+						auto end = chrono::steady_clock::now();
+						sink = sink + total;
+
+						double ns = (double)chrono::duration_cast<chrono::nanoseconds>(end - start).count() / ((double)passes * size);
+						if (ns < result.nsPerElement)
+							result.nsPerElement = ns;
+					}
+
+					results.Push(result);
+				}
+		}
+	}
+
+	/// <summary>
+	/// Time every push while filling a container from empty, and report the 99th percentile and the slowest push.
+	/// A list that grows by copying its array has rare slow pushes that barely move the average but show up as frame spikes.
+	/// Each push is timed on its own, so the times include the clock's overhead.
+	/// The moves are counted per push, including the moves made when the container grows.
+	/// </summary>
+	/// <param name="algorithm">The name of the container.</param>
+	/// <param name="config">The sizes to run.</param>
+	/// <param name="results">Receives the measurements.</param>
+	template <typename Container, typename CountedContainer>
+	void RunPushLatency(const char* algorithm, const Config& config, List<Result>& results)
+	{
+		for (size_t s = 0; s < config.sizes.Size(); ++s)
+		{
+			size_t size = config.sizes[s];
+			if (size == 0)
+				continue;
+
+			Result percentile;
+			percentile.algorithm = algorithm;
+			percentile.input = "push_p99";
+			percentile.size = size;
+			percentile.nsPerElement = numeric_limits<double>::max();
+			percentile.cacheMisses = -1;
+			percentile.allocations = -1;
+			Result slowest = percentile;
+			slowest.input = "push_max";
+
+			List<long long> latencies(size);
+			for (unsigned int r = 0; r < config.repetitions || r == 0; ++r)
+			{
+				latencies.Clear();
+				latencies.Reserve(size);
+				{
+					Container container;
+					for (size_t i = 0; i < size; ++i)
+					{
+						auto start = chrono::steady_clock::now();
+						container.Push((int)i);
+						auto end = chrono::steady_clock::now();
+						latencies.Push(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+					}
+				}
+
+				latencies.RadixSort();
+				double p99 = (double)latencies[size * 99 / 100];
+				double max = (double)latencies[size - 1];
+				if (p99 < percentile.nsPerElement)
+					percentile.nsPerElement = p99;
+				if (max < slowest.nsPerElement)
+					slowest.nsPerElement = max;
+			}
+
+			//Count on a separate run so the counting doesn't slow down the timed runs
+			{
+				CountedContainer counted;
+				comparisons = 0;
+				moves = 0;
+				for (size_t i = 0; i < size; ++i)
+					counted.Push(Counted<int>((int)i));
+				percentile.comparisons = slowest.comparisons = (double)comparisons / size;
+				percentile.moves = slowest.moves = (double)moves / size;
+			}
+
+			results.Push(percentile);
+			results.Push(slowest);
+		}
+	}
+
+	/// <summary>
+	/// Time filling a list from empty by pushing one value at a time, to show that the average push stays constant as the list grows.
+	/// The moves per push include the moves made when the list grows, which the growth factor keeps to a constant per push.
+	/// </summary>
+	/// <param name="algorithm">The name of the list and its growth factor.</param>
+	/// <param name="growthFactor">The factor the list grows by when it is full.</param>
+	/// <param name="config">The sizes to run.</param>
+	/// <param name="results">Receives the measurements.</param>
+	inline void RunPushAmortised(const char* algorithm, float growthFactor, const Config& config, List<Result>& results)
+	{
+		for (size_t s = 0; s < config.pushSizes.Size(); ++s)
+		{
+			size_t size = config.pushSizes[s];
+			if (size == 0)
+				continue;
+
+			Result result;
+			result.algorithm = algorithm;
+			result.input = "push_amortised";
+			result.size = size;
+			result.nsPerElement = numeric_limits<double>::max();
+			result.cacheMisses = -1;
+			result.allocations = -1;
+
+			for (unsigned int r = 0; r < config.repetitions || r == 0; ++r)
+			{
+				List<int> list;
+				list.SetGrowthFactor(growthFactor);
+				auto start = chrono::steady_clock::now();
+				for (size_t i = 0; i < size; ++i)
+					list.Push((int)i);
+				auto end = chrono::steady_clock::now();
+
+				if (list.Size() != size)
+					throw logic_error(string(algorithm) + " did not keep every value.");
+				double ns = (double)chrono::duration_cast<chrono::nanoseconds>(end - start).count() / size;
+				if (ns < result.nsPerElement)
+					result.nsPerElement = ns;
+			}
+
+			//Count on a separate run so the counting doesn't slow down the timed runs
+			{
+				List<Counted<int>> counted;
+				counted.SetGrowthFactor(growthFactor);
+				comparisons = 0;
+				moves = 0;
+				for (size_t i = 0; i < size; ++i)
+					counted.Push(Counted<int>((int)i));
+				result.comparisons = (double)comparisons / size;
+				result.moves = (double)moves / size;
+			}
+
+			results.Push(result);
+		}
+	}
+
+	/// <summary>
+	/// Check whether operator new is being counted, i.e. the executable replaced it.
+	/// </summary>
+	/// <returns>True if allocations are counted.</returns>
+	inline bool CountingAllocations()
+	{
+		//Called directly, as a new expression could be optimised away
+		unsigned long long before = allocations;
+		::operator delete(::operator new(1));
+		return allocations != before;
+	}
+
+	/// <summary>
+	/// Count the calls to operator new made by pushing values to a list.
+	/// "fill_unreserved" fills an empty list and allocates each time it grows, "fill_reserved" reserves the capacity first so the pushes never allocate.
+	/// "push_pop_steady" pops a full list until it shrinks, then pushes and pops a value at a time at that size,
+	/// which shouldn't allocate either as the list only shrinks again once it is a quarter full.
+	/// The allocations are only counted when the executable replaces operator new, as Benchmark.cpp does.
+	/// </summary>
+	/// <param name="config">The sizes to run.</param>
+	/// <param name="results">Receives the measurements.</param>
+	inline void RunReallocations(const Config& config, List<Result>& results)
+	{
+		const char* inputs[] = { "fill_unreserved", "fill_reserved", "push_pop_steady" };
+		bool counting = CountingAllocations();
+		for (size_t s = 0; s < config.pushSizes.Size(); ++s)
+		{
+			size_t size = config.pushSizes[s];
+			if (size == 0)
+				continue;
+
+			for (int input = 0; input < 3; ++input)
+			{
+				Result result;
+				result.algorithm = "List::Push";
+				result.input = inputs[input];
+				result.size = size;
+				result.nsPerElement = numeric_limits<double>::max();
+				result.comparisons = 0;
+				result.moves = 0;
+				result.cacheMisses = -1;
+				result.allocations = -1;
+
+				for (unsigned int r = 0; r < config.repetitions || r == 0; ++r)
+				{
+					List<int> list;
+					if (input == 1)
+						list.Reserve(size);
+					else if (input == 2)
+					{
+						for (size_t i = 0; i < size; ++i)
+							list.Push((int)i);
+						size_t capacity = list.Capacity();
+						while (list.Size() > 0 && list.Capacity() == capacity)
+							list.Pop();
+					}
+
+					unsigned long long before = allocations;
+					auto start = chrono::steady_clock::now();
+					if (input == 2)
+						for (size_t i = 0; i < size; ++i)
+						{
+							list.Push((int)i);
+							list.Pop();
+						}
+					else
+						for (size_t i = 0; i < size; ++i)
+							list.Push((int)i);
+					auto end = chrono::steady_clock::now();
+					unsigned long long after = allocations;
+
+					double ns = (double)chrono::duration_cast<chrono::nanoseconds>(end - start).count() / size;
+					if (ns < result.nsPerElement)
+						result.nsPerElement = ns;
+					if (counting)
+						result.allocations = (long long)(after - before);
+				}
+
+				results.Push(result);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Erase every other element of a linked list while iterating through it.
+	/// </summary>
+	/// <param name="container">The linked list.</param>
+	template <typename Container>
+	void EraseEveryOther(Container& container)
+	{
+		auto iter = container.Begin();
+		while (iter != container.End())
+		{
+			iter = container.Erase(iter);
+			if (iter != container.End())
+				++iter;
+		}
+	}
+
+	/// <summary>
+	/// Time erasing every other element of a linked list in one pass.
+	/// With constant time erases the time per element stays flat as the size grows; an erase that searches for its node makes it grow linearly.
+	/// </summary>
+	/// <param name="algorithm">The name of the container.</param>
+	/// <param name="config">The sizes to run.</param>
+	/// <param name="results">Receives the measurements.</param>
+	template <typename Container, typename CountedContainer>
+	void RunEraseEveryOther(const char* algorithm, const Config& config, List<Result>& results)
+	{
+		CacheMissCounter cacheMisses;
+		for (size_t s = 0; s < config.sizes.Size(); ++s)
+		{
+			size_t size = config.sizes[s];
+			if (size == 0)
+				continue;
+
+			mt19937_64 rng(config.seed + size);
+			List<int> values = Generate(RANDOM, size, rng);
+
+			Result result;
+			result.algorithm = algorithm;
+			result.input = "erase_every_other";
+			result.size = size;
+			result.nsPerElement = numeric_limits<double>::max();
+			result.cacheMisses = -1;
+			result.allocations = -1;
+
+			for (unsigned int r = 0; r < config.repetitions || r == 0; ++r)
+			{
+				Container container;
+				Load(container, values);
+
+				cacheMisses.Start();
+				auto start = chrono::steady_clock::now();
+				EraseEveryOther(container);
+				auto end = chrono::steady_clock::now();
+				long long misses = cacheMisses.Stop();
+
+				if (container.Size() != size / 2)
+					throw logic_error(string(algorithm) + " did not erase every other element.");
+
+				double ns = (double)chrono::duration_cast<chrono::nanoseconds>(end - start).count() / size;
+				if (ns < result.nsPerElement)
+				{
+					result.nsPerElement = ns;
+					result.cacheMisses = misses;
+				}
+			}
+
+			//Count on a separate run so the counting doesn't slow down the timed runs
+			CountedContainer counted;
+			Load(counted, values);
+			comparisons = 0;
+			moves = 0;
+			EraseEveryOther(counted);
+			result.comparisons = (double)comparisons / size;
+			result.moves = (double)moves / size;
+
+			results.Push(result);
+		}
+	}
+
+	/// <summary>
+	/// Fill a node container and empty it again once per frame, as a container of per-frame objects would be.
+	/// "push_pop" pops every node off the front, "push_clear" clears the container in one call.
+	/// With the default allocator every node is a call to new and delete; a pool reuses the nodes from the frame before.
+	/// </summary>
+	/// <param name="algorithm">The name of the container and its allocator.</param>
+	/// <param name="config">The sizes and the number of frames to run.</param>
+	/// <param name="results">Receives the measurements.</param>
+	template <typename Container, typename CountedContainer>
+	void RunNodeChurn(const char* algorithm, const Config& config, List<Result>& results)
+	{
+		CacheMissCounter cacheMisses;
+		unsigned int frames = config.frames > 0 ? config.frames : 1;
+		for (size_t s = 0; s < config.sizes.Size(); ++s)
+		{
+			size_t size = config.sizes[s];
+			if (size == 0)
+				continue;
+
+			for (int clear = 0; clear < 2; ++clear)
+			{
+				Result result;
+				result.algorithm = algorithm;
+				result.input = clear ? "push_clear" : "push_pop";
+				result.size = size;
+				result.nsPerElement = numeric_limits<double>::max();
+				result.cacheMisses = -1;
+				result.allocations = -1;
+
+				for (unsigned int r = 0; r < config.repetitions || r == 0; ++r)
+				{
+					Container container;
+
+					cacheMisses.Start();
+					auto start = chrono::steady_clock::now();
+					for (unsigned int f = 0; f < frames; ++f)
+					{
+						for (size_t i = 0; i < size; ++i)
+							container.PushBack((int)i);
+						if (clear)
+							container.Clear();
+						else
+							while (!container.Empty())
+								container.PopFront();
+					}
+					auto end = chrono::steady_clock::now();
+					long long misses = cacheMisses.Stop();
+
+					double ns = (double)chrono::duration_cast<chrono::nanoseconds>(end - start).count() / ((double)size * frames);
+					if (ns < result.nsPerElement)
+					{
+						result.nsPerElement = ns;
+						result.cacheMisses = misses;
+					}
+				}
+
+				//Count on a separate run so the counting doesn't slow down the timed runs
+				CountedContainer counted;
+				comparisons = 0;
+				moves = 0;
+				for (size_t i = 0; i < size; ++i)
+					counted.PushBack(Counted<int>((int)i));
+				if (clear)
+					counted.Clear();
+				else
+					while (!counted.Empty())
+						counted.PopFront();
+				result.comparisons = (double)comparisons / size;
+				result.moves = (double)moves / size;
+
+				results.Push(result);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Time constructing a million lists, pushing a few values to each and destroying them, like the small per-cell lists of a spatial grid.
+	/// The size is the number of values pushed to each list; a List allocates for every one, a SmallList only once it holds more than its inline capacity.
+	/// The allocations are only counted when the executable replaces operator new, as Benchmark.cpp does.
+	/// </summary>
+	/// <param name="algorithm">The name of the list.</param>
+	/// <param name="results">Receives the measurements.</param>
+	template <typename Container>
+	void RunConstructions(const char* algorithm, List<Result>& results)
+	{
+		const size_t constructions = 1000000;
+		const size_t sizes[] = { 0, 8, 16, 32 };
+		volatile long long sink = 0;	//Stops the compiler throwing away the lists
+		bool counting = CountingAllocations();
+		for (size_t size : sizes)
+		{
+			Result result;
+			result.algorithm = algorithm;
+			result.input = "construct_1m";
+			result.size = size;
+			result.comparisons = 0;
+			result.moves = 0;
+			result.cacheMisses = -1;
+			result.allocations = -1;
+
+			long long total = 0;
+			unsigned long long before = allocations;
+			auto start = chrono::steady_clock::now();
+			for (size_t c = 0; c < constructions; ++c)
+			{
+				Container list;
+				for (size_t i = 0; i < size; ++i)
+					list.Push((int)i);
+				total += (long long)list.Size();
+			}
+			auto end = chrono::steady_clock::now();
+			unsigned long long after = allocations;
+			sink = sink + total;
+
+			result.nsPerElement = (double)chrono::duration_cast<chrono::nanoseconds>(end - start).count() / constructions;
+			if (counting)
+				result.allocations = (long long)(after - before);
+
+			results.Push(result);
+		}
+	}
+
+	/// <summary>
+	/// Run every sort and search in the library, and the standard library's equivalents, then the push latencies of the lists, the linked list erase, the node churn and the small list constructions.
+	/// </summary>
+	/// <param name="config">The sizes and distributions to run.</param>
+	/// <returns>The measurements.</returns>
+	inline List<Result> Run(const Config& config)
+	{
+		List<Result> results;
+
+		auto insertionSort = [](auto& list) { list.InsertionSort(); };
+		auto cocktailShakerSort = [](auto& list) { list.CocktailShakerSort(); };
+		auto quickSort = [](auto& list) { list.QuickSort(); };
+		auto heapSort = [](auto& list) { list.HeapSort(); };
+		auto introSort = [](auto& list) { list.IntroSort(); };
+		auto parallelSort = [](auto& list) { list.ParallelSort(); };
+		auto radixSort = [](auto& list)
+		{
+			if constexpr (is_same_v<decay_t<decltype(list[0])>, int>)
+				list.RadixSort();
+			else
+				list.RadixSort([](const Counted<int>& counted) { return counted.value; });
+		};
+		auto stdSort = [](auto& list) { sort(&list[0], &list[0] + list.Size()); };
+		auto bubbleSort = [](auto& list) { list.BubbleSort(); };
+		auto mergeSort = [](auto& list) { list.MergeSort(); };
+		auto timSort = [](auto& list) { list.TimSort(); };
+		auto stdStableSort = [](auto& list) { stable_sort(&list[0], &list[0] + list.Size()); };
+
+		RunSort<List<int>, List<Counted<int>>>("List::InsertionSort", QUADRATIC, insertionSort, config, results);
+		RunSort<List<int>, List<Counted<int>>>("List::CocktailShakerSort", QUADRATIC, cocktailShakerSort, config, results);
+		RunSort<List<int>, List<Counted<int>>>("List::QuickSort", QUADRATIC_WORST_CASE, quickSort, config, results);
+		RunSort<List<int>, List<Counted<int>>>("List::HeapSort", N_LOG_N, heapSort, config, results);
+		RunSort<List<int>, List<Counted<int>>>("List::IntroSort", N_LOG_N, introSort, config, results);
+		RunSort<List<int>, List<Counted<int>>>("List::ParallelSort", N_LOG_N, parallelSort, config, results);
+
+		//ParallelSort on a fixed number of threads, to show how it scales (counts above the number of cores only add overhead)
+		for (unsigned int threads : { 1u, 2u, 4u, 8u, 16u })
+		{
+			string name = "List::ParallelSort(" + to_string(threads) + (threads == 1 ? " thread)" : " threads)");
+			auto parallelSortOn = [threads](auto& list) { list.ParallelSort(threads); };
+			RunSort<List<int>, List<Counted<int>>>(name.c_str(), N_LOG_N, parallelSortOn, config, results);
+		}
+		RunSort<List<int>, List<Counted<int>>>("List::RadixSort", N_LOG_N, radixSort, config, results);
+		RunSort<List<int>, List<Counted<int>>>("List::TimSort", N_LOG_N, timSort, config, results);
+		RunSort<List<int>, List<Counted<int>>>("std::sort", N_LOG_N, stdSort, config, results);
+		RunSort<List<int>, List<Counted<int>>>("std::stable_sort", N_LOG_N, stdStableSort, config, results);
+
+		//Large values, where SortBy() sorts compact keys and moves each record once instead of moving them on every pass
+		auto sortByKey = [](auto& list)
+		{
+			list.SortBy([](const auto& record)
+			{
+				if constexpr (is_same_v<decay_t<decltype(record.key)>, int>)
+					return record.key;
+				else
+					return record.key.value;
+			});
+		};
+		RunSort<List<LargeRecord<int>>, List<LargeRecord<Counted<int>>>>("List::SortBy(256-byte)", N_LOG_N, sortByKey, config, results);
+		RunSort<List<LargeRecord<int>>, List<LargeRecord<Counted<int>>>>("List::TimSort(256-byte)", N_LOG_N, timSort, config, results);
+		RunSort<List<LargeRecord<int>>, List<LargeRecord<Counted<int>>>>("std::stable_sort(256-byte)", N_LOG_N, stdStableSort, config, results);
+		RunSort<LinkedList<int>, LinkedList<Counted<int>>>("LinkedList::BubbleSort", QUADRATIC, bubbleSort, config, results);
+		RunSort<LinkedList<int>, LinkedList<Counted<int>>>("LinkedList::MergeSort", N_LOG_N, mergeSort, config, results);
+		RunSort<UnrolledLinkedList<int>, UnrolledLinkedList<Counted<int>>>("UnrolledLinkedList::MergeSort", N_LOG_N, mergeSort, config, results);
+
+		//Re-sorting after small changes, where the adaptive sorts should be close to O(n)
+		RunFrames("List::InsertionSort", insertionSort, config, results);
+		RunFrames("List::IntroSort", introSort, config, results);
+		RunFrames("List::TimSort", timSort, config, results);
+		RunFrames("std::sort", stdSort, config, results);
+		RunFrames("std::stable_sort", stdStableSort, config, results);
+
+		auto keepSorted = [](const auto& sorted, const auto&) { return sorted; };
+		auto markSorted = [](const auto& sorted, const auto&)
+		{
+			auto list = sorted;
+			list.CheckSorted();
+			return list;
+		};
+		auto toLinkedList = [](const auto& sorted, const auto&)
+		{
+			LinkedList<decay_t<decltype(sorted[0])>> linkedList;
+			for (size_t i = 0; i < sorted.Size(); ++i)
+				linkedList.PushBack(sorted[i]);
+			return linkedList;
+		};
+		auto toUnrolledLinkedList = [](const auto& sorted, const auto&)
+		{
+			UnrolledLinkedList<decay_t<decltype(sorted[0])>> unrolledLinkedList;
+			for (size_t i = 0; i < sorted.Size(); ++i)
+				unrolledLinkedList.PushBack(sorted[i]);
+			return unrolledLinkedList;
+		};
+		auto toTree = [](const auto&, const auto& shuffled)
+		{
+			//Inserted in random order, otherwise the tree would be a linked list
+			BinaryTree<decay_t<decltype(shuffled[0])>> tree;
+			for (size_t i = 0; i < shuffled.Size(); ++i)
+				tree.Insert(shuffled[i]);
+			return tree;
+		};
+		auto toIndex = [](const auto& sorted, const auto&) { return SearchIndex(sorted); };
+
+		RunSearch("List::BinarySearch", false, keepSorted, [](const auto& list, const auto& value) { return list.BinarySearch(value); }, config, results);
+		RunSearch("List::FibonacciSearch", false, keepSorted, [](const auto& list, const auto& value) { return list.FibonacciSearch(value); }, config, results);
+		RunSearch("List::JumpSearch", false, keepSorted, [](const auto& list, const auto& value) { return list.JumpSearch(value); }, config, results);
+		RunSearch("List::LinearSearch", true, keepSorted, [](const auto& list, const auto& value) { return list.LinearSearch(value); }, config, results);
+		RunSearch("List::Find", false, markSorted, [](const auto& list, const auto& value) { return list.Find(value); }, config, results);
+		RunSearch("std::lower_bound", false, keepSorted,
+			[](const auto& list, const auto& value) { return (long long)(lower_bound(&list[0], &list[0] + list.Size(), value) - &list[0]); }, config, results);
+		RunSearch("LinkedList::LinearSearch", true, toLinkedList,
+			[](const auto& linkedList, const auto& value) { return linkedList.LinearSearch(value) != linkedList.End() ? 1 : 0; }, config, results);
+		RunSearch("UnrolledLinkedList::LinearSearch", true, toUnrolledLinkedList,
+			[](const auto& unrolledLinkedList, const auto& value) { return unrolledLinkedList.LinearSearch(value) != unrolledLinkedList.End() ? 1 : 0; }, config, results);
+		RunSearch("BinaryTree::Find", false, toTree, [](const auto& tree, const auto& value) { return tree.Find(value) != nullptr ? 1 : 0; }, config, results);
+		RunSearch("SearchIndex::Find", false, toIndex, [](const auto& index, const auto& value) { return index.Find(value); }, config, results);
+
+		//Find() against each search it can pick, around the sizes it switches at
+		auto find = [](const auto& list, const auto& value) { return list.Find(value); };
+		auto linearSearch = [](const auto& list, const auto& value) { return list.LinearSearch(value); };
+		auto binarySearch = [](const auto& list, const auto& value) { return list.BinarySearch(value); };
+		auto interpolationSearch = [](const auto& list, const auto& value) { return list.InterpolationSearch(value); };
+		for (int skewed = 0; skewed < 2; ++skewed)
+		{
+			RunSearchCrossover<int>("List<int>::Find", false, skewed != 0, find, config, results);
+			RunSearchCrossover<int>("List<int>::LinearSearch", true, skewed != 0, linearSearch, config, results);
+			RunSearchCrossover<int>("List<int>::BinarySearch", false, skewed != 0, binarySearch, config, results);
+			RunSearchCrossover<int>("List<int>::InterpolationSearch", false, skewed != 0, interpolationSearch, config, results);
+		}
+		RunSearchCrossover<SearchKey>("List<SearchKey>::Find", false, false, find, config, results);
+		RunSearchCrossover<SearchKey>("List<SearchKey>::LinearSearch", true, false, linearSearch, config, results);
+		RunSearchCrossover<SearchKey>("List<SearchKey>::BinarySearch", false, false, binarySearch, config, results);
+
+		RunKernels<int>("int", config, results);
+		RunKernels<float>("float", config, results);
+
+		RunPushAmortised("List::Push(1.5x)", 1.5f, config, results);
+		RunPushAmortised("List::Push(2x)", 2.0f, config, results);
+		RunReallocations(config, results);
+		RunPushLatency<List<int>, List<Counted<int>>>("List::Push", config, results);
+		RunPushLatency<SegmentedList<int>, SegmentedList<Counted<int>>>("SegmentedList::Push", config, results);
+
+		RunEraseEveryOther<LinkedList<int>, LinkedList<Counted<int>>>("LinkedList::Erase", config, results);
+		RunEraseEveryOther<UnrolledLinkedList<int>, UnrolledLinkedList<Counted<int>>>("UnrolledLinkedList::Erase", config, results);
+
+		RunNodeChurn<LinkedList<int>, LinkedList<Counted<int>>>("LinkedList<NewAllocator>", config, results);
+		RunNodeChurn<LinkedList<int, PoolAllocator<>>, LinkedList<Counted<int>, PoolAllocator<>>>("LinkedList<PoolAllocator>", config, results);
+		RunNodeChurn<LinkedList<int, ThreadPoolAllocator<>>, LinkedList<Counted<int>, ThreadPoolAllocator<>>>("LinkedList<ThreadPoolAllocator>", config, results);
+		RunNodeChurn<Dequeue<int>, Dequeue<Counted<int>>>("Dequeue<NewAllocator>", config, results);
+		RunNodeChurn<Dequeue<int, PoolAllocator<>>, Dequeue<Counted<int>, PoolAllocator<>>>("Dequeue<PoolAllocator>", config, results);
+		RunNodeChurn<Dequeue<int, ThreadPoolAllocator<>>, Dequeue<Counted<int>, ThreadPoolAllocator<>>>("Dequeue<ThreadPoolAllocator>", config, results);
+		RunNodeChurn<UnrolledLinkedList<int>, UnrolledLinkedList<Counted<int>>>("UnrolledLinkedList<NewAllocator>", config, results);
+		RunConstructions<List<int>>("List", results);
+		RunConstructions<SmallList<int, 16>>("SmallList<16>", results);
+
+		return results;
+	}
+
+	/// <summary>
+	/// Throw if a self-check fails.
+	/// </summary>
+	/// <param name="condition">What should be true.</param>
+	/// <param name="what">A description of the check, for the error message.</param>
+	inline void Expect(bool condition, const string& what)
+	{
+		if (!condition)
+			throw logic_error("Check failed: " + what);
+	}
+
+	/// <summary>
+	/// Check that growing, moving and emplacing into a list of strings never copies a string.
+	/// The strings are too long for the small string optimisation, so a copy would also show up as an allocation.
+	/// </summary>
+	inline void CheckListMoves()
+	{
+		const size_t count = 100000;
+		const string prefix = "a string long enough to be allocated on the heap ";
+		List<Counted<string>> list;
+		size_t reallocations = 0;
+		unsigned long long pushAllocations = 0;
+		copies = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			Counted<string> value(prefix + to_string(i));
+			size_t capacity = list.Capacity();
+			unsigned long long before = allocations;
+			if (i % 2 == 0)
+				list.Push(move(value));
+			else
+				list.EmplaceBack(move(value));
+			pushAllocations += allocations - before;
+			reallocations += list.Capacity() != capacity ? 1 : 0;
+		}
+
+		Expect(copies == 0, "growing a list of strings made no copies");
+		Expect(!CountingAllocations() || pushAllocations == reallocations, "growing a list of strings only allocated the list's storage");
+		for (size_t i = 0; i < count; ++i)
+			Expect(list[i].value == prefix + to_string(i), "the strings survived the list growing");
+
+		List<Counted<string>> moved(move(list));
+		List<Counted<string>> assigned;
+		assigned = move(moved);
+		assigned.Emplace(0, Counted<string>(prefix));
+		Expect(copies == 0, "moving a list of strings and emplacing into it made no copies");
+		Expect(assigned.Size() == count + 1 && assigned[1].value == prefix + "0", "the moved list kept its strings");
+
+		List<Counted<string>> copy = assigned;
+		Expect(copies == count + 1, "copying a list copies each string once");
+
+		copy.Discard(copy.Capacity());
+		Expect(copy.Size() == 0, "discarding the whole capacity empties the list");
+		copy.Clear();
+		Expect(copy.Size() == 0, "clearing empties the list");
+	}
+
+	/// <summary>
+	/// Check random Splice(), SplitAt() and Merge() calls on linked lists against std::list.
+	/// Allocators that can't share nodes between lists move the values across one at a time, so also check that nothing was copied,
+	/// including by the move constructor and move assignment.
+	/// </summary>
+	template <typename Allocator>
+	void CheckLinkedListSplicing()
+	{
+		typedef LinkedList<Counted<int>, Allocator> Linked;
+		auto at = [](const Linked& list, size_t index) { return index >= list.Size() ? list.End() : list.Begin().Next((unsigned int)index); };
+		auto same = [](const Linked& list, const std::list<int>& expected)
+		{
+			if (list.Size() != expected.size())
+				return false;
+			auto value = expected.begin();
+			for (auto i = list.Begin(); i != list.End(); ++i, ++value)
+				if ((*i).value != *value)
+					return false;
+			return true;
+		};
+
+		mt19937_64 rng(2019);
+		copies = 0;
+		for (int round = 0; round < 2000; ++round)
+		{
+			Linked a;
+			Linked b;
+			std::list<int> expectedA;
+			std::list<int> expectedB;
+			size_t sizeA = rng() % 20;
+			size_t sizeB = rng() % 20;
+			for (size_t i = 0; i < sizeA; ++i)
+			{
+				int value = (int)(rng() % 50);
+				a.PushBack(Counted<int>(value));
+				expectedA.push_back(value);
+			}
+			for (size_t i = 0; i < sizeB; ++i)
+			{
+				int value = (int)(rng() % 50);
+				b.PushBack(Counted<int>(value));
+				expectedB.push_back(value);
+			}
+
+			int operation = (int)(rng() % 5);
+			size_t position = rng() % (sizeA + 1);
+			if (operation == 0)
+			{
+				a.Splice(at(a, position), b);
+				expectedA.splice(next(expectedA.begin(), position), expectedB);
+			}
+			else if (operation == 1)
+			{
+				size_t first = rng() % (sizeB + 1);
+				size_t last = first + rng() % (sizeB - first + 1);
+				a.Splice(at(a, position), b, at(b, first), at(b, last));
+				expectedA.splice(next(expectedA.begin(), position), expectedB, next(expectedB.begin(), first), next(expectedB.begin(), last));
+			}
+			else if (operation == 2)
+			{
+				//Move a range within the list, to a position outside it (std::list doesn't allow the range's own first value)
+				size_t first = rng() % (sizeA + 1);
+				size_t last = first + rng() % (sizeA - first + 1);
+				position = rng() % (sizeA - (last - first) + 1);
+				if (position >= first)
+					position += last - first;
+				a.Splice(at(a, position), a, at(a, first), at(a, last));
+				expectedA.splice(next(expectedA.begin(), position), expectedA, next(expectedA.begin(), first), next(expectedA.begin(), last));
+			}
+			else if (operation == 3)
+			{
+				b = a.SplitAt(at(a, position));
+				expectedB.clear();
+				expectedB.splice(expectedB.end(), expectedA, next(expectedA.begin(), position), expectedA.end());
+			}
+			else
+			{
+				a.MergeSort();
+				b.MergeSort();
+				a.Merge(b);
+				expectedA.sort();
+				expectedB.sort();
+				expectedA.merge(expectedB);
+			}
+
+			string what = " (operation " + to_string(operation) + ", round " + to_string(round) + ")";
+			Expect(same(a, expectedA), "the linked list matches std::list" + what);
+			Expect(same(b, expectedB), "the other linked list matches std::list" + what);
+
+			Linked moved(move(a));
+			Linked assigned;
+			assigned = move(moved);
+			Expect(same(assigned, expectedA) && a.Size() == 0 && moved.Size() == 0, "moving a linked list takes its values" + what);
+		}
+		Expect(copies == 0, "splicing, splitting, merging and moving linked lists copied no values");
+	}
+
+	/// <summary>
+	/// Check random Splice(), SplitAt(), Merge() and BubbleSort() calls on unrolled linked lists against std::list.
+	/// The nodes hold 4 elements and the lists are built with inserts as well as pushes, so positions fall inside partly full nodes.
+	/// Also check that nothing was copied, including when the allocator can't share nodes and the values are moved across.
+	/// </summary>
+	template <typename Allocator>
+	void CheckUnrolledLinkedListSplicing()
+	{
+		typedef UnrolledLinkedList<Counted<int>, 4, Allocator> Unrolled;
+		auto at = [](const Unrolled& list, size_t index) { return list.Begin().Next((unsigned int)index); };
+		auto same = [](const Unrolled& list, const std::list<int>& expected)
+		{
+			if (list.Size() != expected.size())
+				return false;
+			auto value = expected.begin();
+			for (auto i = list.Begin(); i != list.End(); ++i, ++value)
+				if ((*i).value != *value)
+					return false;
+			return true;
+		};
+		auto fill = [&](Unrolled& list, std::list<int>& expected, size_t count, mt19937_64& rng)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				int value = (int)(rng() % 50);
+				size_t position = rng() % (list.Size() + 1);
+				list.Insert(at(list, position), Counted<int>(value));
+				expected.insert(next(expected.begin(), position), value);
+			}
+		};
+
+		mt19937_64 rng(2019);
+		copies = 0;
+		for (int round = 0; round < 2000; ++round)
+		{
+			Unrolled a;
+			Unrolled b;
+			std::list<int> expectedA;
+			std::list<int> expectedB;
+			fill(a, expectedA, rng() % 30, rng);
+			fill(b, expectedB, rng() % 30, rng);
+
+			int operation = (int)(rng() % 4);
+			size_t position = rng() % (a.Size() + 1);
+			if (operation == 0)
+			{
+				a.Splice(at(a, position), b);
+				expectedA.splice(next(expectedA.begin(), position), expectedB);
+			}
+			else if (operation == 1)
+			{
+				b = a.SplitAt(at(a, position));
+				expectedB.clear();
+				expectedB.splice(expectedB.end(), expectedA, next(expectedA.begin(), position), expectedA.end());
+			}
+			else if (operation == 2)
+			{
+				a.MergeSort();
+				b.BubbleSort();
+				a.Merge(b);
+				expectedA.sort();
+				expectedB.sort();
+				expectedA.merge(expectedB);
+			}
+			else
+			{
+				a.BubbleSort();
+				expectedA.sort();
+			}
+
+			string what = " (operation " + to_string(operation) + ", round " + to_string(round) + ")";
+			Expect(same(a, expectedA), "the unrolled linked list matches std::list" + what);
+			Expect(same(b, expectedB), "the other unrolled linked list matches std::list" + what);
+
+			//The lists must still be usable after their nodes were cut and joined
+			a.PushFront(Counted<int>(-1));
+			expectedA.push_front(-1);
+			size_t middle = a.Size() / 2;
+			a.Insert(at(a, middle), Counted<int>(-2));
+			expectedA.insert(next(expectedA.begin(), middle), -2);
+			for (size_t i = 0; i < expectedA.size() / 3; ++i)
+			{
+				a.Erase(a.Begin());
+				expectedA.pop_front();
+			}
+			Unrolled moved(move(a));
+			Expect(same(moved, expectedA) && a.Size() == 0, "the unrolled linked list still works after splicing" + what);
+		}
+		Expect(copies == 0, "splicing, splitting, merging and sorting unrolled linked lists copied no values");
+	}
+
+	/// <summary>
+	/// Check random RemoveIf(), RemoveAll() and Insert() calls on a list of strings against std::vector.
+	/// The strings are long enough to live on the heap, so a slot that is assigned before it is constructed, or used after it is destroyed,
+	/// shows up under a sanitizer. Inserts cover growing the list, sliding the back up within the capacity, and inserting part of the list into itself.
+	/// </summary>
+	inline void CheckRemoveAndInsert()
+	{
+		const string prefix = "a string long enough to be allocated on the heap ";
+		auto same = [](const List<string>& list, const vector<string>& expected)
+		{
+			if (list.Size() != expected.size())
+				return false;
+			for (size_t i = 0; i < expected.size(); ++i)
+				if (list[i] != expected[i])
+					return false;
+			return true;
+		};
+
+		mt19937_64 rng(2019);
+		for (int round = 0; round < 3000; ++round)
+		{
+			List<string> list;
+			vector<string> expected;
+			size_t size = rng() % 40;
+			for (size_t i = 0; i < size; ++i)
+			{
+				string value = prefix + to_string(rng() % 8);
+				list.Push(value);
+				expected.push_back(value);
+			}
+
+			//Reserving first makes the insert slide the back up in place rather than grow
+			size_t count = rng() % 20;
+			bool reserve = rng() % 2 == 0;
+			if (reserve)
+				list.Reserve(size + count);
+			size_t index = rng() % (size + 1);
+			string what = " (round " + to_string(round) + ")";
+
+			int operation = (int)(rng() % 4);
+			if (operation == 0)
+			{
+				List<string> values(count);
+				vector<string> inserted;
+				for (size_t i = 0; i < count; ++i)
+				{
+					values.Push(prefix + "new " + to_string(i));
+					inserted.push_back(values[i]);
+				}
+				list.Insert(index, values);
+				expected.insert(expected.begin() + index, inserted.begin(), inserted.end());
+				Expect(same(list, expected), string("inserting strings ") + (reserve ? "without growing" : "and growing") + " matches std::vector" + what);
+			}
+			else if (operation == 1)
+			{
+				//Insert a range of the list into itself
+				size_t from = rng() % (size + 1);
+				count = count < size - from ? count : size - from;
+				vector<string> range(expected.begin() + from, expected.begin() + from + count);
+				list.Insert(index, size > 0 ? &list[0] + from : nullptr, count);
+				expected.insert(expected.begin() + index, range.begin(), range.end());
+				Expect(same(list, expected), string("inserting part of a list of strings into itself ") + (reserve ? "without growing" : "and growing") + " matches std::vector" + what);
+			}
+			else if (operation == 2)
+			{
+				char digit = (char)('0' + rng() % 8);
+				auto pred = [digit](const string& value) { return value.back() == digit || value.back() == digit + 1; };
+				size_t removed = list.RemoveIf(pred);
+				size_t before = expected.size();
+				expected.erase(remove_if(expected.begin(), expected.end(), pred), expected.end());
+				Expect(removed == before - expected.size() && same(list, expected), "RemoveIf on strings matches std::vector" + what);
+			}
+			else if (size > 0)
+			{
+				//Remove a value that is in the list, passing a reference to it
+				const string& value = list[rng() % size];
+				string target = value;
+				size_t removed = list.RemoveAll(value);
+				size_t before = expected.size();
+				expected.erase(remove(expected.begin(), expected.end(), target), expected.end());
+				Expect(removed == before - expected.size() && same(list, expected), "RemoveAll of a value in the list matches std::vector" + what);
+			}
+
+			//The list must still be usable afterwards
+			list.Push(prefix);
+			expected.push_back(prefix);
+			list.Insert(0, prefix + "front");
+			expected.insert(expected.begin(), prefix + "front");
+			Expect(same(list, expected), "the list of strings still works after removing and inserting" + what);
+		}
+	}
+
+	/// <summary>
+	/// Check that MinMax() gives the same result on any number of threads when the list has NaNs in it,
+	/// including NaNs at the start of a thread's block and blocks that are all NaNs.
+	/// </summary>
+	template <typename T>
+	void CheckMinMaxNaNs()
+	{
+		const size_t size = 1 << 20;	//Large enough for the list to give each of 4 threads a block
+		const T nan = numeric_limits<T>::quiet_NaN();
+		mt19937_64 rng(2019);
+		uniform_real_distribution<T> any(-1000, 1000);
+		uniform_int_distribution<size_t> index(0, size - 1);
+		auto same = [](T a, T b) { return a == b || (a != a && b != b); };
+
+		for (int round = 0; round < 8; ++round)
+		{
+			List<T> list(size);
+			for (size_t i = 0; i < size; ++i)
+				list.Push(any(rng));
+			for (size_t i = 0; i < 1000; ++i)
+				list[index(rng)] = nan;
+			//Start some blocks with a NaN, and make one block all NaNs
+			for (size_t block = 0; block < 4; ++block)
+				if ((round >> (block % 2)) & 1)
+					list[block * size / 4] = nan;
+			if (round >= 4)
+				for (size_t i = (round - 4) * size / 4; i < (round - 3) * size / 4; ++i)
+					list[i] = nan;
+
+			T smallest = nan;
+			T largest = nan;
+			for (size_t i = 0; i < size; ++i)
+				if (list[i] == list[i])
+				{
+					if (smallest != smallest || list[i] < smallest)
+						smallest = list[i];
+					if (largest != largest || largest < list[i])
+						largest = list[i];
+				}
+
+			for (unsigned int threads = 1; threads <= 4; ++threads)
+			{
+				pair<T, T> result = list.MinMax(threads);
+				Expect(same(result.first, smallest) && same(result.second, largest),
+					"MinMax on " + to_string(threads) + " threads skips the NaNs");
+			}
+		}
+
+		List<T> nans(size);
+		for (size_t i = 0; i < size; ++i)
+			nans.Push(nan);
+		for (unsigned int threads = 1; threads <= 4; ++threads)
+			Expect(nans.MinMax(threads).first != nans.MinMax(threads).first, "MinMax of only NaNs is a NaN");
+	}
+
+	/// <summary>
+	/// A record for checking the external sort: a random key and the record's position in the unsorted file.
+	/// </summary>
+	struct SortRecord
+	{
+		uint64_t key;
+		uint64_t position;
+
+		friend bool operator< (const SortRecord& a, const SortRecord& b) { return a.key < b.key; }
+	};
+
+	/// <summary>
+	/// Write a file of random records, sort it in place with an external sort, then check that it is sorted,
+	/// that it holds the same records, and that no run files were left behind.
+	/// The files are written to a new directory that is deleted afterwards.
+	/// </summary>
+	/// <param name="bytes">The size of the file to sort, which should be larger than the memory budget.</param>
+	/// <param name="memoryBudget">The memory budget of the sort, in bytes.</param>
+	/// <param name="tempDirectory">Where to write the files, the system's temporary directory if empty.</param>
+	/// <returns>The seconds taken by the sort.</returns>
+	inline double VerifyExternalSort(size_t bytes, size_t memoryBudget, const string& tempDirectory)
+	{
+		const size_t BLOCK = 1 << 16;	//The records generated and checked at a time
+		size_t count = bytes / sizeof(SortRecord);
+		filesystem::path directory = filesystem::path(tempDirectory.empty() ? filesystem::temp_directory_path() : filesystem::path(tempDirectory))
+			/ ("ExternalSortCheck-" + to_string(random_device()()));
+		filesystem::create_directories(directory);
+		string path = (directory / "records.bin").string();
+
+		try
+		{
+			//The checksum pairs each key with its position, so a key that lost its record would be noticed
+			mt19937_64 rng(2019);
+			uint64_t checksum = 0;
+			unique_ptr<SortRecord[]> block(new SortRecord[BLOCK]);
+			{
+				ofstream file(path, ios::binary);
+				for (size_t written = 0; written < count;)
+				{
+					size_t blockSize = count - written < BLOCK ? count - written : BLOCK;
+					for (size_t i = 0; i < blockSize; ++i)
+					{
+						block[i] = { rng(), written + i };
+						checksum += block[i].key ^ (block[i].position * 0x9E3779B97F4A7C15ull);
+					}
+					file.write(reinterpret_cast<const char*>(block.get()), (streamsize)(blockSize * sizeof(SortRecord)));
+					written += blockSize;
+				}
+				if (!file)
+					throw runtime_error("Could not write " + path + ".");
+			}
+
+			auto start = chrono::steady_clock::now();
+			ExternalSort<SortRecord> sorter(memoryBudget, directory.string());
+			sorter.Sort(path, path);
+			auto end = chrono::steady_clock::now();
+
+			Expect(filesystem::file_size(path) == count * sizeof(SortRecord), "the external sort kept every record");
+			Expect(distance(filesystem::directory_iterator(directory), filesystem::directory_iterator()) == 1, "the external sort removed its run files");
+
+			ifstream file(path, ios::binary);
+			uint64_t sortedChecksum = 0;
+			uint64_t previous = 0;
+			for (size_t read = 0; read < count;)
+			{
+				size_t blockSize = count - read < BLOCK ? count - read : BLOCK;
+				file.read(reinterpret_cast<char*>(block.get()), (streamsize)(blockSize * sizeof(SortRecord)));
+				Expect((bool)file, "the sorted file can be read back");
+				for (size_t i = 0; i < blockSize; ++i)
+				{
+					Expect(block[i].key >= previous, "the external sort put the records in order");
+					previous = block[i].key;
+					sortedChecksum += block[i].key ^ (block[i].position * 0x9E3779B97F4A7C15ull);
+				}
+				read += blockSize;
+			}
+			Expect(sortedChecksum == checksum, "the external sort kept the same records");
+
+			filesystem::remove_all(directory);
+			return chrono::duration<double>(end - start).count();
+		}
+		catch (...)
+		{
+			error_code error;
+			filesystem::remove_all(directory, error);
+			throw;
+		}
+	}
+
+	/// <summary>
+	/// Check the external sort on a file 50 times its memory budget, which takes several merge passes.
+	/// </summary>
+	inline void CheckExternalSort()
+	{
+		size_t memoryBudget = 5 * ExternalSort<SortRecord>::MIN_BLOCK_BYTES;
+		VerifyExternalSort(memoryBudget * 50, memoryBudget, "");
+	}
+
+	/// <summary>
+	/// Check that a list reads back what it wrote, and that a header claiming more values than the stream holds
+	/// fails with the format's runtime_error instead of trying to allocate them all.
+	/// </summary>
+	inline void CheckListDeserialize()
+	{
+		List<int> values;
+		for (int i = 0; i < (1 << 20) + 5; ++i)
+			values.Push(i * 7);
+		List<string> strings;
+		for (int i = 0; i < 1000; ++i)
+			strings.Push(to_string(i));
+
+		stringstream stream;
+		{
+			BinaryWriter writer(stream);
+			values.Serialize(writer);
+			strings.Serialize(writer);
+			writer.WriteHeader<int>(SERIAL_LIST, (size_t)1 << 60);
+			writer.WriteValue(1);
+			writer.Flush();
+		}
+
+		BinaryReader reader(stream);
+		List<int> readValues;
+		readValues.Deserialize(reader);
+		List<string> readStrings;
+		readStrings.Deserialize(reader);
+		bool same = readValues.Size() == values.Size() && readStrings.Size() == strings.Size();
+		for (size_t i = 0; same && i < values.Size(); ++i)
+			same = readValues[i] == values[i];
+		for (size_t i = 0; same && i < strings.Size(); ++i)
+			same = readStrings[i] == strings[i];
+		Expect(same, "a list reads back the values it wrote");
+
+		bool threw = false;
+		try
+		{
+			List<int> corrupt;
+			corrupt.Deserialize(reader);
+		}
+		catch (const runtime_error&)
+		{
+			threw = true;
+		}
+		Expect(threw, "a list header with too many values throws runtime_error");
+
+		//A segmented list reads the same format
+		stream.clear();
+		stream.seekg(0);
+		BinaryReader segmentedReader(stream);
+		SegmentedList<int> segmented;
+		segmented.Deserialize(segmentedReader);
+		same = segmented.Size() == values.Size();
+		for (size_t i = 0; same && i < values.Size(); ++i)
+			same = segmented[i] == values[i];
+		Expect(same, "a segmented list reads back a list's values");
+		SegmentedList<string> segmentedStrings;
+		segmentedStrings.Deserialize(segmentedReader);
+		threw = false;
+		try
+		{
+			SegmentedList<int> corrupt;
+			corrupt.Deserialize(segmentedReader);
+		}
+		catch (const runtime_error&)
+		{
+			threw = true;
+		}
+		Expect(threw, "a segmented list header with too many values throws runtime_error");
+	}
+
+	/// <summary>
+	/// Write a container to a stream and read it back into a new container.
+	/// </summary>
+	/// <param name="container">The container to write.</param>
+	/// <returns>The container read back.</returns>
+	template <typename Container>
+	Container RoundTrip(const Container& container)
+	{
+		stringstream stream;
+		BinaryWriter writer(stream);
+		container.Serialize(writer);
+		writer.Flush();
+
+		BinaryReader reader(stream);
+		Container read;
+		read.Deserialize(reader);
+		return read;
+	}
+
+	/// <summary>
+	/// Write a container to a string, to compare containers that can't be walked from outside.
+	/// </summary>
+	/// <param name="container">The container to write.</param>
+	/// <returns>The bytes of the stream.</returns>
+	template <typename Container>
+	string SerializedBytes(const Container& container)
+	{
+		stringstream stream;
+		BinaryWriter writer(stream);
+		container.Serialize(writer);
+		writer.Flush();
+		return stream.str();
+	}
+
+	/// <summary>
+	/// Check that a container reading a header that claims more values than the stream holds throws runtime_error,
+	/// rather than running out of memory first.
+	/// </summary>
+	/// <param name="container">The container to read into, which should be left usable.</param>
+	/// <param name="kind">The kind of container the header is for.</param>
+	/// <param name="count">The count to put in the header.</param>
+	/// <returns>True if the read threw runtime_error.</returns>
+	template <typename Container>
+	bool ThrowsOnCorruptHeader(Container& container, SERIAL_CONTAINER kind, size_t count)
+	{
+		stringstream stream;
+		BinaryWriter writer(stream);
+		writer.WriteHeader<int>(kind, count);
+		writer.WriteValue(1);
+		writer.Flush();
+
+		BinaryReader reader(stream);
+		try
+		{
+			container.Deserialize(reader);
+		}
+		catch (const runtime_error&)
+		{
+			return true;
+		}
+		return false;
+	}
+
+	/// <summary>
+	/// Check that the node containers, the stack, the heap and the tree read back what they wrote,
+	/// and throw runtime_error for a header with a corrupt count instead of allocating for it.
+	/// </summary>
+	inline void CheckContainerDeserialize()
+	{
+		//Linked list and dequeue
+		LinkedList<int> linkedList;
+		LinkedList<string> linkedStrings;
+		Dequeue<int> dequeue;
+		for (int i = 0; i < 10000; ++i)
+		{
+			linkedList.PushBack(i * 3);
+			linkedStrings.PushBack(to_string(i));
+			dequeue.PushBack(i * 5);
+		}
+		LinkedList<int> readLinkedList = RoundTrip(linkedList);
+		LinkedList<string> readLinkedStrings = RoundTrip(linkedStrings);
+		bool same = readLinkedList.Size() == linkedList.Size() && readLinkedStrings.Size() == linkedStrings.Size();
+		for (auto a = linkedList.Begin(), b = readLinkedList.Begin(); same && a != linkedList.End(); ++a, ++b)
+			same = *a == *b;
+		for (auto a = linkedStrings.Begin(), b = readLinkedStrings.Begin(); same && a != linkedStrings.End(); ++a, ++b)
+			same = *a == *b;
+		Expect(same, "a linked list reads back the values it wrote");
+
+		Dequeue<int> readDequeue = RoundTrip(dequeue);
+		Dequeue<int> expected = dequeue;
+		same = readDequeue.Size() == expected.Size();
+		while (same && !expected.Empty())
+		{
+			same = readDequeue.Top() == expected.Top();
+			readDequeue.PopFront();
+			expected.PopFront();
+		}
+		Expect(same, "a dequeue reads back the values it wrote");
+
+		LinkedList<int> corruptLinkedList;
+		Expect(ThrowsOnCorruptHeader(corruptLinkedList, SERIAL_LINKED_LIST, (size_t)1 << 40), "a linked list header with too many values throws runtime_error");
+		Dequeue<int> corruptDequeue;
+		Expect(ThrowsOnCorruptHeader(corruptDequeue, SERIAL_DEQUEUE, (size_t)1 << 40), "a dequeue header with too many values throws runtime_error");
+
+		//Stack, with more values than one piece of the read so the array has to grow
+		Stack<int> stack;
+		Stack<string> strings;
+		for (int i = 0; i < 300000; ++i)
+		{
+			stack.Push(i);
+			if (i < 1000)
+				strings.Push(to_string(i));
+		}
+		Stack<int> readStack;
+		Stack<string> readStrings;
+		Expect(SerializedBytes(readStack = RoundTrip(stack)) == SerializedBytes(stack) && readStack.Size() == stack.Size(),
+			"a stack reads back the values it wrote");
+		Expect(SerializedBytes(readStrings = RoundTrip(strings)) == SerializedBytes(strings) && readStrings.Size() == strings.Size(),
+			"a stack of strings reads back the values it wrote");
+
+		//A failed read leaves the stack as it was, so it can still be pushed to
+		Stack<int> corruptStack;
+		corruptStack.Push(7);
+		Expect(ThrowsOnCorruptHeader(corruptStack, SERIAL_STACK, 4000000000u), "a stack header with too many values throws runtime_error");
+		corruptStack.Push(8);
+		Expect(corruptStack.Size() == 2 && corruptStack.Top() == 8, "a stack is unchanged and usable after a failed read");
+
+		//Heap, compared by writing it again as its array can't be read from outside
+		Heap<int> heap;
+		for (int i = 0; i < 100; ++i)
+			heap.Push((i * 37) % 101);
+		Heap<int> readHeap = RoundTrip(heap);
+		Expect(readHeap.Size() == heap.Size() && SerializedBytes(readHeap) == SerializedBytes(heap), "a heap reads back its array in the same order");
+		ostringstream printedHeap;
+		printedHeap << readHeap;
+		Expect(readHeap.ToString() == printedHeap.str() && printedHeap.str().find("\n100\n") != string::npos, "a heap formats every level the same way as the << operator");
+		Expect(Heap<int>().ToString().empty(), "an empty heap formats as nothing");
+		Heap<int> corruptHeap;
+		Expect(ThrowsOnCorruptHeader(corruptHeap, SERIAL_HEAP, 50), "a heap header with more values than the stream holds throws runtime_error");
+
+		//Tree, both a balanced-ish one and one that is a single long branch
+		mt19937_64 rng(2019);
+		for (int shape = 0; shape < 2; ++shape)
+		{
+			BinaryTree<int> tree;
+			for (int i = 0; i < 5000; ++i)
+				tree.Insert(shape == 0 ? (int)(rng() % 1000000) : i);
+			BinaryTree<int> readTree = RoundTrip(tree);
+
+			//Walk both trees together, so any difference in shape shows up as well as in the values
+			List<pair<BinaryTreeNode<int>*, BinaryTreeNode<int>*>> pending;
+			pending.Push(make_pair(tree.GetRoot(), readTree.GetRoot()));
+			same = readTree.Size() == tree.Size();
+			while (same && pending.Size() > 0)
+			{
+				auto nodes = pending[pending.Size() - 1];
+				pending.Pop();
+				if (nodes.first == nullptr || nodes.second == nullptr)
+				{
+					same = nodes.first == nodes.second;
+					continue;
+				}
+				same = nodes.first->data == nodes.second->data;
+				pending.Push(make_pair(nodes.first->left, nodes.second->left));
+				pending.Push(make_pair(nodes.first->right, nodes.second->right));
+			}
+			Expect(same, "a tree reads back with the same values and shape");
+		}
+		BinaryTree<int> corruptTree;
+		Expect(ThrowsOnCorruptHeader(corruptTree, SERIAL_BINARY_TREE, 4000000000u), "a tree header with too many nodes throws runtime_error");
+		corruptTree.Insert(1);
+		Expect(corruptTree.Size() == 1, "a tree is usable after a failed read");
+	}
+
+	/// <summary>
+	/// Check that ParallelSort on any number of threads leaves the same values as std::sort, for numbers and for strings,
+	/// whose moves leave empty strings behind if a thread reads a value another thread has already moved.
+	/// A comparator that only looks at part of each value must still order the values by that part.
+	/// </summary>
+	inline void CheckParallelSort()
+	{
+		mt19937_64 rng(2019);
+		const size_t size = 300000;		//Large enough for the list to give 16 threads a block each
+		for (unsigned int threads : { 1u, 2u, 3u, 5u, 8u, 16u })
+		{
+			List<int> numbers(size);
+			List<string> strings(size);
+			List<int> expectedNumbers(size);
+			List<string> expectedStrings(size);
+			for (size_t i = 0; i < size; ++i)
+			{
+				int value = (int)(rng() % 100000);
+				numbers.Push(value);
+				strings.Push(to_string(value));
+				expectedNumbers.Push(value);
+				expectedStrings.Push(strings[i]);
+			}
+			numbers.ParallelSort(threads);
+			strings.ParallelSort(threads);
+			sort(&expectedNumbers[0], &expectedNumbers[0] + size);
+			sort(&expectedStrings[0], &expectedStrings[0] + size);
+			bool same = true;
+			for (size_t i = 0; same && i < size; ++i)
+				same = numbers[i] == expectedNumbers[i] && strings[i] == expectedStrings[i];
+			Expect(same, "ParallelSort on " + to_string(threads) + " threads leaves the same values as std::sort");
+
+			List<pair<int, int>> records(size);
+			for (size_t i = 0; i < size; ++i)
+				records.Push(make_pair((int)(rng() % 100), (int)i));
+			records.ParallelSort(threads, [](const pair<int, int>& a, const pair<int, int>& b) { return a.first < b.first; });
+			bool sorted = true;
+			for (size_t i = 1; sorted && i < size; ++i)
+				sorted = !(records[i].first < records[i - 1].first);
+			Expect(sorted, "ParallelSort on " + to_string(threads) + " threads orders by a comparator on part of the value");
+		}
+	}
+
+	/// <summary>
+	/// Check that SortBy() and ArgSort() with a key keep values with equal keys in order, by comparing them with std::stable_sort.
+	/// Each value is tagged with its original position so a reordering of equal keys shows up.
+	/// </summary>
+	/// <param name="keys">The keys to sort by, with plenty of repeats.</param>
+	/// <param name="what">Describes the keys in the failure messages.</param>
+	template <typename Key>
+	void CheckStableSortBy(const List<Key>& keys, const string& what)
+	{
+		List<pair<Key, size_t>> tagged(keys.Size());
+		for (size_t i = 0; i < keys.Size(); ++i)
+			tagged.Push(make_pair(keys[i], i));
+		auto key = [](const pair<Key, size_t>& value) { return value.first; };
+
+		List<pair<Key, size_t>> expected = tagged;
+		if (expected.Size() > 0)
+			stable_sort(&expected[0], &expected[0] + expected.Size(),
+				[](const pair<Key, size_t>& a, const pair<Key, size_t>& b) { return a.first < b.first; });
+
+		List<pair<Key, size_t>> sorted = tagged;
+		sorted.SortBy(key);
+		List<size_t> order = tagged.ArgSort(key);
+		Expect(sorted.Size() == expected.Size() && order.Size() == expected.Size(), "SortBy and ArgSort keep every value of " + what);
+		for (size_t i = 0; i < expected.Size(); ++i)
+		{
+			Expect(sorted[i].second == expected[i].second, "SortBy keeps equal " + what + " in order, like std::stable_sort");
+			Expect(order[i] == expected[i].second, "ArgSort keeps equal " + what + " in order, like std::stable_sort");
+		}
+	}
+
+	/// <summary>
+	/// Check that ArgSort() without a key keeps equal values in order, by comparing it with std::stable_sort of the indices.
+	/// </summary>
+	/// <param name="values">The values to sort, with plenty of repeats.</param>
+	/// <param name="what">Describes the values in the failure messages.</param>
+	template <typename T>
+	void CheckStableArgSort(const List<T>& values, const string& what)
+	{
+		List<size_t> expected(values.Size());
+		for (size_t i = 0; i < values.Size(); ++i)
+			expected.Push(i);
+		if (expected.Size() > 0)
+			stable_sort(&expected[0], &expected[0] + expected.Size(), [&values](size_t a, size_t b) { return values[a] < values[b]; });
+
+		List<size_t> order = values.ArgSort();
+		Expect(order.Size() == expected.Size(), "ArgSort gives an index for every one of the " + what);
+		for (size_t i = 0; i < expected.Size(); ++i)
+			Expect(order[i] == expected[i], "ArgSort keeps equal " + what + " in order, like std::stable_sort");
+	}
+
+	/// <summary>
+	/// Check the stability of SortBy() and ArgSort() on both of their paths: numeric keys (the radix sort) and other keys
+	/// (the introsort that breaks ties by position), on sizes around the introsort's insertion sort threshold and larger.
+	/// </summary>
+	inline void CheckSortByStability()
+	{
+		mt19937_64 rng(2019);
+		size_t sizes[] = { 0, 1, 2, 16, 17, 100, 1000, 50000 };
+		for (size_t size : sizes)
+		{
+			List<int> ints(size);
+			List<double> doubles(size);
+			List<string> strings(size);
+			for (size_t i = 0; i < size; ++i)
+			{
+				int value = (int)(rng() % 64) - 32;
+				ints.Push(value);
+				//Zeros of both signs are equal keys, so they must keep their order too
+				doubles.Push(value == 0 && rng() % 2 == 0 ? -0.0 : value / 4.0);
+				strings.Push("key " + to_string(value));
+			}
+
+			CheckStableSortBy(ints, "int keys");
+			CheckStableSortBy(doubles, "double keys");
+			CheckStableSortBy(strings, "string keys");
+			CheckStableArgSort(ints, "ints");
+			CheckStableArgSort(doubles, "doubles");
+			CheckStableArgSort(strings, "strings");
+		}
+	}
+
+	/// <summary>
+	/// Check every search of a sorted list against a scan, on every size up to 300 and then some larger ones,
+	/// for values that are in the list, between its values and outside them.
+	/// </summary>
+	inline void CheckSearches()
+	{
+		mt19937_64 rng(2019);
+		List<size_t> sizes;
+		for (size_t size = 0; size <= 300; ++size)
+			sizes.Push(size);
+		sizes.Push(4096);
+		sizes.Push(100003);
+
+		for (size_t s = 0; s < sizes.Size(); ++s)
+		{
+			//Even numbers with some repeats, so odd numbers are never found
+			List<int> list(sizes[s]);
+			int value = 0;
+			for (size_t i = 0; i < sizes[s]; ++i)
+			{
+				list.Push(value);
+				value += rng() % 4 == 0 ? 0 : 2;
+			}
+			list.CheckSorted();
+
+			size_t queries = sizes[s] < 1000 ? (size_t)value + 4 : 10000;
+			for (size_t q = 0; q < queries; ++q)
+			{
+				int query = sizes[s] < 1000 ? (int)q - 2 : (int)(rng() % (value + 4)) - 2;
+				bool present = list.Size() > 0 && query >= 0 && query % 2 == 0 && query <= list[list.Size() - 1];
+				ptrdiff_t results[] = { list.Find(query), list.LinearSearch(query), list.BinarySearch(query), list.InterpolationSearch(query),
+					list.FibonacciSearch(query), list.JumpSearch(query) };
+				for (ptrdiff_t index : results)
+					Expect(present ? index >= 0 && (size_t)index < list.Size() && list[(size_t)index] == query : index == -1,
+						"every search of a list of " + to_string(sizes[s]) + " finds " + to_string(query) + " if it is there");
+			}
+		}
+
+		//Values that grow exponentially, which Find() bisects rather than interpolating
+		List<long long> skewed(5000);
+		for (size_t i = 0; i < 5000; ++i)
+			skewed.Push(2 * ((long long)i + (long long)exp(30.0 * i / 5000)));
+		skewed.CheckSorted();
+		for (size_t i = 0; i < skewed.Size(); ++i)
+		{
+			Expect(skewed.Find(skewed[i]) == (ptrdiff_t)i, "Find() finds every value of a skewed list");
+			Expect(skewed.Find(skewed[i] + 1) == -1, "Find() doesn't find values missing from a skewed list");
+		}
+	}
+
+	/// <summary>
+	/// Check that the interpolation search finds values whose keys convert to the same double, and handles infinities.
+	/// </summary>
+	inline void CheckInterpolationSearch()
+	{
+		//Doubles near 2^62 are 1024 apart, so these all convert to the same few doubles
+		const long long base = 1LL << 62;
+		List<long long> keys;
+		for (long long i = 0; i < 5000; i += 2)
+			keys.Push(base + i);
+		bool found = true;
+		for (long long i = 0; i < 5000; ++i)
+		{
+			auto index = keys.InterpolationSearch(base + i);
+			found = found && (i % 2 == 0 ? index != -1 && keys[(size_t)index] == base + i : index == -1);
+		}
+		Expect(found, "the interpolation search finds 64-bit keys that round to the same double");
+
+		const double infinity = numeric_limits<double>::infinity();
+		List<double> numbers;
+		numbers.Push(-infinity);
+		for (int i = 0; i < 100; ++i)
+			numbers.Push(i);
+		numbers.Push(infinity);
+		found = numbers.InterpolationSearch(-infinity) == 0 && numbers.InterpolationSearch(infinity) == 101 && numbers.InterpolationSearch(0.5) == -1;
+		for (int i = 0; i < 100; ++i)
+			found = found && numbers.InterpolationSearch(i) == i + 1;
+		Expect(found, "the interpolation search handles infinities");
+	}
+
+	/// <summary>
+	/// Check that a mapped list keeps its values when it is closed and opened again, and that a read only list
+	/// can be sorted and searched in place without changing the file, but can't grow.
+	/// Also checks that a file of elements of a different size is rejected.
+	/// </summary>
+	inline void CheckMappedList()
+	{
+		const size_t count = 100000;	//Past the initial capacity, so the file grows and is remapped
+		filesystem::path directory = filesystem::temp_directory_path() / ("MappedListCheck-" + to_string(random_device()()));
+		filesystem::create_directories(directory);
+		string path = (directory / "values.list").string();
+
+		try
+		{
+			mt19937_64 rng(2019);
+			List<int> values(count);
+			for (size_t i = 0; i < count; ++i)
+				values.Push((int)(rng() >> 33));
+			{
+				MappedList<int> list(path);
+				for (size_t i = 0; i < count; ++i)
+					list.Push(values[i]);
+			}
+
+			{
+				MappedList<int> list(path, READ_ONLY);
+				Expect(list.Size() == count, "a reopened mapped list has every value");
+				bool same = true;
+				for (size_t i = 0; i < count; ++i)
+					same = same && list[i] == values[i];
+				Expect(same, "a reopened mapped list has the same values");
+
+				list.IntroSort();
+				bool sorted = true;
+				for (size_t i = 1; i < count; ++i)
+					sorted = sorted && !(list[i] < list[i - 1]);
+				Expect(sorted, "a read only mapped list sorts in place");
+				bool found = true;
+				for (size_t i = 0; i < count; i += 97)
+				{
+					auto index = list.BinarySearch(values[i]);
+					found = found && index != -1 && list[(size_t)index] == values[i];
+				}
+				Expect(found, "a read only mapped list can be searched after sorting");
+
+				//Values can be added in memory up to the mapped capacity, but growing the file throws
+				while (list.Size() < list.Capacity())
+					list.Push(0);
+				bool threw = false;
+				try
+				{
+					list.Push(0);
+				}
+				catch (const logic_error&)
+				{
+					threw = true;
+				}
+				Expect(threw && list.Size() == list.Capacity(), "a read only mapped list can't grow");
+			}
+
+			{
+				MappedList<int> list(path, READ_ONLY);
+				Expect(list.Size() == count && list[0] == values[0] && list[count - 1] == values[count - 1], "changing a read only mapped list didn't change the file");
+			}
+
+			bool rejected = false;
+			try
+			{
+				MappedList<long long> list(path, READ_ONLY);
+			}
+			catch (const runtime_error&)
+			{
+				rejected = true;
+			}
+			Expect(rejected, "a mapped list file of a different element size is rejected");
+
+			filesystem::remove_all(directory);
+		}
+		catch (...)
+		{
+			error_code error;
+			filesystem::remove_all(directory, error);
+			throw;
+		}
+	}
+
+	/// <summary>
+	/// Run every self-check, writing a line for each one that passes.
+	/// </summary>
+	/// <param name="os">The ostream to write to.</param>
+	inline void RunChecks(ostream& os)
+	{
+		static const struct
+		{
+			const char* name;
+			void (*check)();
+		} checks[] =
+		{
+			{ "List moves", CheckListMoves },
+			{ "LinkedList splicing (NewAllocator)", CheckLinkedListSplicing<NewAllocator> },
+			{ "LinkedList splicing (PoolAllocator)", CheckLinkedListSplicing<PoolAllocator<>> },
+			{ "LinkedList splicing (ThreadPoolAllocator)", CheckLinkedListSplicing<ThreadPoolAllocator<>> },
+			{ "UnrolledLinkedList splicing (NewAllocator)", CheckUnrolledLinkedListSplicing<NewAllocator> },
+			{ "UnrolledLinkedList splicing (PoolAllocator)", CheckUnrolledLinkedListSplicing<PoolAllocator<>> },
+			{ "List MinMax with NaNs (float)", CheckMinMaxNaNs<float> },
+			{ "List MinMax with NaNs (double)", CheckMinMaxNaNs<double> },
+			{ "ExternalSort", CheckExternalSort },
+			{ "MappedList", CheckMappedList },
+			{ "List Deserialize", CheckListDeserialize },
+			{ "Container Deserialize", CheckContainerDeserialize },
+			{ "List InterpolationSearch", CheckInterpolationSearch },
+			{ "List searches", CheckSearches },
+			{ "List ParallelSort", CheckParallelSort },
+			{ "List SortBy and ArgSort stability", CheckSortByStability },
+			{ "List RemoveIf, RemoveAll and Insert", CheckRemoveAndInsert },
+		};
+
+		for (const auto& check : checks)
+		{
+			check.check();
+			os << "ok " << check.name << '\n';
+		}
+	}
+
+	/// <summary>
+	/// Write the measurements as CSV, with a header row.
+	/// </summary>
+	/// <param name="os">The ostream to write to.</param>
+	/// <param name="results">The measurements.</param>
+	inline void WriteCsv(ostream& os, const List<Result>& results)
+	{
+		os << "algorithm,input,size,ns_per_element,comparisons_per_element,moves_per_element,cache_misses,allocations\n";
+		for (size_t i = 0; i < results.Size(); ++i)
+		{
+			const Result& result = results[i];
+			os << result.algorithm << ',' << result.input << ',' << result.size << ',' << result.nsPerElement << ','
+				<< result.comparisons << ',' << result.moves << ',';
+			if (result.cacheMisses >= 0)
+				os << result.cacheMisses;
+			os << ',';
+			if (result.allocations >= 0)
+				os << result.allocations;
+			os << '\n';
+		}
+	}
+
+	/// <summary>
+	/// Write the measurements as a JSON array of objects.
+	/// </summary>
+	/// <param name="os">The ostream to write to.</param>
+	/// <param name="results">The measurements.</param>
+	inline void WriteJson(ostream& os, const List<Result>& results)
+	{
+		os << "[\n";
+		for (size_t i = 0; i < results.Size(); ++i)
+		{
+			const Result& result = results[i];
+			os << "  {\"algorithm\": \"" << result.algorithm << "\", \"input\": \"" << result.input << "\", \"size\": " << result.size
+				<< ", \"ns_per_element\": " << result.nsPerElement << ", \"comparisons_per_element\": " << result.comparisons
+				<< ", \"moves_per_element\": " << result.moves << ", \"cache_misses\": ";
+			if (result.cacheMisses >= 0)
+				os << result.cacheMisses;
+			else
+				os << "null";
+			os << ", \"allocations\": ";
+			if (result.allocations >= 0)
+				os << result.allocations;
+			else
+				os << "null";
+			os << (i + 1 < results.Size() ? "},\n" : "}\n");
+		}
+		os << "]\n";
+	}
+
+	/// <summary>
+	/// Split a comma separated list of values.
+	/// </summary>
+	/// <param name="text">The values, e.g. "1000,10000".</param>
+	/// <returns>The values.</returns>
+	inline List<string> Split(const string& text)
+	{
+		List<string> parts;
+		size_t start = 0;
+		while (start <= text.size())
+		{
+			size_t end = text.find(',', start);
+			if (end == string::npos)
+				end = text.size();
+			if (end > start)
+				parts.Push(text.substr(start, end - start));
+			start = end + 1;
+		}
+		return parts;
+	}
+
+	/// <summary>
+	/// Read the benchmark settings from the command line.
+	/// Options are --sizes=1000,10000 --push-sizes=1000,10000000 --search-sizes=16,65536 --kernel-sizes=1024,32768 --distributions=random,sorted --repetitions=5 --quadratic-limit=20000
+	/// --queries=100000 --frames=60 --seed=2019 --format=csv|json. Anything not given keeps its default.
+	/// --check runs the self-checks instead. --external-sort=4096 sorts and verifies a file of that many megabytes instead,
+	/// with --memory-budget=256 (in megabytes) and --temp-directory=path.
+	/// </summary>
+	/// <param name="argc">The number of arguments.</param>
+	/// <param name="argv">The arguments, starting with the program name.</param>
+	/// <returns>The settings.</returns>
+	inline Config ParseArguments(int argc, char** argv)
+	{
+		Config config;
+		for (int i = 1; i < argc; ++i)
+		{
+			string argument = argv[i];
+			size_t equals = argument.find('=');
+			string name = argument.substr(0, equals);
+			string value = equals == string::npos ? "" : argument.substr(equals + 1);
+
+			if (name == "--sizes")
+			{
+				List<string> sizes = Split(value);
+				config.sizes.Clear();
+				for (size_t j = 0; j < sizes.Size(); ++j)
+					config.sizes.Push((size_t)stoull(sizes[j]));
+			}
+			else if (name == "--push-sizes")
+			{
+				List<string> sizes = Split(value);
+				config.pushSizes.Clear();
+				for (size_t j = 0; j < sizes.Size(); ++j)
+					config.pushSizes.Push((size_t)stoull(sizes[j]));
+			}
+			else if (name == "--search-sizes")
+			{
+				List<string> sizes = Split(value);
+				config.searchSizes.Clear();
+				for (size_t j = 0; j < sizes.Size(); ++j)
+					config.searchSizes.Push((size_t)stoull(sizes[j]));
+			}
+			else if (name == "--kernel-sizes")
+			{
+				List<string> sizes = Split(value);
+				config.kernelSizes.Clear();
+				for (size_t j = 0; j < sizes.Size(); ++j)
+					config.kernelSizes.Push((size_t)stoull(sizes[j]));
+			}
+			else if (name == "--distributions")
+			{
+				List<string> names = Split(value);
+				config.distributions.Clear();
+				for (size_t j = 0; j < names.Size(); ++j)
+				{
+					int d = 0;
+					while (d < DISTRIBUTION_COUNT && names[j] != DISTRIBUTION_NAMES[d])
+						++d;
+					if (d == DISTRIBUTION_COUNT)
+						throw invalid_argument("Unknown distribution: " + names[j]);
+					config.distributions.Push((DISTRIBUTION)d);
+				}
+			}
+			else if (name == "--repetitions")
+				config.repetitions = (unsigned int)stoul(value);
+			else if (name == "--quadratic-limit")
+				config.quadraticLimit = (size_t)stoull(value);
+			else if (name == "--queries")
+				config.queries = (size_t)stoull(value);
+			else if (name == "--frames")
+				config.frames = (unsigned int)stoul(value);
+			else if (name == "--seed")
+				config.seed = stoull(value);
+			else if (name == "--format" && (value == "csv" || value == "json"))
+				config.format = value == "csv" ? CSV : JSON;
+			else if (name == "--check")
+				config.check = true;
+			else if (name == "--external-sort")
+				config.externalSortBytes = (size_t)stoull(value) * 1024 * 1024;
+			else if (name == "--memory-budget")
+				config.memoryBudget = (size_t)stoull(value) * 1024 * 1024;
+			else if (name == "--temp-directory")
+				config.tempDirectory = value;
+			else
+				throw invalid_argument("Unknown option: " + argument);
+		}
+		return config;
+	}
+
+	/// <summary>
+	/// Run the benchmarks (or the self-checks) with the settings from the command line and write the results to cout.
+	/// </summary>
+	/// <param name="argc">The number of arguments.</param>
+	/// <param name="argv">The arguments, starting with the program name.</param>
+	/// <returns>The exit code for main.</returns>
+	inline int Main(int argc, char** argv)
+	{
+		try
+		{
+			Config config = ParseArguments(argc, argv);
+			if (config.check)
+			{
+				RunChecks(cout);
+				return 0;
+			}
+			if (config.externalSortBytes > 0)
+			{
+				double seconds = VerifyExternalSort(config.externalSortBytes, config.memoryBudget, config.tempDirectory);
+				cout << "ExternalSort sorted " << config.externalSortBytes / (1024 * 1024) << " MB with a " << config.memoryBudget / (1024 * 1024)
+					<< " MB memory budget in " << seconds << " s\n";
+				return 0;
+			}
+
+			List<Result> results = Run(config);
+			if (config.format == JSON)
+				WriteJson(cout, results);
+			else
+				WriteCsv(cout, results);
+		}
+		catch (const exception& e)
+		{
+			cerr << e.what() << '\n';
+			return 1;
+		}
+		return 0;
+	}
+}
\ No newline at end of file
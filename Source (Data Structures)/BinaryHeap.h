@@ -1,6 +1,12 @@
 #pragma once
 #include <iostream>
 #include <math.h>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include "SimdKernels.h"
+#include "Serialization.h"
+#include "TextBuffer.h"
 
 using namespace std;
 
@@ -11,6 +17,7 @@ private:
 	T* data;							//Array
 	unsigned int size;					//Size of the heap
 	const unsigned int MAX_SIZE = 100;	//Maximum size of the heap
+	static const int NO_CHILD = -1;		//Child index returned when there isn't one
 
 	/// <summary>
 	/// Swap two values in the heap.
@@ -19,37 +26,90 @@ private:
 	/// <param name="b">Value B.</param>
 	void Swap(T* a, T* b)
 	{
-		T temp = *a;
-		*a = *b;
-		*b = temp;
+		T temp = move(*a);
+		*a = move(*b);
+		*b = move(temp);
 	}
 
 	/// <summary>
-	/// Recursively prints the tree to std::cout
+	/// Allocate uninitialised memory for the heap's array.
+	/// Values are only constructed when they are pushed.
+	/// </summary>
+	/// <returns>A pointer to the start of the memory.</returns>
+	T* Allocate() const
+	{
+		return static_cast<T*>(::operator new(sizeof(T) * MAX_SIZE));
+	}
+
+	/// <summary>
+	/// Destroy a number of constructed values.
+	/// </summary>
+	/// <param name="first">The first value to destroy.</param>
+	/// <param name="count">The number of values to destroy.</param>
+	static void Destroy(T* first, unsigned int count)
+	{
+		if constexpr (!is_trivially_destructible_v<T>)
+			for (unsigned int i = 0; i < count; ++i)
+				first[i].~T();
+	}
+
+	/// <summary>
+	/// Copy the values of another heap into new memory.
+	/// Uses memcpy if the type allows it.
+	/// </summary>
+	/// <param name="other">The heap to copy.</param>
+	/// <returns>The new array containing the copied values.</returns>
+	T* CopyData(const Heap& other) const
+	{
+		T* newData = Allocate();
+		if constexpr (is_trivially_copyable_v<T>)
+		{
+			if (other.size > 0)
+				memcpy(newData, other.data, sizeof(T) * other.size);
+		}
+		else
+		{
+			unsigned int i = 0;
+			try
+			{
+				for (; i < other.size; ++i)
+					new (newData + i) T(other.data[i]);
+			}
+			catch (...)
+			{
+				//Undo the copies that were made before the exception
+				Destroy(newData, i);
+				::operator delete(newData);
+				throw;
+			}
+		}
+		return newData;
+	}
+
+	/// <summary>
+	/// Recursively appends the tree to a text buffer.
 	/// https://www.geeksforgeeks.org/print-binary-tree-2-dimensions/
 	/// </summary>
+	/// <param name="buffer">The buffer to append to.</param>
 	/// <param name="index">The index to process. (Initially 0)</param>
 	/// <param name="space">The space between the levels. (Initially 0)</param>
-	void PrintTree(unsigned int index, int space) const
+	void FormatTree(TextBuffer& buffer, int index, int space) const
 	{
 		//Exit if the index isn't valid
-		if (index == -1)
+		if (index == NO_CHILD)
 			return;
 
 		//Increase the distance between the levels
 		space += 5;
 
 		//Process the right child
-		PrintTree(GetSecondChild(index), space);
+		FormatTree(buffer, GetSecondChild(index), space);
 
-		//Print the current node
-		cout << endl;
-		for (int i = 5; i < space; ++i)
-			cout << " ";
-		cout << data[index] << endl;
+		//Append the current node
+		buffer.Append('\n').Repeat(' ', space - 5).Append(data[index]).Append('\n');
 
 		//Process the left child
-		PrintTree(GetFirstChild(index), space);
+		FormatTree(buffer, GetFirstChild(index), space);
 	}
 
 public:
@@ -59,8 +119,7 @@ public:
 	Heap()
 	{
 		size = 0;
-		data = new T[MAX_SIZE];
-		memset(data, 0, sizeof(T) * MAX_SIZE);
+		data = Allocate();
 	}
 
 	/// <summary>
@@ -70,8 +129,7 @@ public:
 	Heap(const T& rootValue)
 	{
 		size = 0;
-		data = new T[MAX_SIZE];
-		memset(data, 0, sizeof(T) * MAX_SIZE);
+		data = Allocate();
 		Push(rootValue);
 	}
 
@@ -81,9 +139,21 @@ public:
 	/// <param name="copy"></param>
 	Heap(const Heap& copy)
 	{
+		data = CopyData(copy);
 		size = copy.size;
-		data = new T[MAX_SIZE];
-		memcpy(data, copy.data, sizeof(T) * MAX_SIZE);
+	}
+
+	/// <summary>
+	/// Move constructor.
+	/// Takes the values from the other heap, leaving it empty.
+	/// </summary>
+	/// <param name="other">The heap to move from.</param>
+	Heap(Heap&& other) noexcept
+	{
+		size = other.size;
+		data = other.data;
+		other.data = nullptr;
+		other.size = 0;
 	}
 
 	/// <summary>
@@ -91,7 +161,8 @@ public:
 	/// </summary>
 	~Heap()
 	{
-		delete[] data;
+		Destroy(data, size);
+		::operator delete(data);
 	}
 
 	/// <summary>
@@ -99,13 +170,36 @@ public:
 	/// </summary>
 	/// <param name="value">The value to add to the heap.</param>
 	void Push(const T& value)
+	{
+		Emplace(value);
+	}
+
+	/// <summary>
+	/// Adds a new value to the heap by moving it.
+	/// </summary>
+	/// <param name="value">The value to move into the heap.</param>
+	void Push(T&& value)
+	{
+		Emplace(move(value));
+	}
+
+	/// <summary>
+	/// Constructs a new value in place at the end of the heap and moves it up to its correct position.
+	/// </summary>
+	/// <param name="args">The arguments to pass to the value's constructor.</param>
+	template <typename... Args>
+	void Emplace(Args&&... args)
 	{
 		//Exit if the heap cannot fit another value
 		if (size == MAX_SIZE)
 			return;
 
+		//A moved-from heap gets its array back when it is used again
+		if (data == nullptr)
+			data = Allocate();
+
 		//Add the value to the end of the heap
-		data[size] = value;
+		new (data + size) T(forward<Args>(args)...);
 		++size;
 
 		//Exit if this was the first value added
@@ -139,7 +233,10 @@ public:
 	void Pop()
 	{
 		if (size > 0)
+		{
 			--size;
+			Destroy(data + size, 1);
+		}
 	}
 
 	/// <summary>
@@ -192,6 +289,7 @@ public:
 	/// </summary>
 	void Clear()
 	{
+		Destroy(data, size);
 		size = 0;
 	}
 
@@ -216,7 +314,7 @@ public:
 	{
 		unsigned int result = (2 * index) + 1;
 		if (result >= size)
-			return -1;
+			return NO_CHILD;
 		return result;
 	}
 
@@ -229,7 +327,7 @@ public:
 	{
 		unsigned int result = (2 * index) + 2;
 		if (result >= size)
-			return -1;
+			return NO_CHILD;
 		return result;
 	}
 
@@ -250,7 +348,7 @@ public:
 	/// <returns>True if a first child exists for the given index.</returns>
 	bool HasFirstChild(unsigned int index) const
 	{
-		return GetFirstChild(index) != -1;
+		return GetFirstChild(index) != NO_CHILD;
 	}
 
 	/// <summary>
@@ -260,20 +358,19 @@ public:
 	/// <returns>True if a second child exists for the given index.</returns>
 	bool HasSecondChild(unsigned int index) const
 	{
-		return GetSecondChild(index) != -1;
+		return GetSecondChild(index) != NO_CHILD;
 	}
 
 	/// <summary>
 	/// Find the index of a value in the heap.
+	/// Uses a vectorised scan for numbers.
 	/// </summary>
 	/// <param name="value">The value to search for.</param>
 	/// <returns>The index of the value, -1 otherwise.</returns>
 	int Find(const T& value) const
 	{
-		for (unsigned int i = 0; i < size; ++i)
-			if (data[i] == value)
-				return i;
-		return -1;
+		size_t index = SimdKernels::FindFirst(data, size, value);
+		return index == size ? -1 : (int)index;
 	}
 
 	/// <summary>
@@ -314,13 +411,56 @@ public:
 	/// <returns>The value.</returns>
 	T& operator[] (unsigned int index) const
 	{
-		if (index >= 0 && index < size)
+		if (index < size)
 			return data[index];
 		
 		//Throw an exception if the index is not within the range of the heap
 		throw out_of_range("Index out of range.");
 	}
 
+	/// <summary>
+	/// Write the heap to a binary writer in its array order.
+	/// Trivially copyable values are written straight from the array in one piece.
+	/// </summary>
+	/// <param name="writer">The writer to write to.</param>
+	void Serialize(BinaryWriter& writer) const
+	{
+		writer.WriteHeader<T>(SERIAL_HEAP, size);
+		writer.WriteValues(data, size);
+	}
+
+	/// <summary>
+	/// Replace the values of the heap with a heap read from a binary reader.
+	/// The array is already in heap order, so the values are put back in place rather than pushed.
+	/// </summary>
+	/// <param name="reader">The reader to read from.</param>
+	void Deserialize(BinaryReader& reader)
+	{
+		size_t count = reader.ReadHeader<T>(SERIAL_HEAP);
+		if (count > MAX_SIZE)
+			throw length_error("The stream holds more values than the heap can fit.");
+
+		Clear();
+		if (data == nullptr)
+			data = Allocate();
+
+		if constexpr (is_trivially_copyable_v<T>)
+		{
+			reader.ReadValues(data, count);
+			size = (unsigned int)count;
+		}
+		else
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				T value;
+				reader.ReadValue(value);
+				new (data + size) T(move(value));
+				++size;
+			}
+		}
+	}
+
 	/// <summary>
 	/// Assignment operator overload.
 	/// </summary>
@@ -328,10 +468,35 @@ public:
 	/// <returns>This heap with the values of the other heap.</returns>
 	Heap& operator= (const Heap& other)
 	{
-		delete[] data;
+		if (this == &other)
+			return *this;
+
+		//Copy the data first so this heap is left untouched if a copy throws
+		T* newData = CopyData(other);
+		Destroy(data, size);
+		::operator delete(data);
+		data = newData;
+		size = other.size;
+		return *this;
+	}
+
+	/// <summary>
+	/// Move assignment operator overload.
+	/// Takes the values from the other heap, leaving it empty.
+	/// </summary>
+	/// <param name="other">The other heap to move from.</param>
+	/// <returns>This heap with the values of the other heap.</returns>
+	Heap& operator= (Heap&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		Destroy(data, size);
+		::operator delete(data);
+		data = other.data;
 		size = other.size;
-		data = new T[MAX_SIZE];
-		memcpy(data, other.data, sizeof(T) * MAX_SIZE);
+		other.data = nullptr;
+		other.size = 0;
 		return *this;
 	}
 
@@ -342,10 +507,10 @@ public:
 	/// <param name="os">The ostream the print the heap to.</param>
 	/// <param name="node">The current node to process. (Initially root)</param>
 	/// <param name="space">The space between the levels. (Initially 0)</param>
-	friend void PrintTreeF(ostream& os, const Heap<T>& heap, unsigned int index, int space)
+	friend void PrintTreeF(ostream& os, const Heap<T>& heap, int index, int space)
 	{
 		//Exit if the index isn't valid
-		if (index == -1)
+		if (index == NO_CHILD)
 			return;
 
 		//Increase the distance between the levels
@@ -378,20 +543,28 @@ public:
 		return os;
 	}
 
+	/// <summary>
+	/// Append the heap to a text buffer in the same format as the << operator.
+	/// </summary>
+	/// <param name="buffer">The buffer to append to.</param>
+	void Format(TextBuffer& buffer) const
+	{
+		FormatTree(buffer, GetRootIndex(), 0);
+	}
+
 	/// <summary>
 	/// Print details about the tree.
+	/// The tree is formatted in a buffer and written in one piece, without flushing std::cout.
 	/// </summary>
 	void PrintDetails() const
 	{
-		cout << "Size: " << size << endl;
+		TextBuffer& buffer = ScratchTextBuffer();
+		buffer.Append("Size: ").Append(size).Append('\n');
 		if (size > 0)
-		{
-			//Call a function to recursively print the heap to std::cout
-			PrintTree(GetRootIndex(), 0);
-		}
+			Format(buffer);
 		else
-			cout << "Empty" << endl;
-		cout << endl;
+			buffer.Append("Empty\n");
+		buffer.Append('\n').WriteTo(cout);
 	}
 
 	/// <summary>
@@ -402,8 +575,8 @@ public:
 	/// <returns>A string representation of the heap.</returns>
 	string ToString() const
 	{
-		ostringstream stream;
-		stream << *this;
-		return stream.str();
+		TextBuffer buffer;
+		Format(buffer);
+		return buffer.Str();
 	}
 };
\ No newline at end of file
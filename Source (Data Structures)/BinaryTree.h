@@ -6,6 +6,10 @@
 #pragma once
 #include <iostream>
 #include <queue>	//Change to custom implementation
+#include "DynamicList.h"
+#include "Serialization.h"
+#include "TextBuffer.h"
+#include "NodePool.h"
 
 using namespace std;
 
@@ -47,8 +51,9 @@ public:
 
 	/// <summary>
 	/// Deconstructor.
+	/// Defaulted so a node is trivially destructible when its data is, letting a pool release the nodes without visiting them.
 	/// </summary>
-	~BinaryTreeNode() {}
+	~BinaryTreeNode() = default;
 
 	/// <summary>
 	/// Get a copy of this node and its children.
@@ -69,14 +74,19 @@ enum DEPTH_FIRST_SEARCH_TYPE { SEARCH_PRE_ORDER, SEARCH_POST_ORDER, SEARCH_IN_OR
 
 /// <summary>
 /// The Binary Tree class has a root node and keeps track of the number of nodes.
+/// The nodes are allocated by the Allocator, e.g. PoolAllocator<> to take them from a pool instead of calling new for every node.
 /// </summary>
-template <typename T>
+template <typename T, typename Allocator = NewAllocator>
 class BinaryTree
 {
 private:
 	typedef void(*ProcessFnType)(BinaryTreeNode<T>* node);	//Function type definition for use in the search functions
 	BinaryTreeNode<T>* root;	//The root node of the tree
 	unsigned int size;			//The number of nodes in the tree
+	Allocator allocator;		//Allocates the nodes
+
+	static const unsigned char SHAPE_LEFT = 1;		//A node's shape bits when it has a left child
+	static const unsigned char SHAPE_RIGHT = 2;		//A node's shape bits when it has a right child
 
 public:
 	/// <summary>
@@ -94,9 +104,8 @@ public:
 	/// <param name="copy">The tree to copy.</param>
 	BinaryTree(const BinaryTree& copy)
 	{
+		root = CopyNodes(copy.root);
 		size = copy.size;
-		if (!Empty())
-			root = copy.root->Copy();
 	}
 
 	/// <summary>
@@ -116,7 +125,7 @@ public:
 	{
 		if (Empty())	//If the tree is empty then set up the root
 		{
-			root = new BinaryTreeNode<T>(data);
+			root = allocator.template New<BinaryTreeNode<T>>(data);
 			size = 1;
 		}
 		else
@@ -136,9 +145,9 @@ public:
 
 			//Attach a new node as a leaf to the parent
 			if (data < parent->data)
-				parent->left = new BinaryTreeNode<T>(data);
+				parent->left = allocator.template New<BinaryTreeNode<T>>(data);
 			else
-				parent->right = new BinaryTreeNode<T>(data);
+				parent->right = allocator.template New<BinaryTreeNode<T>>(data);
 			++size;
 		}
 	}
@@ -173,7 +182,7 @@ public:
 					minimumParent->left = minimumNode->right;
 				if (minimumParent->right == minimumNode)
 					minimumParent->right = minimumNode->right;
-				delete minimumNode;
+				allocator.Delete(minimumNode);
 			}
 			else	//If the current node has no right branch
 			{
@@ -184,7 +193,7 @@ public:
 					(*ppParent)->left = (*ppNode)->left;
 				else if ((*ppParent)->right == (*ppNode))
 					(*ppParent)->right = (*ppNode)->left;
-				delete (*ppNode);
+				allocator.Delete(*ppNode);
 			}
 			--size;	//Decrease the size
 		}
@@ -236,12 +245,16 @@ public:
 
 	/// <summary>
 	/// Empties the tree.
+	/// If the allocator can release every node at once and the nodes don't need destroying, this takes constant time.
 	/// </summary>
 	void Clear()
 	{
-		//Loop until the tree is empty
-		while (!Empty())
-			Remove(root->data);
+		if constexpr (Allocator::BULK_RELEASE && is_trivially_destructible_v<BinaryTreeNode<T>>)
+			allocator.Reset();
+		else
+			DeleteNodes(root);
+		root = nullptr;
+		size = 0;
 	}
 
 	/// <summary>
@@ -286,6 +299,124 @@ public:
 		}
 	}
 
+	/// <summary>
+	/// Write the tree to a binary writer without losing its shape.
+	/// The shape is written first, two bits a node in pre order for whether it has a left and a right child,
+	/// then the values in the same order.
+	/// </summary>
+	/// <param name="writer">The writer to write to.</param>
+	void Serialize(BinaryWriter& writer) const
+	{
+		writer.WriteHeader<T>(SERIAL_BINARY_TREE, size);
+		if (Empty())
+			return;
+
+		//Walk the tree in pre order with a stack rather than recursion, as an unbalanced tree can be as deep as it is large
+		List<BinaryTreeNode<T>*> pending;
+		unsigned char bits = 0;
+		unsigned int packed = 0;
+		pending.Push(root);
+		while (pending.Size() > 0)
+		{
+			BinaryTreeNode<T>* node = pending[pending.Size() - 1];
+			pending.Pop();
+			bits |= (unsigned char)(((node->left != nullptr ? SHAPE_LEFT : 0) | (node->right != nullptr ? SHAPE_RIGHT : 0)) << (2 * packed));
+			if (++packed == 4)
+			{
+				writer.WriteBytes(&bits, 1);
+				bits = 0;
+				packed = 0;
+			}
+			if (node->right != nullptr)
+				pending.Push(node->right);
+			if (node->left != nullptr)
+				pending.Push(node->left);
+		}
+		if (packed > 0)
+			writer.WriteBytes(&bits, 1);
+
+		pending.Push(root);
+		while (pending.Size() > 0)
+		{
+			BinaryTreeNode<T>* node = pending[pending.Size() - 1];
+			pending.Pop();
+			writer.WriteValue(node->data);
+			if (node->right != nullptr)
+				pending.Push(node->right);
+			if (node->left != nullptr)
+				pending.Push(node->left);
+		}
+	}
+
+	/// <summary>
+	/// Replace the tree with a tree read from a binary reader.
+	/// The nodes are linked back together from the shape, so nothing is re-inserted and the tree keeps its balance.
+	/// </summary>
+	/// <param name="reader">The reader to read from.</param>
+	void Deserialize(BinaryReader& reader)
+	{
+		size_t count = reader.ReadHeader<T>(SERIAL_BINARY_TREE);
+		if (count > numeric_limits<unsigned int>::max())
+			throw length_error("The stream holds more nodes than a tree can fit.");
+
+		Clear();
+		root = nullptr;
+		if (count == 0)
+			return;
+
+		//Read the shape in pieces, so a corrupt count runs out of stream before it can allocate more than the stream holds
+		const size_t shapeBytes = (count + 3) / 4;
+		List<unsigned char> shape;
+		unsigned char piece[4096];
+		while (shape.Size() < shapeBytes)
+		{
+			size_t pieceBytes = shapeBytes - shape.Size() < sizeof(piece) ? shapeBytes - shape.Size() : sizeof(piece);
+			reader.ReadBytes(piece, pieceBytes);
+			shape.Insert(shape.Size(), piece, pieceBytes);
+		}
+
+		//Each node goes in the slot left for it by the node before it in pre order:
+		//its left child if it has one, otherwise the right child of the nearest node still waiting for one
+		List<BinaryTreeNode<T>*> pending;
+		BinaryTreeNode<T>** slot = &root;
+		try
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (slot == nullptr)
+					throw runtime_error("The stream holds a tree with the wrong shape.");
+
+				T value;
+				reader.ReadValue(value);
+				BinaryTreeNode<T>* node = allocator.template New<BinaryTreeNode<T>>(value);
+				*slot = node;
+				++size;
+
+				unsigned char bits = (shape[i / 4] >> (2 * (i % 4))) & (SHAPE_LEFT | SHAPE_RIGHT);
+				if (bits & SHAPE_RIGHT)
+					pending.Push(node);
+				if (bits & SHAPE_LEFT)
+					slot = &node->left;
+				else if (pending.Size() > 0)
+				{
+					slot = &pending[pending.Size() - 1]->right;
+					pending.Pop();
+				}
+				else
+					slot = nullptr;
+			}
+			if (slot != nullptr)
+				throw runtime_error("The stream holds a tree with the wrong shape.");
+		}
+		catch (...)
+		{
+			DeleteNodes(root);
+			root = nullptr;
+			size = 0;
+			throw;
+		}
+	}
+
 	/// <summary>
 	/// Getter for the root of the tree.
 	/// </summary>
@@ -332,12 +463,14 @@ public:
 	/// </summary>
 	/// <param name="other">The tree to copy to this tree.</param>
 	/// <returns>This tree with the same data as the given tree.</returns>
-	BinaryTree<T>& operator= (const BinaryTree<T>& other)
+	BinaryTree& operator= (const BinaryTree& other)
 	{
-		Clear();
-		size = other.size;
-		if (!Empty())
-			root = other.root->Copy();
+		if (this != &other)
+		{
+			Clear();
+			root = CopyNodes(other.root);
+			size = other.size;
+		}
 		return *this;
 	}
 
@@ -348,7 +481,7 @@ public:
 	/// <param name="os">The ostream the print the tree to.</param>
 	/// <param name="node">The current node to process. (Initially root)</param>
 	/// <param name="space">The space between the levels. (Initially 0)</param>
-	friend void PrintTreeF(ostream& os, BinaryTreeNode<T>* node, int space)
+	static void PrintTreeF(ostream& os, BinaryTreeNode<T>* node, int space)
 	{
 		if (node == nullptr)
 			return;
@@ -376,27 +509,36 @@ public:
 	/// <param name="os">The ostream to print the tree to.</param>
 	/// <param name="tree">The tree to print.</param>
 	/// <returns>The ostream with the tree printed to it.</returns>
-	friend ostream& operator<< (ostream& os, const BinaryTree<T>& tree)
+	friend ostream& operator<< (ostream& os, const BinaryTree& tree)
 	{
 		//Call the other friend function to recursively print the tree
 		PrintTreeF(os, tree.GetRoot(), 0);
 		return os;
 	}
 
+	/// <summary>
+	/// Append the tree to a text buffer in the same format as the << operator.
+	/// </summary>
+	/// <param name="buffer">The buffer to append to.</param>
+	void Format(TextBuffer& buffer) const
+	{
+		if (!Empty())
+			FormatTree(buffer, root, 0);
+	}
+
 	/// <summary>
 	/// Print details about the tree.
+	/// The tree is formatted in a buffer and written in one piece, without flushing std::cout.
 	/// </summary>
 	void PrintDetails() const
 	{
-		cout << "Size: " << size << "   Edges: " << Edges() << endl;
+		TextBuffer& buffer = ScratchTextBuffer();
+		buffer.Append("Size: ").Append(size).Append("   Edges: ").Append(Edges()).Append('\n');
 		if (!Empty())
-		{
-			//Call a function to recursively print the tree to std::cout
-			PrintTree(root, 0);
-		}
+			Format(buffer);
 		else
-			cout << "Empty" << endl;
-		cout << endl;
+			buffer.Append("Empty\n");
+		buffer.Append('\n').WriteTo(cout);
 	}
 
 	/// <summary>
@@ -407,12 +549,74 @@ public:
 	/// <returns>A string representation of the tree.</returns>
 	string ToString() const
 	{
-		ostringstream stream;
-		stream << *this;
-		return stream.str();
+		TextBuffer buffer;
+		Format(buffer);
+		return buffer.Str();
 	}
 
 private:
+	/// <summary>
+	/// Delete a node and all of its children without looking at their values.
+	/// </summary>
+	/// <param name="node">The node to delete.</param>
+	void DeleteNodes(BinaryTreeNode<T>* node)
+	{
+		List<BinaryTreeNode<T>*> pending;
+		if (node != nullptr)
+			pending.Push(node);
+		while (pending.Size() > 0)
+		{
+			node = pending[pending.Size() - 1];
+			pending.Pop();
+			if (node->left != nullptr)
+				pending.Push(node->left);
+			if (node->right != nullptr)
+				pending.Push(node->right);
+			allocator.Delete(node);
+		}
+	}
+
+	/// <summary>
+	/// Get a copy of a node and all of its children, allocated by this tree's allocator.
+	/// </summary>
+	/// <param name="node">The node to copy.</param>
+	/// <returns>The copy of the node.</returns>
+	BinaryTreeNode<T>* CopyNodes(const BinaryTreeNode<T>* node)
+	{
+		if (node == nullptr)
+			return nullptr;
+
+		//Each pending pair is a node whose children still need copying, and its copy
+		BinaryTreeNode<T>* copy = allocator.template New<BinaryTreeNode<T>>(node->data);
+		List<pair<const BinaryTreeNode<T>*, BinaryTreeNode<T>*>> pending;
+		try
+		{
+			pending.Push(make_pair(node, copy));
+			while (pending.Size() > 0)
+			{
+				const BinaryTreeNode<T>* source = pending[pending.Size() - 1].first;
+				BinaryTreeNode<T>* target = pending[pending.Size() - 1].second;
+				pending.Pop();
+				if (source->left != nullptr)
+				{
+					target->left = allocator.template New<BinaryTreeNode<T>>(source->left->data);
+					pending.Push(make_pair(source->left, target->left));
+				}
+				if (source->right != nullptr)
+				{
+					target->right = allocator.template New<BinaryTreeNode<T>>(source->right->data);
+					pending.Push(make_pair(source->right, target->right));
+				}
+			}
+		}
+		catch (...)
+		{
+			DeleteNodes(copy);
+			throw;
+		}
+		return copy;
+	}
+
 	/// <summary>
 	/// Traverse the tree using the depth first pre order search.
 	/// - Process node
@@ -465,12 +669,13 @@ private:
 	}
 
 	/// <summary>
-	/// Recursively prints the tree to std::cout
+	/// Recursively appends the tree to a text buffer.
 	/// https://www.geeksforgeeks.org/print-binary-tree-2-dimensions/
 	/// </summary>
+	/// <param name="buffer">The buffer to append to.</param>
 	/// <param name="node">The current node to process. (Initially root)</param>
 	/// <param name="space">The space between the levels. (Initially 0)</param>
-	void PrintTree(BinaryTreeNode<T>* node, int space) const
+	void FormatTree(TextBuffer& buffer, BinaryTreeNode<T>* node, int space) const
 	{
 		if (node == nullptr)
 			return;
@@ -479,15 +684,12 @@ private:
 		space += 5;
 
 		//Process the right child
-		PrintTree(node->right, space);
+		FormatTree(buffer, node->right, space);
 
-		//Print the current node
-		cout << endl;
-		for (int i = 5; i < space; ++i)
-			cout << " ";
-		cout << node->data << endl;
+		//Append the current node
+		buffer.Append('\n').Repeat(' ', space - 5).Append(node->data).Append('\n');
 
 		//Process the left child
-		PrintTree(node->left, space);
+		FormatTree(buffer, node->left, space);
 	}
 };
\ No newline at end of file
@@ -6,6 +6,9 @@
 #pragma once
 #include <iostream>
 #include <sstream>
+#include "Serialization.h"
+#include "TextBuffer.h"
+#include "NodePool.h"
 
 using namespace std;
 
@@ -13,19 +16,20 @@ using namespace std;
 /// The Dequeue class allows pushing and popping from both ends of the container.
 /// I implemented it using a 'linked list' style format with nodes and pointers.
 /// However, unlike the linked list class, the node does not contain a pointer to the previous node.
+/// The nodes are allocated by the Allocator, e.g. PoolAllocator<> to take them from a pool instead of calling new for every node.
 /// </summary>
-template <typename T>
+template <typename T, typename Allocator = NewAllocator>
 class Dequeue
 {
 private:
 	/// <summary>
 	/// The Node class contains data and a pointer to the next node.
 	/// </summary>
-	template <typename T>
+	template <typename U>
 	class Node
 	{
 	public:
-		T data;			//Data
+		U data;			//Data
 		Node* next;		//Pointer to the next node
 
 		/// <summary>
@@ -33,7 +37,7 @@ private:
 		/// </summary>
 		/// <param name="_data">The data to store in the node.</param>
 		/// <param name="_next">A pointer to the next node.</param>
-		Node(const T& _data, Node* _next)
+		Node(const U& _data, Node* _next)
 		{
 			data = _data;
 			next = _next;
@@ -43,6 +47,7 @@ private:
 	Node<T>* head;			//Head of the container
 	Node<T>* tail;			//Tail of the container
 	unsigned int size;		//Size of the container
+	Allocator allocator;	//Allocates the nodes
 
 public:
 	/// <summary>
@@ -59,7 +64,7 @@ public:
 	/// Copy constructor.
 	/// </summary>
 	/// <param name="copy">The Dequeue to copy into this one.</param>
-	Dequeue(const Dequeue<T>& copy)
+	Dequeue(const Dequeue& copy)
 	{
 		head = nullptr;
 		tail = nullptr;
@@ -77,8 +82,7 @@ public:
 	/// </summary>
 	~Dequeue()
 	{
-		while (head != nullptr)		//Pop until there are none left
-			PopFront();
+		Clear();
 	}
 
 	/// <summary>
@@ -89,12 +93,12 @@ public:
 	{
 		if (head == nullptr)	//If there are no nodes yet, simply set the head and tail
 		{
-			head = new Node<T>(value, nullptr);
+			head = allocator.template New<Node<T>>(value, nullptr);
 			tail = head;
 		}
 		else	//Otherwise create a new node and re-adjust the pointers
 		{
-			Node<T>* newNode = new Node<T>(value, head);
+			Node<T>* newNode = allocator.template New<Node<T>>(value, head);
 			newNode->next = head;
 			head = newNode;
 		}
@@ -110,7 +114,7 @@ public:
 			return;
 		else if (head == tail)		//If there is only 1 node, then delete the head
 		{
-			delete head;
+			allocator.Delete(head);
 			head = nullptr;
 			tail = nullptr;
 		}
@@ -118,7 +122,7 @@ public:
 		{
 			Node<T>* oldNode = head;
 			head = oldNode->next;
-			delete oldNode;
+			allocator.Delete(oldNode);
 		}
 		--size;
 	}
@@ -131,12 +135,12 @@ public:
 	{
 		if (tail == nullptr)	//If there are no nodes yet, then just set the tail
 		{
-			tail = new Node<T>(value, nullptr);
+			tail = allocator.template New<Node<T>>(value, nullptr);
 			head = tail;
 		}
 		else	//Otherwise create a new node and readjust the pointers
 		{
-			Node<T>* newNode = new Node<T>(value, nullptr);
+			Node<T>* newNode = allocator.template New<Node<T>>(value, nullptr);
 			tail->next = newNode;
 			tail = newNode;
 		}
@@ -153,7 +157,7 @@ public:
 			return;
 		else if (tail == head)		//If there is only 1 node, then delete the tail
 		{
-			delete tail;
+			allocator.Delete(tail);
 			tail = nullptr;
 			head = nullptr;
 		}
@@ -162,7 +166,7 @@ public:
 			Node<T>* node = head;
 			while (node->next->next != nullptr)		//Loop through the nodes until we find the node before the tail
 				node = node->next;
-			delete node->next;		//Delete the tail
+			allocator.Delete(node->next);	//Delete the tail
 			tail = node;			//Set the new tail
 			tail->next = nullptr;	//Set the tail's next pointer to nullptr
 		}
@@ -171,11 +175,21 @@ public:
 
 	/// <summary>
 	/// Empty the Dequeue of all nodes.
+	/// If the allocator can release every node at once and the nodes don't need destroying, this takes constant time.
 	/// </summary>
 	void Clear()
 	{
-		while (head != nullptr)		//Pop the values until the Dequeue is empty
-			PopFront();
+		if constexpr (Allocator::BULK_RELEASE && is_trivially_destructible_v<Node<T>>)
+		{
+			allocator.Reset();
+			head = nullptr;
+			tail = nullptr;
+		}
+		else
+		{
+			while (head != nullptr)		//Pop the values until the Dequeue is empty
+				PopFront();
+		}
 		size = 0;
 	}
 
@@ -215,12 +229,40 @@ public:
 		return tail->data;
 	}
 
+	/// <summary>
+	/// Write the Dequeue to a binary writer, from the top to the bottom.
+	/// The nodes are streamed through the writer's buffer.
+	/// </summary>
+	/// <param name="writer">The writer to write to.</param>
+	void Serialize(BinaryWriter& writer) const
+	{
+		writer.WriteHeader<T>(SERIAL_DEQUEUE, size);
+		for (Node<T>* node = head; node != nullptr; node = node->next)
+			writer.WriteValue(node->data);
+	}
+
+	/// <summary>
+	/// Replace the values of the Dequeue with a Dequeue read from a binary reader.
+	/// </summary>
+	/// <param name="reader">The reader to read from.</param>
+	void Deserialize(BinaryReader& reader)
+	{
+		size_t count = reader.ReadHeader<T>(SERIAL_DEQUEUE);
+		Clear();
+		for (size_t i = 0; i < count; ++i)
+		{
+			T value;
+			reader.ReadValue(value);
+			PushBack(value);
+		}
+	}
+
 	/// <summary>
 	/// Assignment operator overload.
 	/// </summary>
 	/// <param name="other">The copy.</param>
 	/// <returns>This Dequeue with new data.</returns>
-	Dequeue<T>& operator= (const Dequeue<T>& other)
+	Dequeue& operator= (const Dequeue& other)
 	{
 		Clear();
 		Node<T>* node = other.head;
@@ -239,7 +281,7 @@ public:
 	/// <param name="os">The output stream to display to.</param>
 	/// <param name="dequeue">The Dequeue to display.</param>
 	/// <returns>The output stream with the Dequeue displayed in it.</returns>
-	friend ostream& operator<< (ostream& os, const Dequeue<T>& dequeue)
+	friend ostream& operator<< (ostream& os, const Dequeue& dequeue)
 	{
 		os << "[";
 		if (!dequeue.Empty())
@@ -248,20 +290,36 @@ public:
 		return os;
 	}
 
+	/// <summary>
+	/// Append the Dequeue to a text buffer in the same format as the << operator.
+	/// </summary>
+	/// <param name="buffer">The buffer to append to.</param>
+	void Format(TextBuffer& buffer) const
+	{
+		buffer.Append('[');
+		if (!Empty())
+			buffer.Append("Top: ").Append(Top()).Append(", Bottom: ").Append(Bottom());
+		buffer.Append(']');
+	}
+
 	/// <summary>
 	/// Print out details about this Dequeue to std::cout.
+	/// The line is formatted in a buffer and written in one piece, without flushing std::cout.
 	/// </summary>
-	void PrintDetails() const
+	/// <param name="maxElements">The most elements to show, the rest are replaced by "...".</param>
+	void PrintDetails(size_t maxElements = FORMAT_ALL) const
 	{
-		cout << "Size: " << size << "  ";
+		TextBuffer& buffer = ScratchTextBuffer();
+		buffer.Append("Size: ").Append(size).Append("  ");
 		Node<T>* node = head;
-		while (node != nullptr)
+		for (size_t shown = 0; node != nullptr && shown < maxElements; ++shown)
 		{
-			cout << node->data;
-			cout << " ";
+			buffer.Append(node->data).Append(' ');
 			node = node->next;
 		}
-		cout << endl;
+		if (node != nullptr)
+			buffer.Append("... ");
+		buffer.Append('\n').WriteTo(cout);
 	}
 
 	/// <summary>
@@ -270,8 +328,8 @@ public:
 	/// <returns>A string representation of the dequeue.</returns>
 	string ToString() const
 	{
-		ostringstream stream;
-		stream << *this;
-		return stream.str();
+		TextBuffer buffer;
+		Format(buffer);
+		return buffer.Str();
 	}
 };
\ No newline at end of file
@@ -1,40 +1,360 @@
 /*
 	File: DynamicList.h
-	Contains: List
+	Contains: ListPolicy, KeepCapacityListPolicy, List
 */
 
 #pragma once
 #include <iostream>
 #include <sstream>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "SimdKernels.h"
+#include "Serialization.h"
+#include "TextBuffer.h"
 
 using namespace std;
 
+/// <summary>
+/// The Thread Barrier holds back each thread that calls Wait() until a set number of threads are waiting, then releases them all together.
+/// It can be waited on again straight away, so a fixed group of threads can work in rounds.
+/// </summary>
+class ThreadBarrier
+{
+private:
+	mutex lock;
+	condition_variable released;
+	size_t threads;		//The number of threads that wait each round
+	size_t waiting;		//The number of threads waiting in the current round
+	size_t round;		//Counts the rounds, so a waiting thread can tell its round has been released
+
+	/// <summary>
+	/// Release the waiting threads if all of them are waiting. The lock must be held.
+	/// </summary>
+	void ReleaseIfAllWaiting()
+	{
+		if (waiting >= threads)
+		{
+			waiting = 0;
+			++round;
+			released.notify_all();
+		}
+	}
+
+public:
+	/// <summary>
+	/// Overloaded constructor.
+	/// </summary>
+	/// <param name="_threads">The number of threads that wait each round.</param>
+	ThreadBarrier(size_t _threads) : threads(_threads), waiting(0), round(0)
+	{
+	}
+
+	/// <summary>
+	/// Wait until every thread has called Wait() for this round.
+	/// </summary>
+	void Wait()
+	{
+		unique_lock<mutex> guard(lock);
+		size_t current = round;
+		++waiting;
+		ReleaseIfAllWaiting();
+		released.wait(guard, [this, current]() { return round != current; });
+	}
+
+	/// <summary>
+	/// Wait for fewer threads from now on, e.g. when some of them could not be started.
+	/// </summary>
+	/// <param name="count">The number of threads that will no longer wait.</param>
+	void Leave(size_t count)
+	{
+		lock_guard<mutex> guard(lock);
+		threads -= count;
+		ReleaseIfAllWaiting();
+	}
+};
+
+/// <summary>
+/// The List Policy controls when a list allocates and frees memory.
+/// It also holds the sizes at which Find() switches between search algorithms.
+/// To use a different policy, inherit from this one, override the members to change and pass it to the list, e.g. List<int, KeepCapacityListPolicy>.
+/// </summary>
+struct ListPolicy
+{
+	static constexpr size_t INITIAL_CAPACITY = 5;		//The capacity of a list made with the default constructor, and the smallest capacity it shrinks to
+	static constexpr float GROWTH_FACTOR = 2.0f;		//The initial factor the capacity is multiplied by when the list is full
+	static constexpr bool SHRINK = true;				//Whether removing values can free memory
+	static constexpr float SHRINK_THRESHOLD = 0.25f;	//The capacity is halved once the size drops below this fraction of it
+	static constexpr bool KEEP_ON_CLEAR = false;		//Whether Clear() keeps the memory for the next values
+
+	static constexpr size_t LINEAR_SEARCH_THRESHOLD = 128;				//Find() scans sorted lists smaller than this linearly
+	static constexpr size_t SIMD_LINEAR_SEARCH_THRESHOLD = 1024;		//The same, for types the vectorised scan supports
+	static constexpr size_t INTERPOLATION_SEARCH_THRESHOLD = 256;		//Find() uses an interpolation search on evenly spread sorted lists of numbers this size or larger
+	static constexpr float INTERPOLATION_SPREAD_TOLERANCE = 0.125f;		//How far, as a fraction of the range, a quartile can be from an even spread for Find() to still interpolate
+};
+
+/// <summary>
+/// A list policy that never frees memory until the list is destroyed or ShrinkToFit() is called.
+/// Suited to lists that are filled and emptied every frame.
+/// </summary>
+struct KeepCapacityListPolicy : ListPolicy
+{
+	static constexpr bool SHRINK = false;
+	static constexpr bool KEEP_ON_CLEAR = true;
+};
+
 /// <summary>
 /// The List class is a Dynamic List container that expands in memory when needed.
+/// Elements are only constructed when they are added, so the spare capacity is uninitialised memory.
+/// How the capacity grows and shrinks is controlled by the policy.
 /// </summary>
-template <typename T>
+template <typename T, typename Policy = ListPolicy>
 class List
 {
 private:
 	T* data;				//A pointer to the start of the array in the heap
-	unsigned int size;		//The size of the list
-	unsigned int capacity;	//The current capacity of the list
-	const unsigned int MAX_CAPACITY = 500;	//The maximum capacity allowed to be reserved for the list
+	size_t size;			//The size of the list
+	size_t capacity;		//The current capacity of the list
+	float growthFactor;		//The factor the capacity is multiplied by when the list runs out of space
+	T* inlineData;			//Storage inside a small list that is used while the list fits in it, null for other lists
+	size_t inlineCapacity;	//The number of elements that fit in the inline storage
+	bool knownSorted;		//Whether the list is known to be in ascending order, set by the sorts and cleared by anything that breaks the order
+	T* mergeBuffer;			//Uninitialised memory the tim sort merges through, kept between sorts so sorting every frame doesn't allocate
+	size_t mergeBufferSize;	//The number of elements that fit in the merge buffer
+
+	static_assert(Policy::SHRINK_THRESHOLD < 0.5f, "The shrink threshold must be below a half so the list doesn't reallocate back and forth.");
+
+	static const size_t INSERTION_SORT_THRESHOLD = 16;	//Ranges this size or smaller are insertion sorted by the introsort
+	static const size_t NINTHER_THRESHOLD = 128;		//Ranges this size or larger use the ninther to pick a pivot
+	static const size_t PARALLEL_SORT_MIN_BLOCK = 16384;	//The smallest block of the list that the parallel sort will give a thread
+	static const size_t PARALLEL_AGGREGATE_MIN_BLOCK = 262144;	//The smallest block of the list that Sum(), MinMax() etc. will give a thread
+	static const size_t TIM_SORT_MIN_MERGE = 64;		//Lists smaller than this are tim sorted as a single run
+	static const size_t MIN_GALLOP = 7;					//The number of wins in a row before a tim sort merge starts galloping
+	static const size_t MAX_RUNS = 85;					//The most runs the tim sort can have waiting to merge, enough for 2^64 values
+	static const size_t DESERIALIZE_CHUNK_BYTES = 1 << 20;	//The size of the pieces Deserialize() reads, growing the list before each one
+
+	/// <summary>
+	/// Calculate the capacity the list should grow to when it is full.
+	/// Grows geometrically so that pushing is amortised O(1).
+	/// </summary>
+	/// <returns>The next capacity of the list.</returns>
+	size_t NextCapacity() const
+	{
+		size_t newCapacity = (size_t)(capacity * growthFactor);
+
+		//Always grow by at least one element (small capacities can round down to themselves)
+		if (newCapacity <= capacity)
+			newCapacity = capacity + 1;
+
+		//Don't grow past the largest capacity that can be allocated
+		if (newCapacity > MaxCapacity() || newCapacity < capacity)
+			newCapacity = MaxCapacity();
+		return newCapacity;
+	}
+
+	/// <summary>
+	/// Allocate uninitialised memory for a number of elements.
+	/// </summary>
+	/// <param name="count">The number of elements to allocate memory for.</param>
+	/// <returns>A pointer to the start of the memory.</returns>
+	static T* Allocate(size_t count)
+	{
+		return static_cast<T*>(::operator new(sizeof(T) * count));
+	}
+
+	/// <summary>
+	/// Free memory allocated by Allocate().
+	/// Any elements in the memory must have already been destroyed.
+	/// </summary>
+	/// <param name="pointer">The memory to free.</param>
+	static void Deallocate(T* pointer)
+	{
+		::operator delete(pointer);
+	}
+
+	/// <summary>
+	/// Free the memory the list's elements are stored in, unless it is the inline storage of a small list.
+	/// Any elements in the memory must have already been destroyed.
+	/// </summary>
+	void FreeData()
+	{
+		if (data != inlineData)
+			Deallocate(data);
+	}
+
+	/// <summary>
+	/// Destroy a number of constructed elements.
+	/// </summary>
+	/// <param name="first">The first element to destroy.</param>
+	/// <param name="count">The number of elements to destroy.</param>
+	static void Destroy(T* first, size_t count)
+	{
+		if constexpr (!is_trivially_destructible_v<T>)
+			for (size_t i = 0; i < count; ++i)
+				first[i].~T();
+	}
+
+	/// <summary>
+	/// Copy constructs elements into uninitialised memory.
+	/// Uses memcpy if the type allows it.
+	/// </summary>
+	/// <param name="destination">The uninitialised memory to copy to.</param>
+	/// <param name="source">The elements to copy.</param>
+	/// <param name="count">The number of elements to copy.</param>
+	static void CopyConstruct(T* destination, const T* source, size_t count)
+	{
+		if constexpr (is_trivially_copyable_v<T>)
+		{
+			if (count > 0)
+				memcpy(destination, source, sizeof(T) * count);
+		}
+		else
+		{
+			size_t i = 0;
+			try
+			{
+				for (; i < count; ++i)
+					new (destination + i) T(source[i]);
+			}
+			catch (...)
+			{
+				//Undo the copies that were made before the exception
+				Destroy(destination, i);
+				throw;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Move elements into uninitialised memory and destroy the originals.
+	/// Uses memcpy if the type allows it, otherwise each element is moved.
+	/// </summary>
+	/// <param name="destination">The uninitialised memory to move to.</param>
+	/// <param name="source">The elements to move.</param>
+	/// <param name="count">The number of elements to move.</param>
+	static void Relocate(T* destination, T* source, size_t count)
+	{
+		if constexpr (is_trivially_copyable_v<T>)
+		{
+			if (count > 0)
+				memcpy(destination, source, sizeof(T) * count);
+		}
+		else
+			for (size_t i = 0; i < count; ++i)
+			{
+				new (destination + i) T(move(source[i]));
+				source[i].~T();
+			}
+	}
+
+	/// <summary>
+	/// Move the elements to a new block of memory with a different capacity.
+	/// Elements that don't fit in the new capacity are destroyed.
+	/// A small list never goes below its inline capacity, and moves back into its inline storage when it fits.
+	/// </summary>
+	/// <param name="newCapacity">The capacity of the new block of memory.</param>
+	void Reallocate(size_t newCapacity)
+	{
+		bool toInline = newCapacity <= inlineCapacity;
+		if (toInline)
+			newCapacity = inlineCapacity;
+		if (size > newCapacity)
+		{
+			Destroy(data + newCapacity, size - newCapacity);
+			size = newCapacity;
+		}
+		if (toInline && data == inlineData)
+			return;
+
+		T* newData = toInline ? inlineData : Allocate(newCapacity);
+		Relocate(newData, data, size);
+		FreeData();
+		data = newData;
+		capacity = newCapacity;
+	}
+
+	/// <summary>
+	/// Take the elements of another list, leaving it empty.
+	/// This list must not have any storage of its own other than its inline storage.
+	/// Heap storage is taken as it is. Elements in a small list's inline storage can't be taken,
+	/// so they are moved into this list's inline storage if they fit, otherwise into new heap storage.
+	/// </summary>
+	/// <param name="other">The list to take the elements from. It is left with its inline storage, or no storage.</param>
+	void TakeData(List& other)
+	{
+		if (other.data != other.inlineData)
+		{
+			data = other.data;
+			capacity = other.capacity;
+		}
+		else
+		{
+			if (inlineData != nullptr && other.size <= inlineCapacity)
+			{
+				data = inlineData;
+				capacity = inlineCapacity;
+			}
+			else
+			{
+				data = Allocate(other.capacity);
+				capacity = other.capacity;
+			}
+			Relocate(data, other.data, other.size);
+		}
+		size = other.size;
+		growthFactor = other.growthFactor;
+		knownSorted = other.knownSorted;
+		other.data = other.inlineData;
+		other.size = 0;
+		other.capacity = other.inlineCapacity;
+		other.knownSorted = false;
+	}
+
+	/// <summary>
+	/// Move every value that shouldn't be removed down over the values that should, then shrink the list.
+	/// </summary>
+	/// <param name="write">The index of the first value to remove, or size if there are none.</param>
+	/// <param name="pred">Returns true if a value should be removed.</param>
+	/// <returns>The number of values removed.</returns>
+	template <typename Predicate>
+	size_t Compact(size_t write, Predicate& pred)
+	{
+		if (write >= size)
+			return 0;
+
+		for (size_t read = write + 1; read < size; ++read)
+			if (!pred(data[read]))
+				data[write++] = move(data[read]);
+
+		size_t removed = size - write;
+		ReduceSize(removed);
+		return removed;
+	}
 
 	/// <summary>
 	/// Reduce the size of the list.
 	/// Also checks if space should be freed in memory.
+	/// The capacity is only halved once the size is well below half of it,
+	/// so a list that hovers around one size doesn't keep reallocating.
 	/// </summary>
 	/// <param name="amount">The amount to reduce the size by.</param>
-	void ReduceSize(unsigned int amount)
+	void ReduceSize(size_t amount)
 	{
 		if (amount > size)
-			size = 0;
-		else
-			size -= amount;
-		
-		if (capacity > 5 && size < (capacity / 2) - 2)
-			Discard(capacity / 2);
+			amount = size;
+		Destroy(data + size - amount, amount);
+		size -= amount;
+
+		if constexpr (Policy::SHRINK)
+			if (capacity > Policy::INITIAL_CAPACITY && size < capacity * Policy::SHRINK_THRESHOLD)
+				Reallocate(capacity / 2 > Policy::INITIAL_CAPACITY ? capacity / 2 : Policy::INITIAL_CAPACITY);
 	}
 
 	/// <summary>
@@ -44,9 +364,13 @@ private:
 	/// <param name="b">Pointer B.</param>
 	void Swap(T* a, T* b)
 	{
-		T temp = *a;
-		*a = *b;
-		*b = temp;
+		//Moving a value into itself would leave it in a moved-from state
+		if (a == b)
+			return;
+
+		T temp = move(*a);
+		*a = move(*b);
+		*b = move(temp);
 	}
 	
 	/// <summary>
@@ -55,11 +379,21 @@ private:
 	/// <param name="x">First number.</param>
 	/// <param name="y">Second number.</param>
 	/// <returns>The minimum of the two given numbers.</returns>
-	int Min(int x, int y) const
+	size_t Min(size_t x, size_t y) const
 	{
 		return ((x <= y) ? x : y);
 	}
 
+	/// <summary>
+	/// Check if a comparison sorts values in ascending order, so a sort that uses it leaves the list known to be sorted.
+	/// </summary>
+	/// <returns>True if the comparison is the default less than.</returns>
+	template <typename Compare>
+	static constexpr bool IsAscending()
+	{
+		return is_same_v<Compare, less<T>> || is_same_v<Compare, less<>>;
+	}
+
 	/// <summary>
 	/// Quick sort chooses an element as a pivot and partitions around the pivot.
 	/// This implementation chooses the last element as the pivot.
@@ -67,11 +401,11 @@ private:
 	/// </summary>
 	/// <param name="low">The starting index of the sort.</param>
 	/// <param name="high">The ending index of the sort.</param>
-	void QuickSort(int low, int high)
+	void QuickSort(long long low, long long high)
 	{
 		if (low < high)
 		{
-			int partitionIndex = Partition(low, high);	//Partitioning index
+			long long partitionIndex = Partition(low, high);	//Partitioning index
 			QuickSort(low, partitionIndex - 1);		//Before partition
 			QuickSort(partitionIndex + 1, high);	//After partition
 		}
@@ -84,15 +418,15 @@ private:
 	/// <param name="low">Lowest point of the list.</param>
 	/// <param name="high">Highest point of the list.</param>
 	/// <returns>Partitioning index.</returns>
-	int Partition(int low, int high)
+	long long Partition(long long low, long long high)
 	{
 		//Pivot (last element)
-		T pivot = data[high];
+		const T& pivot = data[high];
 
 		//Index of smaller element
-		int i = (low - 1);
+		long long i = (low - 1);
 
-		for (int j = low; j <= high - 1; ++j)
+		for (long long j = low; j <= high - 1; ++j)
 		{
 			//If the current element is smaller than or equal to the pivot
 			if (data[j] <= pivot)
@@ -111,375 +445,2144 @@ private:
 	/// Heapify a sub-tree.
 	/// https://www.geeksforgeeks.org/heap-sort/
 	/// </summary>
+	/// <param name="heap">Pointer to the first element of the heap.</param>
 	/// <param name="_size">Size of the heap.</param>
 	/// <param name="index">Index in the heap.</param>
-	void Heapify(int _size, int index)
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	template <typename Compare>
+	void Heapify(T* heap, size_t _size, size_t index, Compare& comp)
 	{
-		int largest = index;	//Initialise largest as the root
-		int left = 2 * index + 1;	//Left child
-		int right = 2 * index + 2;	//Right child
+		size_t largest = index;		//Initialise largest as the root
+		size_t left = 2 * index + 1;	//Left child
+		size_t right = 2 * index + 2;	//Right child
 
 		//If the left child is larger than the root, then set as largest
-		if (left < _size && data[left] > data[largest])
+		if (left < _size && comp(heap[largest], heap[left]))
 			largest = left;
 
 		//If the right child is larger than the root, then set as largest
-		if (right < _size && data[right] > data[largest])
+		if (right < _size && comp(heap[largest], heap[right]))
 			largest = right;
 
 		//If the largest is not the root
 		if (largest != index)
 		{
 			//Swap the index and the largest
-			Swap(&data[index], &data[largest]);
+			Swap(&heap[index], &heap[largest]);
 
 			//Recursively heapify the affected sub-tree
-			Heapify(_size, largest);
+			Heapify(heap, _size, largest, comp);
 		}
 	}
 
-public:
 	/// <summary>
-	/// Default constructor.
-	/// Has an initial capacity of 5.
+	/// Perform a heap sort on part of the list.
 	/// </summary>
-	List()
+	/// <param name="low">The first index of the range.</param>
+	/// <param name="high">One past the last index of the range.</param>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	template <typename Compare>
+	void HeapSort(size_t low, size_t high, Compare& comp)
 	{
-		capacity = 5;
-		size = 0;
-		data = new T[capacity];
-		memset(data, 0, sizeof(T) * capacity);
+		T* heap = data + low;
+		size_t heapSize = high - low;
+
+		//Build a heap (rearrange array)
+		for (size_t i = heapSize / 2; i > 0; --i)
+			Heapify(heap, heapSize, i - 1, comp);
+
+		//One by one extract an element from the heap
+		for (size_t i = heapSize; i > 1; --i)
+		{
+			//Move current root to end
+			Swap(&heap[0], &heap[i - 1]);
+
+			//Call max heapify on the reduced heap
+			Heapify(heap, i - 1, 0, comp);
+		}
 	}
-	
+
 	/// <summary>
-	/// Overloaded constructor.
+	/// Perform an insertion sort on part of the list.
 	/// </summary>
-	/// <param name="_capacity">The initial capacity of this list.</param>
-	List(unsigned int _capacity)
+	/// <param name="low">The first index of the range.</param>
+	/// <param name="high">One past the last index of the range.</param>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	template <typename Compare>
+	void InsertionSort(size_t low, size_t high, Compare& comp)
 	{
-		if (_capacity == 0)
-			capacity = 1;
-		else if (_capacity > MAX_CAPACITY)
-			capacity = MAX_CAPACITY;
-		else
-			capacity = _capacity;
-		size = 0;
-		data = new T[capacity];
-		memset(data, 0, sizeof(T) * capacity);
+		for (size_t i = low + 1; i < high; ++i)
+		{
+			//Skip values that are already in place
+			if (!comp(data[i], data[i - 1]))
+				continue;
+
+			T key = move(data[i]);
+			size_t j = i;
+			do
+			{
+				data[j] = move(data[j - 1]);
+				--j;
+			} while (j > low && comp(key, data[j - 1]));
+			data[j] = move(key);
+		}
 	}
-	
+
 	/// <summary>
-	/// Copy constructor.
-	/// Copies the data from the copy to this list.
+	/// Get the index of the median of three values.
 	/// </summary>
-	/// <param name="copy">The copy.</param>
-	List(const List& copy)
+	/// <param name="a">Index of the first value.</param>
+	/// <param name="b">Index of the second value.</param>
+	/// <param name="c">Index of the third value.</param>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	/// <returns>The index of the median value.</returns>
+	template <typename Compare>
+	size_t MedianOfThree(size_t a, size_t b, size_t c, Compare& comp) const
 	{
-		capacity = copy.capacity;
-		size = copy.size;
-		data = new T[capacity];
-		memcpy(data, copy.data, sizeof(T) * capacity);
+		if (comp(data[a], data[b]))
+		{
+			if (comp(data[b], data[c]))
+				return b;
+			return comp(data[a], data[c]) ? c : a;
+		}
+		if (comp(data[a], data[c]))
+			return a;
+		return comp(data[b], data[c]) ? c : b;
 	}
 
 	/// <summary>
-	/// Deconstructor.
+	/// Choose a pivot for a range of the list.
+	/// Uses the median of three for small ranges and the median of three medians (ninther) for large ranges,
+	/// so sorted, reversed and organ-pipe input still split evenly.
 	/// </summary>
-	~List()
+	/// <param name="low">The first index of the range.</param>
+	/// <param name="high">One past the last index of the range.</param>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	/// <returns>The index of the pivot.</returns>
+	template <typename Compare>
+	size_t ChoosePivot(size_t low, size_t high, Compare& comp) const
 	{
-		delete[] data;
+		size_t last = high - 1;
+		size_t middle = low + (high - low) / 2;
+		if (high - low < NINTHER_THRESHOLD)
+			return MedianOfThree(low, middle, last, comp);
+
+		size_t step = (high - low) / 8;
+		return MedianOfThree(
+			MedianOfThree(low, low + step, low + 2 * step, comp),
+			MedianOfThree(middle - step, middle, middle + step, comp),
+			MedianOfThree(last - 2 * step, last - step, last, comp), comp);
 	}
 
 	/// <summary>
-	/// Increase the capacity of the list by a certain amount.
+	/// Calculate how many partitions the introsort can make before it falls back to a heap sort.
 	/// </summary>
-	/// <param name="amount">The amount to increase the capacity by.</param>
-	void Reserve(unsigned int amount)
+	/// <param name="count">The number of values being sorted.</param>
+	/// <returns>2 * log2(count).</returns>
+	static size_t DepthLimit(size_t count)
 	{
-		if (capacity == MAX_CAPACITY)					//If the capacity is at the maximum capacity, then return
-			return;
-		else if (capacity + amount > MAX_CAPACITY)		//If the new capacity will be greater than the maximum capacity, handle accordingly
-		{
-			T* newData = new T[MAX_CAPACITY];
-			memcpy(newData, data, sizeof(T) * MAX_CAPACITY);
-			delete[] data;
-			data = newData;
-			capacity = MAX_CAPACITY;
-		}	
-		else	//Otherwise handle like normal
+		size_t depthLimit = 0;
+		for (; count > 1; count >>= 1)
+			depthLimit += 2;
+		return depthLimit;
+	}
+
+	/// <summary>
+	/// Merge two sorted ranges into another array.
+	/// If a value compares equal in both ranges, the one from the first range is taken first.
+	/// </summary>
+	/// <param name="a">The first sorted range.</param>
+	/// <param name="countA">The number of values in the first range.</param>
+	/// <param name="b">The second sorted range.</param>
+	/// <param name="countB">The number of values in the second range.</param>
+	/// <param name="destination">Where to write the merged values.</param>
+	/// <param name="construct">True if the destination is uninitialised memory, false to assign over existing values.</param>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	template <typename Compare>
+	static void MergeRanges(T* a, size_t countA, T* b, size_t countB, T* destination, bool construct, Compare& comp)
+	{
+		size_t left = 0;
+		size_t right = 0;
+		for (size_t i = 0; i < countA + countB; ++i)
 		{
-			T* newData = new T[capacity + amount];
-			memcpy(newData, data, sizeof(T) * capacity);
-			delete[] data;
-			data = newData;
-			capacity += amount;
+			T& from = (left < countA && (right == countB || !comp(b[right], a[left]))) ? a[left++] : b[right++];
+			if (construct)
+				new (destination + i) T(move(from));
+			else
+				destination[i] = move(from);
 		}
 	}
 
 	/// <summary>
-	/// Decrease the capacity of the list by a certain amount.
+	/// Find how many values of the first block come before a position in the merge of two neighbouring sorted blocks (its co-rank),
+	/// so that a merge can be split into pieces that are merged on different threads.
+	/// Uses a binary search, so it takes O(log n) comparisons.
 	/// </summary>
-	/// <param name="amount">The amount to decrease the capacity by.</param>
-	void Discard(unsigned int amount)
+	/// <param name="source">The array containing the sorted blocks.</param>
+	/// <param name="low">The first index of the first block.</param>
+	/// <param name="middle">The first index of the second block.</param>
+	/// <param name="high">One past the last index of the second block.</param>
+	/// <param name="position">The position in the merged values, from 0 to high - low.</param>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	/// <returns>The number of values from the first block in the first position values of the merge.</returns>
+	template <typename Compare>
+	static size_t MergeSplit(const T* source, size_t low, size_t middle, size_t high, size_t position, Compare& comp)
 	{
-		//If the reduced capacity would be below or equal to zero, set the capacity to 1
-		if (capacity - amount <= 0)
+		size_t first = position > high - middle ? position - (high - middle) : 0;
+		size_t last = position < middle - low ? position : middle - low;
+		while (first < last)
 		{
-			delete[] data;
-			data = new T[1];
-			memset(data, 0, sizeof(T));
-			capacity = 1;
-			size = 0;
+			//If the i'th value of the first block is merged before the value of the second block just before the split, the split takes more of the first block
+			size_t i = first + (last - first) / 2;
+			if (!comp(source[middle + (position - i) - 1], source[low + i]))
+				first = i + 1;
+			else
+				last = i;
 		}
-		else
+		return first;
+	}
+
+	/// <summary>
+	/// Run one round of the parallel sort's merges for one worker.
+	/// Each pair of neighbouring runs is merged into one, and the worker writes its own slice of the output wherever it falls,
+	/// so the work is shared evenly between the workers however many merges there are.
+	/// Every worker finds where its slice splits the runs before any of them start moving values, as the splits compare values all over the runs.
+	/// After that the values each worker merges don't overlap.
+	/// </summary>
+	/// <param name="source">The array containing the sorted runs.</param>
+	/// <param name="destination">The array to merge into.</param>
+	/// <param name="bounds">Where each block of the sort starts, the last entry is the end of the list.</param>
+	/// <param name="width">The number of blocks in each run.</param>
+	/// <param name="start">The first index of the worker's slice of the output.</param>
+	/// <param name="end">One past the last index of the worker's slice of the output.</param>
+	/// <param name="construct">True if the destination is uninitialised memory, false to assign over existing values.</param>
+	/// <param name="barrier">The barrier every worker waits on between finding the splits and merging.</param>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	template <typename Compare>
+	static void MergeSlice(T* source, T* destination, const List<size_t>& bounds, size_t width, size_t start, size_t end, bool construct,
+		ThreadBarrier& barrier, Compare& comp)
+	{
+		//The merges the slice falls in: their bounds, the part of each merge in the slice and how many of that part's values come from the first run
+		struct Piece
 		{
-			T* newData = new T[capacity - amount];
-			memcpy(newData, data, sizeof(T) * (capacity - amount));
-			delete[] data;
-			data = newData;
-			capacity -= amount;
+			size_t low, middle, high, first, last, firstA, lastA;
+		};
+		List<Piece> pieces;
+		size_t blocks = bounds.Size() - 1;
+		for (size_t pair = 0; pair < blocks; pair += 2 * width)
+		{
+			Piece piece;
+			piece.low = bounds[pair];
+			piece.middle = bounds[pair + width < blocks ? pair + width : blocks];
+			piece.high = bounds[pair + 2 * width < blocks ? pair + 2 * width : blocks];
+			if (piece.high <= start || piece.low >= end)
+				continue;
+
+			piece.first = (start > piece.low ? start : piece.low) - piece.low;
+			piece.last = (end < piece.high ? end : piece.high) - piece.low;
+			piece.firstA = MergeSplit(source, piece.low, piece.middle, piece.high, piece.first, comp);
+			piece.lastA = MergeSplit(source, piece.low, piece.middle, piece.high, piece.last, comp);
+			pieces.Push(piece);
+		}
 
-			if (size > capacity)
-				size = capacity;
+		barrier.Wait();
+		for (size_t i = 0; i < pieces.Size(); ++i)
+		{
+			const Piece& piece = pieces[i];
+			MergeRanges(source + piece.low + piece.firstA, piece.lastA - piece.firstA,
+				source + piece.middle + (piece.first - piece.firstA), (piece.last - piece.lastA) - (piece.first - piece.firstA),
+				destination + piece.low + piece.first, construct, comp);
 		}
 	}
 
 	/// <summary>
-	/// Push a new value to the list.
-	/// If it will not fit then increase the capacity.
+	/// Run a function on a group of threads at once: the calling thread is worker 0 and a thread is started for each of the others.
+	/// The workers can wait for each other on the barrier between rounds of work, so the same threads are used for every round.
+	/// If a thread can't be started, the ones that were are stopped before they do any work and joined, then the exception is rethrown.
+	/// The function must not throw, as the other workers would wait for it forever.
 	/// </summary>
-	/// <param name="value">The value to push to the list.</param>
-	void Push(const T& value)
+	/// <param name="workers">The number of workers.</param>
+	/// <param name="fn">Called on each worker with the worker number and the barrier.</param>
+	template <typename WorkerFn>
+	static void RunWorkers(size_t workers, WorkerFn fn)
 	{
-		if (size == capacity)		//If there is no more capacity then double the capacity
-			Reserve(capacity);
-		if (size != capacity)		//If there is more capacity now, then add the value
+		ThreadBarrier barrier(workers);
+		bool abort = false;		//Only written before the starting barrier, which orders it before the workers read it
+		List<thread> threads(workers > 1 ? workers - 1 : 1);
+		try
+		{
+			for (size_t w = 1; w < workers; ++w)
+				threads.EmplaceBack([&barrier, &abort, &fn, w]()
+				{
+					barrier.Wait();
+					if (!abort)
+						fn(w, barrier);
+				});
+		}
+		catch (...)
 		{
-			data[size] = value;
-			++size;
+			abort = true;
+			barrier.Leave(workers - 1 - threads.Size());
+			barrier.Wait();
+			for (size_t i = 0; i < threads.Size(); ++i)
+				threads[i].join();
+			throw;
 		}
+
+		barrier.Wait();
+		fn(0, barrier);
+		for (size_t i = 0; i < threads.Size(); ++i)
+			threads[i].join();
 	}
 
 	/// <summary>
-	/// Insert a value at a specified index in the list.
+	/// Calculate how many blocks to split the list into for an operation that runs one block per thread.
 	/// </summary>
-	/// <param name="index">The index to insert at.</param>
-	/// <param name="value">The value to insert.</param>
-	void Insert(unsigned int index, const T& value)
+	/// <param name="threads">The number of threads to use. 0 uses one thread per hardware core.</param>
+	/// <param name="minBlock">The smallest block that is worth a thread.</param>
+	/// <returns>The number of blocks, at least 1.</returns>
+	size_t BlockCount(unsigned int threads, size_t minBlock) const
 	{
-		//If an invalid index, return
-		if (index < 0 || index > size)
+		if (threads == 0)
+			threads = thread::hardware_concurrency();
+		size_t blocks = size / minBlock;
+		if (blocks > threads)
+			blocks = threads;
+		return blocks > 0 ? blocks : 1;
+	}
+
+	/// <summary>
+	/// Split the list into equal blocks and run a function on each one, each on its own thread.
+	/// The calling thread runs the first block, and a single block doesn't start any threads.
+	/// </summary>
+	/// <param name="blocks">The number of blocks, from BlockCount().</param>
+	/// <param name="fn">Called with the block number and the first and one past the last index of the block.</param>
+	template <typename BlockFn>
+	void ForEachBlock(size_t blocks, BlockFn fn) const
+	{
+		if (blocks < 2)
+		{
+			fn(0, 0, size);
 			return;
-		//If the index is the size, push to the back (handles if the size is 0)
-		else if (index == size)
-			Push(value);
-		else
+		}
+		RunWorkers(blocks, [this, &fn, blocks](size_t block, ThreadBarrier&) { fn(block, size * block / blocks, size * (block + 1) / blocks); });
+	}
+
+	/// <summary>
+	/// Introsort a range of the list.
+	/// Quick sorts around a median pivot, only recursing into the smaller partition,
+	/// and finishes small ranges with an insertion sort.
+	/// Falls back to a heap sort if the partitions keep coming out unbalanced.
+	/// </summary>
+	/// <param name="low">The first index of the range.</param>
+	/// <param name="high">One past the last index of the range.</param>
+	/// <param name="depthLimit">The number of partitions left before falling back to a heap sort.</param>
+	/// <param name="leftmost">False if the value before the range is known to be less than or equal to every value in the range.</param>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	template <typename Compare>
+	void IntroSort(size_t low, size_t high, size_t depthLimit, bool leftmost, Compare& comp)
+	{
+		while (high - low > INSERTION_SORT_THRESHOLD)
 		{
-			//Push the value to the back
-			Push(value);
+			if (depthLimit == 0)
+			{
+				HeapSort(low, high, comp);
+				return;
+			}
+			--depthLimit;
+
+			//Move the pivot to the front of the range
+			Swap(&data[low], &data[ChoosePivot(low, high, comp)]);
+
+			//The value before the range is never greater than any value in it.
+			//If the pivot is equal to it then the pivot is the smallest value, so split the range three ways:
+			//group the values equal to the pivot at the front and skip past them without sorting them again
+			if (!leftmost && !comp(data[low - 1], data[low]))
+			{
+				size_t equal = low;
+				for (size_t i = low + 1; i < high; ++i)
+					if (!comp(data[low], data[i]))
+						Swap(&data[++equal], &data[i]);
+				low = equal + 1;
+				continue;
+			}
 
-			//Move the value down the list to the desired index
-			for (unsigned int i = size - 1; i != index; --i)
-				Swap(&data[i], &data[i - 1]);
+			//Hoare partition around the pivot
+			//Both scans stop on values equal to the pivot so a run of duplicates is still split down the middle
+			size_t i = low;
+			size_t j = high;
+			while (true)
+			{
+				do ++i; while (i < high && comp(data[i], data[low]));
+				do --j; while (comp(data[low], data[j]));
+				if (i >= j)
+					break;
+				Swap(&data[i], &data[j]);
+			}
+			Swap(&data[low], &data[j]);
 
-			//Set the value at the index (dunno why)
-			data[index] = value;
+			//Recurse into the smaller partition and loop on the larger one to keep the stack shallow
+			if (j - low < high - (j + 1))
+			{
+				IntroSort(low, j, depthLimit, leftmost, comp);
+				low = j + 1;
+				leftmost = false;
+			}
+			else
+			{
+				IntroSort(j + 1, high, depthLimit, false, comp);
+				high = j;
+			}
 		}
+
+		InsertionSort(low, high, comp);
 	}
-	
+
 	/// <summary>
-	/// Insert another list at a specific index in this list.
+	/// Get the merge buffer, growing it if it can't hold a number of elements.
 	/// </summary>
-	/// <param name="index">The index to insert the list.</param>
-	/// <param name="values">The list.</param>
-	void Insert(unsigned int index, const List<T>& values)
+	/// <param name="count">The number of elements the buffer needs to hold.</param>
+	/// <returns>The merge buffer.</returns>
+	T* MergeBuffer(size_t count)
 	{
-		if (values.Size() == 0)
-			return;
-		else
-			//Iterate through the values and insert them into our list
-			for (unsigned int i = 0; i < values.Size(); ++i)
-				Insert(index + i, values[i]);
+		if (count > mergeBufferSize)
+		{
+			//A merge never needs more than half the list, so grow straight to that
+			size_t newSize = size / 2 > count ? size / 2 : count;
+			T* newBuffer = Allocate(newSize);
+			Deallocate(mergeBuffer);
+			mergeBuffer = newBuffer;
+			mergeBufferSize = newSize;
+		}
+		return mergeBuffer;
 	}
 
 	/// <summary>
-	/// Pop the element off the end of the list.
+	/// Free the merge buffer.
 	/// </summary>
-	void Pop()
+	void FreeMergeBuffer()
 	{
-		if (size > 0)
-			ReduceSize(1);
+		Deallocate(mergeBuffer);
+		mergeBuffer = nullptr;
+		mergeBufferSize = 0;
 	}
 
 	/// <summary>
-	/// Remove the value at a specific index from the list.
-	/// This will remove any order from the list.
-	/// To preserve order, RemoveKeepOrder() should be used.
+	/// Calculate the shortest run the tim sort will merge for a list of a given size.
+	/// Picks a length between 32 and 64 so that the number of runs is a power of two, or just below one, which keeps the merges balanced.
 	/// </summary>
-	/// <param name="index">The index of the value to be removed.</param>
-	void Remove(unsigned int index)
+	/// <param name="count">The size of the list.</param>
+	/// <returns>The minimum run length.</returns>
+	static size_t MinRunLength(size_t count)
 	{
-		if (size > 0 && index >= 0 && index < size)
+		size_t remainder = 0;
+		while (count >= TIM_SORT_MIN_MERGE)
 		{
-			if (size == 1 || index == (size - 1))
-				Pop();
-			else
-			{
-				data[index] = data[size - 1];
+			remainder |= count & 1;
+			count >>= 1;
+		}
+		return count + remainder;
+	}
+
+	/// <summary>
+	/// Find the length of the run that starts at an index.
+	/// A run either never decreases or always strictly decreases. Decreasing runs are reversed, which is safe as they have no equal values.
+	/// </summary>
+	/// <param name="low">The start of the run.</param>
+	/// <param name="high">The end of the list (exclusive).</param>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	/// <returns>The length of the run.</returns>
+	template <typename Compare>
+	size_t CountRun(size_t low, size_t high, Compare& comp)
+	{
+		size_t end = low + 1;
+		if (end == high)
+			return 1;
+
+		if (comp(data[end], data[low]))
+		{
+			while (end + 1 < high && comp(data[end + 1], data[end]))
+				++end;
+			++end;
+			for (size_t i = low, j = end - 1; i < j; ++i, --j)
+				Swap(&data[i], &data[j]);
+		}
+		else
+		{
+			while (end + 1 < high && !comp(data[end + 1], data[end]))
+				++end;
+			++end;
+		}
+		return end - low;
+	}
+
+	/// <summary>
+	/// Insertion sort a range whose start is already sorted, using a binary search to find where each value goes.
+	/// Values are placed after any equal values, so the sort is stable.
+	/// </summary>
+	/// <param name="low">The start of the range.</param>
+	/// <param name="high">The end of the range (exclusive).</param>
+	/// <param name="start">The first value that isn't already sorted.</param>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	template <typename Compare>
+	void BinaryInsertionSort(size_t low, size_t high, size_t start, Compare& comp)
+	{
+		for (size_t i = start; i < high; ++i)
+		{
+			T value = move(data[i]);
+			size_t left = low;
+			size_t right = i;
+			while (left < right)
+			{
+				size_t middle = left + (right - left) / 2;
+				if (comp(value, data[middle]))
+					right = middle;
+				else
+					left = middle + 1;
+			}
+
+			MoveBackward(data + left + 1, data + left, i - left);
+			data[left] = move(value);
+		}
+	}
+
+	/// <summary>
+	/// Find where a value belongs in a sorted array, before any equal values.
+	/// Starts at a hint and checks 1, 3, 7, 15... places away before a binary search,
+	/// so it is fast when the answer is close to the hint.
+	/// </summary>
+	/// <param name="value">The value to place.</param>
+	/// <param name="values">The sorted array.</param>
+	/// <param name="count">The number of values in the array.</param>
+	/// <param name="hint">The index to start at.</param>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	/// <returns>The number of values in the array that are ordered before the value.</returns>
+	template <typename Compare>
+	static size_t GallopLeft(const T& value, const T* values, size_t count, size_t hint, Compare& comp)
+	{
+		//Find a range (last, offset] that the answer is in, then binary search it
+		long long last = 0;
+		long long offset = 1;
+		long long hintIndex = (long long)hint;
+		if (comp(values[hint], value))
+		{
+			long long maxOffset = (long long)count - hintIndex;
+			while (offset < maxOffset && comp(values[hintIndex + offset], value))
+			{
+				last = offset;
+				offset = (offset << 1) + 1;
+			}
+			if (offset > maxOffset)
+				offset = maxOffset;
+			last += hintIndex;
+			offset += hintIndex;
+		}
+		else
+		{
+			long long maxOffset = hintIndex + 1;
+			while (offset < maxOffset && !comp(values[hintIndex - offset], value))
+			{
+				last = offset;
+				offset = (offset << 1) + 1;
+			}
+			if (offset > maxOffset)
+				offset = maxOffset;
+			long long temp = last;
+			last = hintIndex - offset;
+			offset = hintIndex - temp;
+		}
+
+		++last;
+		while (last < offset)
+		{
+			long long middle = last + ((offset - last) >> 1);
+			if (comp(values[middle], value))
+				last = middle + 1;
+			else
+				offset = middle;
+		}
+		return (size_t)offset;
+	}
+
+	/// <summary>
+	/// Find where a value belongs in a sorted array, after any equal values.
+	/// Searches the same way as GallopLeft().
+	/// </summary>
+	/// <param name="value">The value to place.</param>
+	/// <param name="values">The sorted array.</param>
+	/// <param name="count">The number of values in the array.</param>
+	/// <param name="hint">The index to start at.</param>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	/// <returns>The number of values in the array that are not ordered after the value.</returns>
+	template <typename Compare>
+	static size_t GallopRight(const T& value, const T* values, size_t count, size_t hint, Compare& comp)
+	{
+		long long last = 0;
+		long long offset = 1;
+		long long hintIndex = (long long)hint;
+		if (comp(value, values[hint]))
+		{
+			long long maxOffset = hintIndex + 1;
+			while (offset < maxOffset && comp(value, values[hintIndex - offset]))
+			{
+				last = offset;
+				offset = (offset << 1) + 1;
+			}
+			if (offset > maxOffset)
+				offset = maxOffset;
+			long long temp = last;
+			last = hintIndex - offset;
+			offset = hintIndex - temp;
+		}
+		else
+		{
+			long long maxOffset = (long long)count - hintIndex;
+			while (offset < maxOffset && !comp(value, values[hintIndex + offset]))
+			{
+				last = offset;
+				offset = (offset << 1) + 1;
+			}
+			if (offset > maxOffset)
+				offset = maxOffset;
+			last += hintIndex;
+			offset += hintIndex;
+		}
+
+		++last;
+		while (last < offset)
+		{
+			long long middle = last + ((offset - last) >> 1);
+			if (comp(value, values[middle]))
+				offset = middle;
+			else
+				last = middle + 1;
+		}
+		return (size_t)offset;
+	}
+
+	/// <summary>
+	/// Move values forwards from one place to another, the ranges may overlap if the destination is first.
+	/// Uses memmove if the type allows it.
+	/// </summary>
+	static void MoveForward(T* destination, T* source, size_t count)
+	{
+		if constexpr (is_trivially_copyable_v<T>)
+		{
+			if (count > 0)
+				memmove(destination, source, sizeof(T) * count);
+		}
+		else
+			for (size_t i = 0; i < count; ++i)
+				destination[i] = move(source[i]);
+	}
+
+	/// <summary>
+	/// Move values backwards from one place to another, the ranges may overlap if the destination is last.
+	/// Uses memmove if the type allows it.
+	/// </summary>
+	static void MoveBackward(T* destination, T* source, size_t count)
+	{
+		if constexpr (is_trivially_copyable_v<T>)
+		{
+			if (count > 0)
+				memmove(destination, source, sizeof(T) * count);
+		}
+		else
+			for (size_t i = count; i > 0; --i)
+				destination[i - 1] = move(source[i - 1]);
+	}
+
+	/// <summary>
+	/// Move values from the list into the merge buffer.
+	/// </summary>
+	/// <param name="buffer">The merge buffer.</param>
+	/// <param name="first">The index of the first value to move.</param>
+	/// <param name="count">The number of values to move.</param>
+	void MoveToBuffer(T* buffer, size_t first, size_t count)
+	{
+		if constexpr (is_trivially_copyable_v<T>)
+			memcpy(buffer, data + first, sizeof(T) * count);
+		else
+			for (size_t i = 0; i < count; ++i)
+				new (buffer + i) T(move(data[first + i]));
+	}
+
+	/// <summary>
+	/// The merge loop of MergeLow(), which stops once B is used up or A has one value left.
+	/// Takes one value at a time until one run wins MIN_GALLOP times in a row,
+	/// then gallops to find whole blocks of values to take at once, until galloping stops paying off.
+	/// The gap between dest and b is always the size of what is left of A, so A can be moved back into it at any point.
+	/// </summary>
+	template <typename Compare>
+	void MergeLowRuns(T*& dest, T*& a, size_t& countA, T*& b, size_t& countB, size_t& minGallop, Compare& comp)
+	{
+		//B's first value is known to go first
+		*dest++ = move(*b++);
+		if (--countB == 0 || countA == 1)
+			return;
+
+		while (true)
+		{
+			size_t winsA = 0;
+			size_t winsB = 0;
+			while (true)
+			{
+				if (comp(*b, *a))
+				{
+					*dest++ = move(*b++);
+					++winsB;
+					winsA = 0;
+					if (--countB == 0)
+						return;
+					if (winsB >= minGallop)
+						break;
+				}
+				else
+				{
+					*dest++ = move(*a++);
+					++winsA;
+					winsB = 0;
+					if (--countA == 1)
+						return;
+					if (winsA >= minGallop)
+						break;
+				}
+			}
+
+			//Gallop until neither run is winning by a long way, making galloping easier to start the more it pays off
+			++minGallop;
+			do
+			{
+				minGallop -= minGallop > 1;
+
+				winsA = GallopRight(*b, a, countA, 0, comp);
+				if (winsA > 0)
+				{
+					MoveForward(dest, a, winsA);
+					dest += winsA;
+					a += winsA;
+					countA -= winsA;
+					if (countA <= 1)
+						return;
+				}
+				*dest++ = move(*b++);
+				if (--countB == 0)
+					return;
+
+				winsB = GallopLeft(*a, b, countB, 0, comp);
+				if (winsB > 0)
+				{
+					MoveForward(dest, b, winsB);
+					dest += winsB;
+					b += winsB;
+					countB -= winsB;
+					if (countB == 0)
+						return;
+				}
+				*dest++ = move(*a++);
+				if (--countA == 1)
+					return;
+			} while (winsA >= MIN_GALLOP || winsB >= MIN_GALLOP);
+			++minGallop;
+		}
+	}
+
+	/// <summary>
+	/// Merge two neighbouring runs where the first run, A, is no longer than the second, B.
+	/// A is moved into the merge buffer and the runs are merged from the front.
+	/// A's first value must come after B's first value, and A's last value must come after B's last value.
+	/// </summary>
+	template <typename Compare>
+	void MergeLow(size_t baseA, size_t lengthA, size_t baseB, size_t lengthB, size_t& minGallop, Compare& comp)
+	{
+		T* buffer = MergeBuffer(lengthA);
+		MoveToBuffer(buffer, baseA, lengthA);
+
+		T* dest = data + baseA;
+		T* a = buffer;
+		T* b = data + baseB;
+		size_t countA = lengthA;
+		size_t countB = lengthB;
+		try
+		{
+			MergeLowRuns(dest, a, countA, b, countB, minGallop, comp);
+		}
+		catch (...)
+		{
+			//Put what is left of A back in the gap so no values are lost
+			MoveForward(dest, a, countA);
+			Destroy(buffer, lengthA);
+			throw;
+		}
+
+		//Either B is used up and the rest of A fills the gap, or A's last value goes after the rest of B
+		if (countA > 0 && countB > 0)
+		{
+			MoveForward(dest, b, countB);
+			dest += countB;
+		}
+		MoveForward(dest, a, countA);
+		Destroy(buffer, lengthA);
+	}
+
+	/// <summary>
+	/// The merge loop of MergeHigh(), which works like MergeLowRuns() from the back, stopping once A is used up or B has one value left.
+	/// The gap between a and dest is always the size of what is left of B.
+	/// </summary>
+	template <typename Compare>
+	void MergeHighRuns(T*& dest, T*& a, size_t& countA, T*& b, size_t& countB, T* bufferStart, T* runA, size_t& minGallop, Compare& comp)
+	{
+		//A's last value is known to go last
+		*dest-- = move(*a--);
+		if (--countA == 0 || countB == 1)
+			return;
+
+		while (true)
+		{
+			size_t winsA = 0;
+			size_t winsB = 0;
+			while (true)
+			{
+				if (comp(*b, *a))
+				{
+					*dest-- = move(*a--);
+					++winsA;
+					winsB = 0;
+					if (--countA == 0)
+						return;
+					if (winsA >= minGallop)
+						break;
+				}
+				else
+				{
+					*dest-- = move(*b--);
+					++winsB;
+					winsA = 0;
+					if (--countB == 1)
+						return;
+					if (winsB >= minGallop)
+						break;
+				}
+			}
+
+			++minGallop;
+			do
+			{
+				minGallop -= minGallop > 1;
+
+				winsA = countA - GallopRight(*b, runA, countA, countA - 1, comp);
+				if (winsA > 0)
+				{
+					dest -= winsA;
+					a -= winsA;
+					MoveBackward(dest + 1, a + 1, winsA);
+					countA -= winsA;
+					if (countA == 0)
+						return;
+				}
+				*dest-- = move(*b--);
+				if (--countB == 1)
+					return;
+
+				winsB = countB - GallopLeft(*a, bufferStart, countB, countB - 1, comp);
+				if (winsB > 0)
+				{
+					dest -= winsB;
+					b -= winsB;
+					MoveBackward(dest + 1, b + 1, winsB);
+					countB -= winsB;
+					if (countB <= 1)
+						return;
+				}
+				*dest-- = move(*a--);
+				if (--countA == 0)
+					return;
+			} while (winsA >= MIN_GALLOP || winsB >= MIN_GALLOP);
+			++minGallop;
+		}
+	}
+
+	/// <summary>
+	/// Merge two neighbouring runs where the second run, B, is shorter than the first, A.
+	/// B is moved into the merge buffer and the runs are merged from the back.
+	/// A's first value must come after B's first value, and A's last value must come after B's last value.
+	/// </summary>
+	template <typename Compare>
+	void MergeHigh(size_t baseA, size_t lengthA, size_t baseB, size_t lengthB, size_t& minGallop, Compare& comp)
+	{
+		T* buffer = MergeBuffer(lengthB);
+		MoveToBuffer(buffer, baseB, lengthB);
+
+		T* dest = data + baseB + lengthB - 1;
+		T* a = data + baseA + lengthA - 1;
+		T* b = buffer + lengthB - 1;
+		size_t countA = lengthA;
+		size_t countB = lengthB;
+		try
+		{
+			MergeHighRuns(dest, a, countA, b, countB, buffer, data + baseA, minGallop, comp);
+		}
+		catch (...)
+		{
+			//Put what is left of B back in the gap so no values are lost
+			MoveForward(dest + 1 - countB, buffer, countB);
+			Destroy(buffer, lengthB);
+			throw;
+		}
+
+		//Either A is used up and the rest of B fills the gap, or B's first value goes before the rest of A
+		if (countA > 0 && countB > 0)
+		{
+			dest -= countA;
+			a -= countA;
+			MoveBackward(dest + 1, a + 1, countA);
+		}
+		MoveForward(dest + 1 - countB, buffer, countB);
+		Destroy(buffer, lengthB);
+	}
+
+	/// <summary>
+	/// Merge the run at a position on the run stack with the run after it.
+	/// Values at the start of the first run and the end of the second that are already in place are skipped.
+	/// </summary>
+	/// <param name="runBase">The start of each run on the stack.</param>
+	/// <param name="runLength">The length of each run on the stack.</param>
+	/// <param name="runCount">The number of runs on the stack.</param>
+	/// <param name="i">The position of the first run to merge, either the second or third from the top of the stack.</param>
+	template <typename Compare>
+	void MergeAt(size_t* runBase, size_t* runLength, size_t& runCount, size_t i, size_t& minGallop, Compare& comp)
+	{
+		size_t baseA = runBase[i];
+		size_t lengthA = runLength[i];
+		size_t baseB = runBase[i + 1];
+		size_t lengthB = runLength[i + 1];
+
+		runLength[i] = lengthA + lengthB;
+		if (i + 3 == runCount)
+		{
+			runBase[i + 1] = runBase[i + 2];
+			runLength[i + 1] = runLength[i + 2];
+		}
+		--runCount;
+
+		size_t skip = GallopRight(data[baseB], data + baseA, lengthA, 0, comp);
+		baseA += skip;
+		lengthA -= skip;
+		if (lengthA == 0)
+			return;
+
+		lengthB = GallopLeft(data[baseA + lengthA - 1], data + baseB, lengthB, lengthB - 1, comp);
+		if (lengthB == 0)
+			return;
+
+		if (lengthA <= lengthB)
+			MergeLow(baseA, lengthA, baseB, lengthB, minGallop, comp);
+		else
+			MergeHigh(baseA, lengthA, baseB, lengthB, minGallop, comp);
+	}
+
+	/// <summary>
+	/// The unsigned integer type with the same size as an arithmetic type.
+	/// Used to sort arithmetic values by their bits.
+	/// </summary>
+	template <typename Key>
+	using RadixBits = conditional_t<sizeof(Key) == 1, uint8_t,
+		conditional_t<sizeof(Key) == 2, uint16_t,
+		conditional_t<sizeof(Key) == 4, uint32_t, uint64_t>>>;
+
+	/// <summary>
+	/// A radix sort key and the index of the value it came from.
+	/// </summary>
+	template <typename Bits>
+	struct RadixEntry
+	{
+		Bits key;
+		size_t index;
+	};
+
+	/// <summary>
+	/// Convert an arithmetic value into unsigned bits that sort in the same order as the value.
+	/// Signed integers have their sign bit flipped so negative values come first.
+	/// Negative floats have all their bits flipped so larger magnitudes come first, positive floats have their sign bit set.
+	/// </summary>
+	/// <param name="key">The value to convert.</param>
+	/// <returns>The sortable bits.</returns>
+	template <typename Key>
+	static RadixBits<Key> EncodeRadixKey(Key key)
+	{
+		typedef RadixBits<Key> Bits;
+		const Bits signBit = (Bits)((Bits)1 << (sizeof(Key) * 8 - 1));
+
+		Bits bits;
+		memcpy(&bits, &key, sizeof(Key));
+		if constexpr (is_floating_point_v<Key>)
+			return (bits & signBit) ? (Bits)~bits : (Bits)(bits | signBit);
+		else if constexpr (is_signed_v<Key>)
+			return (Bits)(bits ^ signBit);
+		else
+			return bits;
+	}
+
+	/// <summary>
+	/// Convert bits made by EncodeRadixKey() back into the original value.
+	/// </summary>
+	/// <param name="bits">The sortable bits.</param>
+	/// <returns>The original value.</returns>
+	template <typename Key>
+	static Key DecodeRadixKey(RadixBits<Key> bits)
+	{
+		typedef RadixBits<Key> Bits;
+		const Bits signBit = (Bits)((Bits)1 << (sizeof(Key) * 8 - 1));
+
+		if constexpr (is_floating_point_v<Key>)
+			bits = (bits & signBit) ? (Bits)(bits & ~signBit) : (Bits)~bits;
+		else if constexpr (is_signed_v<Key>)
+			bits = (Bits)(bits ^ signBit);
+
+		Key key;
+		memcpy(&key, &bits, sizeof(Key));
+		return key;
+	}
+
+	/// <summary>
+	/// Get the unsigned bits that a radix sort orders an item by.
+	/// </summary>
+	template <typename Bits>
+	static Bits RadixKeyOf(Bits item)
+	{
+		return item;
+	}
+
+	/// <summary>
+	/// Get the unsigned bits that a radix sort orders an item by.
+	/// </summary>
+	template <typename Bits>
+	static Bits RadixKeyOf(const RadixEntry<Bits>& item)
+	{
+		return item.key;
+	}
+
+	/// <summary>
+	/// Perform a least significant digit radix sort on an array of keys, one byte at a time.
+	/// The sort is stable and the sorted items always end up back in the original array.
+	/// </summary>
+	/// <param name="items">The items to sort. Either unsigned integers or radix entries.</param>
+	/// <param name="scratch">A buffer the same size as the items.</param>
+	/// <param name="count">The number of items.</param>
+	template <typename Bits, typename Item>
+	static void RadixSortItems(Item* items, Item* scratch, size_t count)
+	{
+		const size_t DIGITS = sizeof(Bits);
+
+		//Count how many times each value of each digit appears in a single pass
+		size_t* histograms = new size_t[DIGITS * 256]();
+		for (size_t i = 0; i < count; ++i)
+		{
+			Bits key = RadixKeyOf(items[i]);
+			for (size_t digit = 0; digit < DIGITS; ++digit)
+				++histograms[digit * 256 + ((key >> (digit * 8)) & 0xFF)];
+		}
+
+		Item* source = items;
+		Item* destination = scratch;
+		for (size_t digit = 0; digit < DIGITS; ++digit)
+		{
+			size_t* histogram = histograms + digit * 256;
+
+			//Skip this digit if every key has the same value for it
+			if (histogram[(RadixKeyOf(source[0]) >> (digit * 8)) & 0xFF] == count)
+				continue;
+
+			//Turn the counts into the starting position of each bucket
+			size_t total = 0;
+			for (size_t bucket = 0; bucket < 256; ++bucket)
+			{
+				size_t bucketCount = histogram[bucket];
+				histogram[bucket] = total;
+				total += bucketCount;
+			}
+
+			//Scatter the items into their buckets
+			for (size_t i = 0; i < count; ++i)
+				destination[histogram[(RadixKeyOf(source[i]) >> (digit * 8)) & 0xFF]++] = source[i];
+
+			Item* temp = source;
+			source = destination;
+			destination = temp;
+		}
+		delete[] histograms;
+
+		if (source != items)
+			memcpy(items, source, sizeof(Item) * count);
+	}
+
+	/// <summary>
+	/// Rearrange the list so that position i holds the value that was at index order[i].
+	/// Follows each cycle of the permutation so every value is moved once.
+	/// The order is used to keep track of finished positions, so it is modified.
+	/// </summary>
+	/// <param name="order">The index of the value that should end up at each position.</param>
+	void ApplyPermutation(size_t* order)
+	{
+		for (size_t i = 0; i < size; ++i)
+		{
+			if (order[i] == i)
+				continue;
+
+			//Move each value in the cycle into place, then put the first value at the end of the cycle
+			T temp = move(data[i]);
+			size_t current = i;
+			while (order[current] != i)
+			{
+				size_t next = order[current];
+				data[current] = move(data[next]);
+				order[current] = current;
+				current = next;
+			}
+			data[current] = move(temp);
+			order[current] = current;
+		}
+	}
+
+	/// <summary>
+	/// A key taken from a value and the index of the value, for sorting by keys that aren't numbers.
+	/// </summary>
+	template <typename Key>
+	struct KeyedIndex
+	{
+		Key key;
+		size_t index;
+	};
+
+	/// <summary>
+	/// Work out the order that sorts the list by a key taken from each value, without moving any values.
+	/// Numeric keys are radix sorted. Other keys are introsorted with the index breaking ties. Both are stable.
+	/// </summary>
+	/// <param name="key">Returns the key of a value.</param>
+	/// <param name="order">Receives the index of the value that belongs at each position.</param>
+	template <typename KeyFn>
+	void SortOrder(KeyFn& key, size_t* order) const
+	{
+		typedef decay_t<decltype(key(declval<const T&>()))> Key;
+		if constexpr (is_arithmetic_v<Key> && sizeof(Key) <= 8)
+		{
+			typedef RadixBits<Key> Bits;
+			RadixEntry<Bits>* entries = new RadixEntry<Bits>[size];
+			RadixEntry<Bits>* scratch = new RadixEntry<Bits>[size];
+			for (size_t i = 0; i < size; ++i)
+			{
+				Key value = key(data[i]);
+				if constexpr (is_floating_point_v<Key>)
+					if (value == 0)
+						value = 0;	//Zeros of both signs are equal keys, so give them the same bits to keep them in order
+				entries[i] = { EncodeRadixKey<Key>(value), i };
+			}
+
+			RadixSortItems<Bits>(entries, scratch, size);
+			delete[] scratch;
+
+			for (size_t i = 0; i < size; ++i)
+				order[i] = entries[i].index;
+			delete[] entries;
+		}
+		else
+		{
+			List<KeyedIndex<Key>> entries(size);
+			for (size_t i = 0; i < size; ++i)
+				entries.Push({ key(data[i]), i });
+
+			entries.IntroSort([](const KeyedIndex<Key>& a, const KeyedIndex<Key>& b)
+			{
+				return a.key < b.key || (!(b.key < a.key) && a.index < b.index);
+			});
+
+			for (size_t i = 0; i < size; ++i)
+				order[i] = entries[i].index;
+		}
+	}
+
+	/// <summary>
+	/// Whether a sorted list of numbers looks evenly spread enough for an interpolation search to beat a binary search.
+	/// Compares the quartiles with where an even spread between the first and last values would put them,
+	/// so it costs three reads rather than a pass over the list.
+	/// </summary>
+	/// <returns>True if each quartile is within the policy's tolerance of an even spread.</returns>
+	bool EvenlySpread() const
+	{
+		double first = (double)data[0];
+		double span = (double)data[size - 1] - first;
+		if (!(span > 0) || span == numeric_limits<double>::infinity())
+			return false;
+
+		for (size_t quarter = 1; quarter < 4; ++quarter)
+		{
+			double expected = first + span * quarter / 4;
+			double actual = (double)data[(size - 1) * quarter / 4];
+			if (!(fabs(actual - expected) <= span * Policy::INTERPOLATION_SPREAD_TOLERANCE))
+				return false;
+		}
+		return true;
+	}
+
+protected:
+	/// <summary>
+	/// Constructor for a small list.
+	/// The list starts out in storage inside the small list and only allocates once it outgrows it.
+	/// </summary>
+	/// <param name="buffer">The inline storage. It must outlive the list's elements.</param>
+	/// <param name="bufferCapacity">The number of elements that fit in the inline storage.</param>
+	List(T* buffer, size_t bufferCapacity)
+	{
+		capacity = bufferCapacity;
+		size = 0;
+		growthFactor = Policy::GROWTH_FACTOR;
+		inlineData = buffer;
+		inlineCapacity = bufferCapacity;
+		knownSorted = false;
+		mergeBuffer = nullptr;
+		mergeBufferSize = 0;
+		data = buffer;
+	}
+
+	/// <summary>
+	/// Destroy the elements and free the storage, leaving the list with no storage at all.
+	/// Lets a small list clean up before its inline storage goes away.
+	/// </summary>
+	void Release()
+	{
+		Destroy(data, size);
+		FreeData();
+		data = nullptr;
+		size = 0;
+		capacity = 0;
+		inlineData = nullptr;
+		inlineCapacity = 0;
+		FreeMergeBuffer();
+	}
+
+	/// <summary>
+	/// Point the list at inline storage that lives outside the list object, taking the elements already in it.
+	/// Lets a mapped list use its file as the list's storage, and follow the file when the mapping moves.
+	/// The list must not be using heap storage.
+	/// </summary>
+	/// <param name="buffer">The storage. It must outlive the list's elements.</param>
+	/// <param name="bufferCapacity">The number of elements that fit in the storage.</param>
+	/// <param name="count">The number of elements already in the storage.</param>
+	/// <param name="sorted">Whether the elements are known to be in ascending order.</param>
+	void AdoptStorage(T* buffer, size_t bufferCapacity, size_t count, bool sorted)
+	{
+		data = buffer;
+		inlineData = buffer;
+		capacity = bufferCapacity;
+		inlineCapacity = bufferCapacity;
+		size = count;
+		knownSorted = sorted;
+	}
+
+public:
+	/// <summary>
+	/// Default constructor.
+	/// Has the initial capacity of the policy (5 by default).
+	/// </summary>
+	List()
+	{
+		capacity = Policy::INITIAL_CAPACITY;
+		size = 0;
+		growthFactor = Policy::GROWTH_FACTOR;
+		inlineData = nullptr;
+		inlineCapacity = 0;
+		knownSorted = false;
+		mergeBuffer = nullptr;
+		mergeBufferSize = 0;
+		data = Allocate(capacity);
+	}
+	
+	/// <summary>
+	/// Overloaded constructor.
+	/// </summary>
+	/// <param name="_capacity">The initial capacity of this list.</param>
+	List(size_t _capacity)
+	{
+		if (_capacity == 0)
+			capacity = 1;
+		else
+			capacity = _capacity;
+		size = 0;
+		growthFactor = Policy::GROWTH_FACTOR;
+		inlineData = nullptr;
+		inlineCapacity = 0;
+		knownSorted = false;
+		mergeBuffer = nullptr;
+		mergeBufferSize = 0;
+		data = Allocate(capacity);
+	}
+	
+	/// <summary>
+	/// Copy constructor.
+	/// Copies the data from the copy to this list.
+	/// </summary>
+	/// <param name="copy">The copy.</param>
+	List(const List& copy)
+	{
+		capacity = copy.capacity;
+		size = copy.size;
+		growthFactor = copy.growthFactor;
+		inlineData = nullptr;
+		inlineCapacity = 0;
+		knownSorted = copy.knownSorted;
+		mergeBuffer = nullptr;
+		mergeBufferSize = 0;
+		data = Allocate(capacity);
+		try
+		{
+			CopyConstruct(data, copy.data, size);
+		}
+		catch (...)
+		{
+			Deallocate(data);
+			throw;
+		}
+	}
+
+	/// <summary>
+	/// Move constructor.
+	/// Takes the data from the other list, leaving it empty.
+	/// If the other list is a small list using its inline storage then its elements are moved to the heap instead.
+	/// </summary>
+	/// <param name="other">The list to move from.</param>
+	List(List&& other) noexcept
+	{
+		data = nullptr;
+		size = 0;
+		capacity = 0;
+		inlineData = nullptr;
+		inlineCapacity = 0;
+		knownSorted = false;
+		mergeBuffer = nullptr;
+		mergeBufferSize = 0;
+		TakeData(other);
+	}
+
+	/// <summary>
+	/// Deconstructor.
+	/// </summary>
+	~List()
+	{
+		Destroy(data, size);
+		FreeData();
+		Deallocate(mergeBuffer);
+	}
+
+	/// <summary>
+	/// Ensure the list has room for at least a certain number of elements.
+	/// Does nothing if the capacity is already large enough.
+	/// </summary>
+	/// <param name="newCapacity">The minimum capacity the list should have.</param>
+	void Reserve(size_t newCapacity)
+	{
+		if (newCapacity <= capacity)
+			return;
+		if (newCapacity > MaxCapacity())
+			throw length_error("Capacity exceeds the maximum capacity of the list.");
+
+		Reallocate(newCapacity);
+	}
+
+	/// <summary>
+	/// Decrease the capacity of the list by a certain amount.
+	/// </summary>
+	/// <param name="amount">The amount to decrease the capacity by.</param>
+	void Discard(size_t amount)
+	{
+		//If the reduced capacity would be below or equal to zero, empty the list and set the capacity to 1
+		if (amount >= capacity)
+		{
+			Destroy(data, size);
+			size = 0;
+			Reallocate(1);
+		}
+		else
+			Reallocate(capacity - amount);
+	}
+
+	/// <summary>
+	/// Push a new value to the list.
+	/// If it will not fit then grow the capacity by the growth factor.
+	/// </summary>
+	/// <param name="value">The value to push to the list.</param>
+	void Push(const T& value)
+	{
+		EmplaceBack(value);
+	}
+
+	/// <summary>
+	/// Push a new value to the list by moving it.
+	/// If it will not fit then grow the capacity by the growth factor.
+	/// </summary>
+	/// <param name="value">The value to move into the list.</param>
+	void Push(T&& value)
+	{
+		EmplaceBack(move(value));
+	}
+
+	/// <summary>
+	/// Construct a new value in place at the end of the list.
+	/// If it will not fit then grow the capacity by the growth factor.
+	/// </summary>
+	/// <param name="args">The arguments to pass to the value's constructor.</param>
+	/// <returns>The new value.</returns>
+	template <typename... Args>
+	T& EmplaceBack(Args&&... args)
+	{
+		knownSorted = false;
+		if (size == capacity)		//If there is no more capacity then grow the capacity
+		{
+			size_t newCapacity = NextCapacity();
+			T* newData = Allocate(newCapacity);
+
+			//Construct the new value before moving the old ones in case the arguments refer to an element of this list
+			try
+			{
+				new (newData + size) T(forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				Deallocate(newData);
+				throw;
+			}
+			Relocate(newData, data, size);
+			FreeData();
+			data = newData;
+			capacity = newCapacity;
+		}
+		else
+			new (data + size) T(forward<Args>(args)...);
+		return data[size++];
+	}
+
+	/// <summary>
+	/// Construct a new value at a specified index in the list.
+	/// Values after the index are moved up by one position.
+	/// </summary>
+	/// <param name="index">The index to insert at.</param>
+	/// <param name="args">The arguments to pass to the value's constructor.</param>
+	template <typename... Args>
+	void Emplace(size_t index, Args&&... args)
+	{
+		//If an invalid index, return
+		if (index > size)
+			return;
+		//If the index is the size, push to the back (handles if the size is 0)
+		else if (index == size)
+			EmplaceBack(forward<Args>(args)...);
+		else
+		{
+			//Build the value first as the arguments might refer to an element that is about to move
+			T value(forward<Args>(args)...);
+
+			//Move the last value into a new slot, then move the others up one position
+			EmplaceBack(move(data[size - 1]));
+			for (size_t i = size - 2; i != index; --i)
+				data[i] = move(data[i - 1]);
+			data[index] = move(value);
+		}
+	}
+
+	/// <summary>
+	/// Insert a value at a specified index in the list.
+	/// </summary>
+	/// <param name="index">The index to insert at.</param>
+	/// <param name="value">The value to insert.</param>
+	void Insert(size_t index, const T& value)
+	{
+		Emplace(index, value);
+	}
+
+	/// <summary>
+	/// Insert a value at a specified index in the list by moving it.
+	/// </summary>
+	/// <param name="index">The index to insert at.</param>
+	/// <param name="value">The value to move into the list.</param>
+	void Insert(size_t index, T&& value)
+	{
+		Emplace(index, move(value));
+	}
+	
+	/// <summary>
+	/// Insert another list at a specific index in this list.
+	/// </summary>
+	/// <param name="index">The index to insert the list.</param>
+	/// <param name="values">The list.</param>
+	void Insert(size_t index, const List& values)
+	{
+		Insert(index, values.data, values.size);
+	}
+
+	/// <summary>
+	/// Insert an array of values at a specific index in this list.
+	/// The list grows at most once and the values after the index are moved once, so this is O(n + count).
+	/// </summary>
+	/// <param name="index">The index to insert the values.</param>
+	/// <param name="values">The values to insert.</param>
+	/// <param name="count">The number of values to insert.</param>
+	void Insert(size_t index, const T* values, size_t count)
+	{
+		if (index > size || count == 0)
+			return;
+		knownSorted = false;
+
+		//If the values are part of this list, copy them first as they are about to move
+		if (values >= data && values < data + size)
+		{
+			List copy(count);
+			copy.CopyConstruct(copy.data, values, count);
+			copy.size = count;
+			Insert(index, copy.data, count);
+			return;
+		}
+
+		if (size + count > capacity)
+		{
+			//Build the new array in one go: the front, then the new values, then the back
+			size_t newCapacity = NextCapacity();
+			if (newCapacity < size + count)
+				newCapacity = size + count;
+			T* newData = Allocate(newCapacity);
+			try
+			{
+				CopyConstruct(newData + index, values, count);
+			}
+			catch (...)
+			{
+				Deallocate(newData);
+				throw;
+			}
+			Relocate(newData, data, index);
+			Relocate(newData + index + count, data + index, size - index);
+			FreeData();
+			data = newData;
+			capacity = newCapacity;
+		}
+		else if constexpr (is_trivially_copyable_v<T>)
+		{
+			//Slide the back of the list up and copy the new values into the gap
+			memmove(data + index + count, data + index, sizeof(T) * (size - index));
+			memcpy(data + index, values, sizeof(T) * count);
+		}
+		else
+		{
+			//Slide the back of the list up, starting from the end
+			//Slots past the current size are uninitialised so they are constructed rather than assigned
+			for (size_t i = size; i > index; --i)
+			{
+				size_t to = i - 1 + count;
+				if (to >= size)
+					new (data + to) T(move(data[i - 1]));
+				else
+					data[to] = move(data[i - 1]);
+			}
+
+			//Copy the new values into the gap
+			for (size_t i = 0; i < count; ++i)
+			{
+				size_t to = index + i;
+				if (to >= size)
+					new (data + to) T(values[i]);
+				else
+					data[to] = values[i];
+			}
+		}
+		size += count;
+	}
+
+	/// <summary>
+	/// Pop the element off the end of the list.
+	/// </summary>
+	void Pop()
+	{
+		if (size > 0)
+			ReduceSize(1);
+	}
+
+	/// <summary>
+	/// Remove the value at a specific index from the list.
+	/// This will remove any order from the list.
+	/// To preserve order, RemoveKeepOrder() should be used.
+	/// </summary>
+	/// <param name="index">The index of the value to be removed.</param>
+	void Remove(size_t index)
+	{
+		if (size > 0 && index < size)
+		{
+			if (size == 1 || index == (size - 1))
+				Pop();
+			else
+			{
+				data[index] = move(data[size - 1]);
 				ReduceSize(1);
+				knownSorted = false;
+			}
+		}
+	}
+	
+	/// <summary>
+	/// Remove all occurences of a value from the list.
+	/// This will remove any orderfrom the list.
+	/// To preserve order, RemoveKeepOrder() should be used.
+	/// </summary>
+	/// <param name="value">The value to remove from the array.</param>
+	void Remove(T& value)
+	{
+		//Jump straight to each match with a vectorised scan
+		//The last value is moved into the removed value's place, so check the same index again
+		size_t i = SimdKernels::FindFirst(data, size, value);
+		while (i < size)
+		{
+			Remove(i);
+			i += SimdKernels::FindFirst(data + i, size - i, value);
+		}
+	}
+
+	/// <summary>
+	/// Remove the value at a specific index from the list.
+	/// This will keep any order in the list.
+	/// </summary>
+	/// <param name="index">The index of the value to be removed.</param>
+	void RemoveKeepOrder(size_t index)
+	{
+		if (size == 0)
+			return;
+		else if (index == (size - 1) || size == 1)
+			Pop();
+		else
+		{
+			//Move each value past the given index back by one position
+			for (size_t i = index; i < size - 1; ++i)
+				data[i] = move(data[i + 1]);
+			
+			//Reduce the size
+			ReduceSize(1);
+		}
+	}
+
+	/// <summary>
+	/// Remove all occurences of a specific value from the list.
+	/// This will keep any order in the list.
+	/// </summary>
+	/// <param name="value">Value to remove.</param>
+	void RemoveKeepOrder(T& value)
+	{
+		RemoveAll(value);
+	}
+
+	/// <summary>
+	/// Remove all values that match a condition in a single pass.
+	/// The remaining values are moved down to fill the gaps, so this keeps any order in the list.
+	/// </summary>
+	/// <param name="pred">Returns true if a value should be removed.</param>
+	/// <returns>The number of values removed.</returns>
+	template <typename Predicate>
+	size_t RemoveIf(Predicate pred)
+	{
+		//Skip past the values that are staying where they are
+		size_t write = 0;
+		while (write < size && !pred(data[write]))
+			++write;
+		return Compact(write, pred);
+	}
+
+	/// <summary>
+	/// Remove all occurences of a specific value in a single pass.
+	/// This will keep any order in the list.
+	/// </summary>
+	/// <param name="value">Value to remove.</param>
+	/// <returns>The number of values removed.</returns>
+	size_t RemoveAll(const T& value)
+	{
+		//Copy the value in case it is one of the values being removed
+		const T target = value;
+
+		//Jump straight to the first match with a vectorised scan
+		size_t write = SimdKernels::FindFirst(data, size, target);
+		auto matches = [&target](const T& item) { return item == target; };
+		return Compact(write, matches);
+	}
+
+	/// <summary>
+	/// Clear the list.
+	/// Frees the memory as well, unless the policy keeps it.
+	/// </summary>
+	void Clear()
+	{
+		Destroy(data, size);
+		size = 0;
+		if constexpr (!Policy::KEEP_ON_CLEAR)
+		{
+			Reallocate(1);
+			FreeMergeBuffer();
+		}
+	}
+
+	/// <summary>
+	/// Free any capacity that isn't being used, including the memory kept for the tim sort.
+	/// </summary>
+	void ShrinkToFit()
+	{
+		size_t newCapacity = size > 0 ? size : 1;
+		if (capacity != newCapacity)
+			Reallocate(newCapacity);
+		FreeMergeBuffer();
+	}
+
+	/// <summary>
+	/// Perform a recursive quick sort of the list.
+	/// </summary>
+	void QuickSort()
+	{
+		QuickSort(0, (long long)size - 1);
+		knownSorted = true;
+	}
+
+	/// <summary>
+	/// Sort the list using an optimised cocktail shaker sort algorithm.
+	/// </summary>
+	void CocktailShakerSort()
+	{
+		if (size < 2)
+			return;
+
+		size_t passes = 0;	//Keep track of the number of times the list has been traversed to reduce the next traversal
+		bool sorted = false;
+		
+		//Sort the list by traversing it and swapping values
+		while (!sorted)
+		{
+			sorted = true;
+
+			//Traverse forwards through the list
+			for (size_t i = 0; i < size - (passes + 1); ++i)
+			{
+				if (data[i] > data[i + 1])
+				{
+					Swap(&data[i], &data[i + 1]);
+					sorted = false;
+				}
+			}
+
+			//Traverse backwards through the list
+			for (size_t i = size - 1; i > 0; --i)
+			{
+				if (data[i - 1] > data[i])
+				{
+					Swap(&data[i], &data[i - 1]);
+					sorted = false;
+				}
+			}
+
+			++passes;
+		}
+		knownSorted = true;
+	}
+
+	/// <summary>
+	/// Perform an insertion sort on the list.
+	/// https://www.geeksforgeeks.org/insertion-sort/
+	/// </summary>
+	void InsertionSort()
+	{
+		long long j;
+		for (size_t i = 1; i < size; ++i)
+		{
+			T key = move(data[i]);
+			j = i - 1;
+
+			while (j >= 0 && data[j] > key)
+			{
+				data[j + 1] = move(data[j]);
+				j = j - 1;
+			}
+			data[j + 1] = move(key);
+		}
+		knownSorted = true;
+	}
+
+	/// <summary>
+	/// Perform a heap sort on the list.
+	/// https://www.geeksforgeeks.org/heap-sort/
+	/// </summary>
+	void HeapSort()
+	{
+		less<T> comp;
+		HeapSort(0, size, comp);
+		knownSorted = true;
+	}
+
+	/// <summary>
+	/// Sort the list using an introsort.
+	/// This is the recommended sort as it is O(n log n) for any input, including already sorted lists and lists full of duplicates.
+	/// </summary>
+	void IntroSort()
+	{
+		IntroSort(less<T>());
+	}
+
+	/// <summary>
+	/// Sort the list using an introsort with a custom ordering.
+	/// </summary>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	template <typename Compare>
+	void IntroSort(Compare comp)
+	{
+		knownSorted = false;
+		if (size < 2)
+			return;
+
+		IntroSort(0, size, DepthLimit(size), true, comp);
+		knownSorted = IsAscending<Compare>();
+	}
+
+	/// <summary>
+	/// Sort the list using a tim sort, a stable merge sort that takes advantage of any order already in the list.
+	/// The list is split into runs that are already sorted (short runs are extended with a binary insertion sort),
+	/// then the runs are merged, galloping through long stretches that come from one run.
+	/// Sorted, reversed and nearly sorted lists take close to O(n), and any list takes at most O(n log n).
+	/// Well suited to lists that are re-sorted every frame after small changes.
+	/// The merge memory is kept between sorts, ShrinkToFit() frees it.
+	/// </summary>
+	void TimSort()
+	{
+		TimSort(less<T>());
+	}
+
+	/// <summary>
+	/// Sort the list using a tim sort with a custom ordering.
+	/// </summary>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	template <typename Compare>
+	void TimSort(Compare comp)
+	{
+		knownSorted = false;
+		if (size < 2)
+			return;
+
+		size_t runBase[MAX_RUNS];
+		size_t runLength[MAX_RUNS];
+		size_t runCount = 0;
+		size_t minGallop = MIN_GALLOP;
+		size_t minRun = MinRunLength(size);
+
+		for (size_t low = 0; low < size;)
+		{
+			//Find the next run, extending it to the minimum length if it is short
+			size_t length = CountRun(low, size, comp);
+			if (length < minRun)
+			{
+				size_t forced = (size - low < minRun) ? size - low : minRun;
+				BinaryInsertionSort(low, low + forced, low + length, comp);
+				length = forced;
+			}
+
+			runBase[runCount] = low;
+			runLength[runCount] = length;
+			++runCount;
+			low += length;
+
+			//Merge runs until the lengths on the stack shrink faster than the Fibonacci numbers, which keeps the merges balanced
+			while (runCount > 1)
+			{
+				size_t n = runCount - 2;
+				if ((n > 0 && runLength[n - 1] <= runLength[n] + runLength[n + 1]) ||
+					(n > 1 && runLength[n - 2] <= runLength[n - 1] + runLength[n]))
+				{
+					if (runLength[n - 1] < runLength[n + 1])
+						--n;
+				}
+				else if (runLength[n] > runLength[n + 1])
+					break;
+				MergeAt(runBase, runLength, runCount, n, minGallop, comp);
 			}
 		}
+
+		//Merge the remaining runs
+		while (runCount > 1)
+		{
+			size_t n = runCount - 2;
+			if (n > 0 && runLength[n - 1] < runLength[n + 1])
+				--n;
+			MergeAt(runBase, runLength, runCount, n, minGallop, comp);
+		}
+
+		knownSorted = IsAscending<Compare>();
+	}
+
+	/// <summary>
+	/// Sort the list on multiple threads.
+	/// The list is split into one block per thread and each block is introsorted on its own thread,
+	/// then the sorted blocks are merged in pairs until one is left, with every thread taking an equal share of each round of merges.
+	/// The values end in the same order as IntroSort() would leave them, except that values that compare equal may end in a different order,
+	/// as neither sort is stable.
+	/// </summary>
+	/// <param name="threads">The number of threads to use. 0 uses one thread per hardware core.</param>
+	void ParallelSort(unsigned int threads = 0)
+	{
+		ParallelSort(threads, less<T>());
+	}
+
+	/// <summary>
+	/// Sort the list on multiple threads with a custom ordering.
+	/// The same threads are used for the block sorts and every round of merges.
+	/// The comparison function is called from several threads at the same time, and neither it nor the values' moves may throw.
+	/// Equivalent values may end in a different order to IntroSort(comp).
+	/// </summary>
+	/// <param name="threads">The number of threads to use. 0 uses one thread per hardware core.</param>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	template <typename Compare>
+	void ParallelSort(unsigned int threads, Compare comp)
+	{
+		knownSorted = false;
+
+		//Don't split the list into blocks that are too small to be worth a thread
+		size_t blocks = BlockCount(threads, PARALLEL_SORT_MIN_BLOCK);
+		if (blocks < 2)
+		{
+			IntroSort(comp);
+			return;
+		}
+
+		//Find where each block starts, the last entry is the end of the list
+		List<size_t> bounds(blocks + 1);
+		for (size_t i = 0; i <= blocks; ++i)
+			bounds.Push(size * i / blocks);
+
+		//Each worker sorts its block, then the blocks are merged in pairs back and forth between the list and a scratch buffer until one is left.
+		//Every value of the scratch buffer is constructed by the first round and destroyed once all the workers are done
+		T* scratch = Allocate(size);
+		try
+		{
+			RunWorkers(blocks, [this, &bounds, &comp, scratch, blocks](size_t worker, ThreadBarrier& barrier)
+			{
+				Compare workerComp = comp;
+				IntroSort(bounds[worker], bounds[worker + 1], DepthLimit(bounds[worker + 1] - bounds[worker]), true, workerComp);
+
+				//Each worker writes the same slice of the output in every round, so only the rounds need to wait for each other
+				size_t start = bounds[worker];
+				size_t end = bounds[worker + 1];
+				T* source = data;
+				T* destination = scratch;
+				for (size_t width = 1; width < blocks; width *= 2)
+				{
+					barrier.Wait();
+					MergeSlice(source, destination, bounds, width, start, end, width == 1, barrier, workerComp);
+					swap(source, destination);
+				}
+
+				//Move the values back into the list if the last round merged into the scratch buffer
+				if (source == scratch)
+				{
+					barrier.Wait();
+					for (size_t i = start; i < end; ++i)
+						data[i] = move(scratch[i]);
+				}
+			});
+		}
+		catch (...)
+		{
+			Deallocate(scratch);
+			throw;
+		}
+		Destroy(scratch, size);
+		Deallocate(scratch);
+
+		knownSorted = IsAscending<Compare>();
 	}
-	
+
 	/// <summary>
-	/// Remove all occurences of a value from the list.
-	/// This will remove any orderfrom the list.
-	/// To preserve order, RemoveKeepOrder() should be used.
+	/// Sort a list of numbers with a least significant digit radix sort.
+	/// Sorts one byte at a time using counting, so it is O(n) and much faster than the comparison sorts for large lists.
+	/// Only available for arithmetic types. Uses extra memory for two copies of the list.
 	/// </summary>
-	/// <param name="value">The value to remove from the array.</param>
-	void Remove(T& value)
+	template <typename U = T, typename = enable_if_t<is_arithmetic_v<U> && sizeof(U) <= 8>>
+	void RadixSort()
 	{
-		for (unsigned int i = 0; i < size; ++i)
-			if (data[i] == value)
-			{
-				Remove(i);
-				--i;
-			}
+		typedef RadixBits<T> Bits;
+		if (size < 2)
+			return;
+
+		Bits* keys = new Bits[size];
+		Bits* scratch = new Bits[size];
+		for (size_t i = 0; i < size; ++i)
+			keys[i] = EncodeRadixKey(data[i]);
+
+		RadixSortItems<Bits>(keys, scratch, size);
+
+		for (size_t i = 0; i < size; ++i)
+			data[i] = DecodeRadixKey<T>(keys[i]);
+		delete[] keys;
+		delete[] scratch;
+		knownSorted = true;
 	}
 
 	/// <summary>
-	/// Remove the value at a specific index from the list.
-	/// This will keep any order in the list.
+	/// Sort the list by a number taken from each value, using a least significant digit radix sort.
+	/// The keys and the original positions are sorted together, then each value is moved to its new position once.
+	/// The sort is stable, so values with equal keys stay in the same order.
 	/// </summary>
-	/// <param name="index">The index of the value to be removed.</param>
-	void RemoveKeepOrder(unsigned int index)
+	/// <param name="key">Returns the arithmetic key of a value, e.g. [](const Pair& p) { return p.key; }</param>
+	template <typename KeyFn>
+	void RadixSort(KeyFn key)
 	{
-		if (size == 0)
-			return;
-		else if (index == (size - 1) || size == 1)
-			Pop();
-		else
-		{
-			//Move each value past the given index back by one position
-			for (unsigned int i = index; i < size - 1; ++i)
-				data[i] = data[i + 1];
-			
-			//Reduce the size
-			ReduceSize(1);
-		}
+		typedef decay_t<decltype(key(declval<const T&>()))> Key;
+		static_assert(is_arithmetic_v<Key> && sizeof(Key) <= 8, "The radix sort key must be an arithmetic type.");
+		SortBy(key);
 	}
 
 	/// <summary>
-	/// Remove all occurences of a specific value from the list.
-	/// This will keep any order in the list.
+	/// Sort the list by a key taken from each value.
+	/// The keys are copied into a compact array and sorted along with the original positions,
+	/// then each value is moved to its new position once, so large values are never swapped.
+	/// Numeric keys use a radix sort, other keys use an introsort. The sort is stable, so values with equal keys stay in the same order.
 	/// </summary>
-	/// <param name="value">Value to remove.</param>
-	void RemoveKeepOrder(T& value)
+	/// <param name="key">Returns the key of a value, e.g. [](const Sprite& s) { return s.depth; }</param>
+	template <typename KeyFn>
+	void SortBy(KeyFn key)
 	{
-		for (unsigned int i = 0; i < size; ++i)
-			if (data[i] == value)
-			{
-				RemoveKeepOrder(i);
-				--i;
-			}
+		knownSorted = false;
+		if (size < 2)
+			return;
+
+		size_t* order = new size_t[size];
+		SortOrder(key, order);
+		ApplyPermutation(order);
+		delete[] order;
 	}
 
 	/// <summary>
-	/// Clear the list.
+	/// Work out the order that would sort the list, without moving any values.
+	/// Equal values keep their original order.
 	/// </summary>
-	void Clear()
+	/// <returns>A list of indices, where position i holds the index of the value that belongs at position i of the sorted list.</returns>
+	List<size_t> ArgSort() const
 	{
-		Discard(capacity);
+		if constexpr (is_arithmetic_v<T> && sizeof(T) <= 8)
+			return ArgSort([](const T& value) { return value; });
+		else
+		{
+			//Sort the indices by the values they refer to, so no values are copied
+			List<size_t> order(size);
+			for (size_t i = 0; i < size; ++i)
+				order.Push(i);
+
+			const T* values = data;
+			order.IntroSort([values](size_t a, size_t b)
+			{
+				return values[a] < values[b] || (!(values[b] < values[a]) && a < b);
+			});
+			return order;
+		}
 	}
 
 	/// <summary>
-	/// Perform a recursive quick sort of the list.
+	/// Work out the order that would sort the list by a key taken from each value, without moving any values.
+	/// Equal keys keep their original order.
 	/// </summary>
-	void QuickSort()
+	/// <param name="key">Returns the key of a value.</param>
+	/// <returns>A list of indices, where position i holds the index of the value that belongs at position i of the sorted list.</returns>
+	template <typename KeyFn>
+	List<size_t> ArgSort(KeyFn key) const
 	{
-		QuickSort(0, size - 1);
+		List<size_t> order(size);
+		for (size_t i = 0; i < size; ++i)
+			order.Push(0);
+		if (size > 0)
+			SortOrder(key, &order[0]);
+		return order;
 	}
 
 	/// <summary>
-	/// Sort the list using an optimised cocktail shaker sort algorithm.
+	/// Search for a value with the fastest search the list allows.
+	/// Sorted lists of numbers that look evenly spread use an interpolation search once they are large enough.
+	/// Interpolating skewed keys takes up to twice as long as bisecting them, so other sorted lists use a binary search,
+	/// unless they are small enough for a linear scan (vectorised where the type allows) to be faster.
+	/// Lists that aren't known to be sorted are always scanned linearly.
+	/// The sizes that the search changes at are set by the policy.
 	/// </summary>
-	void CocktailShakerSort()
+	/// <param name="value">The value to search for.</param>
+	/// <returns>The index of the value in the list, or -1 if not found.</returns>
+	ptrdiff_t Find(const T& value) const
 	{
-		if (size < 2)
-			return;
-
-		int passes = 0;	//Keep track of the number of times the list has been traversed to reduce the next traversal
-		bool sorted = false;
-		
-		//Sort the list by traversing it and swapping values
-		while (!sorted)
-		{
-			sorted = true;
-
-			//Traverse forwards through the list
-			for (unsigned int i = 0; i < size - (passes + 1); ++i)
-			{
-				if (data[i] > data[i + 1])
-				{
-					Swap(&data[i], &data[i + 1]);
-					sorted = false;
-				}
-			}
+		if (!KnownSorted())
+			return LinearSearch(value);
 
-			//Traverse backwards through the list
-			for (unsigned int i = size - 1; i > 0; --i)
-			{
-				if (data[i - 1] > data[i])
-				{
-					Swap(&data[i], &data[i - 1]);
-					sorted = false;
-				}
-			}
+		if constexpr (is_arithmetic_v<T>)
+			if (size >= Policy::INTERPOLATION_SEARCH_THRESHOLD && EvenlySpread())
+				return InterpolationSearch(value);
 
-			++passes;
-		}
+		size_t linearThreshold = SimdKernels::HasKernel<T> ? Policy::SIMD_LINEAR_SEARCH_THRESHOLD : Policy::LINEAR_SEARCH_THRESHOLD;
+		if (size < linearThreshold)
+			return LinearSearch(value);
+		return BinarySearch(value);
 	}
 
 	/// <summary>
-	/// Perform an insertion sort on the list.
-	/// https://www.geeksforgeeks.org/insertion-sort/
+	/// Perform a linear search for a value, checking several values at once where the type allows.
+	/// Works whether or not the list is sorted.
 	/// </summary>
-	void InsertionSort()
+	/// <param name="value">The value to search for.</param>
+	/// <returns>The index of the first occurence of the value, or -1 if not found.</returns>
+	ptrdiff_t LinearSearch(const T& value) const
 	{
-		T key;
-		int j;
-		for (unsigned int i = 1; i < size; ++i)
-		{
-			key = data[i];
-			j = i - 1;
-
-			while (j >= 0 && data[j] > key)
-			{
-				data[j + 1] = data[j];
-				j = j - 1;
-			}
-			data[j + 1] = key;
-		}
+		size_t index = SimdKernels::FindFirst(data, size, value);
+		return index < size ? (ptrdiff_t)index : -1;
 	}
 
 	/// <summary>
-	/// Perform a heap sort on the list.
-	/// https://www.geeksforgeeks.org/heap-sort/
+	/// Perform an interpolation search for a number in the sorted list.
+	/// Guesses where the value is from where it lies between the first and last values of the range,
+	/// so evenly spread values are found in O(log log n) steps.
+	/// Whenever a guess fails to halve the range the next step is a bisection, so unevenly spread values take at most O(log n) steps.
+	/// Only available for arithmetic types.
 	/// </summary>
-	void HeapSort()
+	/// <param name="value">The value to search for.</param>
+	/// <returns>The index of the value in the list, or -1 if not found.</returns>
+	template <typename U = T, typename = enable_if_t<is_arithmetic_v<U>>>
+	ptrdiff_t InterpolationSearch(const T& value) const
 	{
-		//Build a heap (rearrange array)
-		for (int i = size / 2 - 1; i >= 0; --i)
-			Heapify(size, i);
+		if (size == 0)
+			return -1;
 
-		//One by one extract an element from the heap
-		for (int i = size - 1; i >= 0; --i)
+		//Search the range [low, high] while the value could be inside it
+		size_t low = 0;
+		size_t high = size - 1;
+		bool bisect = false;
+		while (low <= high && !(value < data[low]) && !(data[high] < value))
 		{
-			//Move current root to end
-			Swap(&data[0], &data[i]);
+			size_t probe = low + (high - low) / 2;
+			if (!bisect && data[low] < data[high])
+			{
+				//Keys that convert to the same double (e.g. large 64-bit integers) or infinities can't be interpolated, so bisect instead
+				double lowValue = (double)data[low];
+				double span = (double)data[high] - lowValue;
+				double fraction = span > 0 ? ((double)value - lowValue) / span : -1;
+				if (fraction >= 0 && fraction <= 1)
+				{
+					probe = low + (size_t)(fraction * (double)(high - low));
+					if (probe > high)
+						probe = high;
+				}
+			}
 
-			//Call max heapify on the reduced heap
-			Heapify(i, 0);
+			size_t range = high - low;
+			if (data[probe] < value)
+				low = probe + 1;
+			else if (value < data[probe])
+				high = probe - 1;	//The probe can't be at low here as the value isn't below data[low]
+			else
+				return (ptrdiff_t)probe;
+
+			bisect = !bisect && low <= high && high - low > range / 2;
 		}
+
+		return -1;
 	}
 
 	/// <summary>
@@ -488,27 +2591,27 @@ public:
 	/// </summary>
 	/// <param name="value">Value to search for.</param>
 	/// <returns>Index of the value, -1 if not found.</returns>
-	int FibonacciSearch(const T& value) const
+	ptrdiff_t FibonacciSearch(const T& value) const
 	{
-		int fibMMm2 = 0;				//(m-2)'th Fibonnaci number
-		int fibMMm1 = 1;				//(m-1)'th Fibonnaci number
-		int fibM = fibMMm1 + fibMMm2;	// m'th Fibonacci number
+		size_t fibMMm2 = 0;					//(m-2)'th Fibonnaci number
+		size_t fibMMm1 = 1;					//(m-1)'th Fibonnaci number
+		size_t fibM = fibMMm1 + fibMMm2;	// m'th Fibonacci number
 
 		//Store the smallest Fibonacci number greater than or equal to the size of the list in fibM
-		while (fibM < (int)size)
+		while (fibM < size)
 		{
 			fibMMm2 = fibMMm1;
 			fibMMm1 = fibM;
 			fibM = fibMMm1 + fibMMm2;
 		}
 
-		//Marks the eliminated range from the front
-		int offset = -1;
+		//The number of elements eliminated from the front
+		size_t offset = 0;
 
-		//While there are elements to be searched
+		//While there are elements to be searched (fibMMm2 is at least 1 here, so i can't underflow)
 		while (fibM > 1)
 		{
-			int i = Min(offset + fibMMm2, size - 1);
+			size_t i = Min(offset + fibMMm2, size) - 1;
 
 			//If the value is greater than the value at index fibMMm2, cut the list from offset to i
 			if (data[i] < value)
@@ -516,7 +2619,7 @@ public:
 				fibM = fibMMm1;
 				fibMMm1 = fibMMm2;
 				fibMMm2 = fibM - fibMMm1;
-				offset = i;
+				offset = i + 1;
 			}
 			//If the value is greater than the value at index fibMMm2, cut the list after i + 1
 			else if (data[i] > value)
@@ -527,12 +2630,12 @@ public:
 			}
 			//Value was found
 			else
-				return i;
+				return (ptrdiff_t)i;
 		}
 
 		//Compare the last element
-		if (fibMMm1 && data[offset + 1] == value) 
-			return offset + 1;
+		if (fibMMm1 && offset < size && data[offset] == value)
+			return (ptrdiff_t)offset;
 
 		//Value not found
 		return -1;
@@ -543,23 +2646,24 @@ public:
 	/// </summary>
 	/// <param name="value">The value to search for.</param>
 	/// <returns>The index of the value in the list, or -1 if not found.</returns>
-	int BinarySearch(const T& value) const
+	ptrdiff_t BinarySearch(const T& value) const
 	{
 		if (size == 0)
 			return -1;
 
-		unsigned int startIndex = 0;
-		unsigned int endIndex = size - 1;
+		//Search the range [startIndex, endIndex) so the indices can't underflow
+		size_t startIndex = 0;
+		size_t endIndex = size;
 
-		while (startIndex <= endIndex)
+		while (startIndex < endIndex)
 		{
-			unsigned int pivot = (startIndex + endIndex) / 2;
+			size_t pivot = startIndex + (endIndex - startIndex) / 2;
 
 			if (data[pivot] == value)
-				return pivot;
+				return (ptrdiff_t)pivot;
 
 			if (value < data[pivot])
-				endIndex = pivot - 1;
+				endIndex = pivot;
 			else
 				startIndex = pivot + 1;
 		}
@@ -573,21 +2677,22 @@ public:
 	/// </summary>
 	/// <param name="value">The value to search for.</param>
 	/// <returns>The index of the value in the list, or -1 if not found.</returns>
-	int JumpSearch(const T& value) const
+	ptrdiff_t JumpSearch(const T& value) const
 	{
 		if (size == 0)
 			return -1;
 
 		//Find a block size to be jumped
-		int step = (int)sqrt(size);
+		size_t jump = (size_t)sqrt((double)size);
+		size_t step = jump;
 
 		//Find the block where the search value is present
-		int prev = 0;
+		size_t prev = 0;
 		while (data[Min(step, size) - 1] < value)
 		{
 			prev = step;
-			step += (int)sqrt(size);
-			if (prev >= (int)size)
+			step += jump;
+			if (prev >= size)
 				return -1;
 		}
 
@@ -603,16 +2708,310 @@ public:
 
 		//Check if the value is found
 		if (data[prev] == value)
-			return prev;
+			return (ptrdiff_t)prev;
 
 		return -1;
 	}
 
+	/// <summary>
+	/// Add up the values in the list using the vectorised kernels.
+	/// Integers are added up in 64 bits so that they don't overflow.
+	/// Floats are added in several lanes (and blocks) at once, so the result can round slightly differently to adding them in order.
+	/// Only available for arithmetic types.
+	/// </summary>
+	/// <param name="threads">The number of threads to use for large lists. 0 uses one thread per hardware core.</param>
+	/// <returns>The sum of the values, 0 if the list is empty.</returns>
+	template <typename U = T, typename = enable_if_t<is_arithmetic_v<U>>>
+	SimdKernels::SumType<T> Sum(unsigned int threads = 1) const
+	{
+		size_t blocks = BlockCount(threads, PARALLEL_AGGREGATE_MIN_BLOCK);
+		if (blocks == 1)
+			return SimdKernels::Sum(data, size);
+
+		List<SimdKernels::SumType<T>> sums(blocks);
+		for (size_t i = 0; i < blocks; ++i)
+			sums.Push(0);
+		ForEachBlock(blocks, [this, &sums](size_t block, size_t low, size_t high) { sums[block] = SimdKernels::Sum(data + low, high - low); });
+
+		SimdKernels::SumType<T> total = 0;
+		for (size_t i = 0; i < blocks; ++i)
+			total += sums[i];
+		return total;
+	}
+
+	/// <summary>
+	/// Find the smallest value in the list using the vectorised kernels.
+	/// Only available for arithmetic types.
+	/// </summary>
+	/// <param name="threads">The number of threads to use for large lists. 0 uses one thread per hardware core.</param>
+	/// <returns>The smallest value.</returns>
+	template <typename U = T, typename = enable_if_t<is_arithmetic_v<U>>>
+	T Min(unsigned int threads = 1) const
+	{
+		return MinMax(threads).first;
+	}
+
+	/// <summary>
+	/// Find the largest value in the list using the vectorised kernels.
+	/// Only available for arithmetic types.
+	/// </summary>
+	/// <param name="threads">The number of threads to use for large lists. 0 uses one thread per hardware core.</param>
+	/// <returns>The largest value.</returns>
+	template <typename U = T, typename = enable_if_t<is_arithmetic_v<U>>>
+	T Max(unsigned int threads = 1) const
+	{
+		return MinMax(threads).second;
+	}
+
+	/// <summary>
+	/// Find the smallest and largest values in the list in one pass, using the vectorised kernels.
+	/// NaNs are skipped, so they are only returned if every value is a NaN. Any number of threads gives the same result.
+	/// Only available for arithmetic types.
+	/// </summary>
+	/// <param name="threads">The number of threads to use for large lists. 0 uses one thread per hardware core.</param>
+	/// <returns>The smallest value, then the largest value.</returns>
+	template <typename U = T, typename = enable_if_t<is_arithmetic_v<U>>>
+	pair<T, T> MinMax(unsigned int threads = 1) const
+	{
+		//Throw an exception if there are no values
+		if (size == 0)
+			throw out_of_range("The list is empty.");
+
+		pair<T, T> result;
+		size_t blocks = BlockCount(threads, PARALLEL_AGGREGATE_MIN_BLOCK);
+		if (blocks == 1)
+		{
+			SimdKernels::MinMax(data, size, result.first, result.second);
+			return result;
+		}
+
+		List<pair<T, T>> extremes(blocks);
+		for (size_t i = 0; i < blocks; ++i)
+			extremes.Push(pair<T, T>(data[0], data[0]));
+		ForEachBlock(blocks, [this, &extremes](size_t block, size_t low, size_t high)
+		{
+			SimdKernels::MinMax(data + low, high - low, extremes[block].first, extremes[block].second);
+		});
+
+		//A block is only NaN if all of its values are, so skip those blocks to match one thread
+		result = extremes[0];
+		for (size_t i = 1; i < blocks; ++i)
+		{
+			const pair<T, T>& block = extremes[i];
+			if (block.first != block.first)
+				continue;
+			if (result.first != result.first || block.first < result.first)
+				result.first = block.first;
+			if (result.second != result.second || result.second < block.second)
+				result.second = block.second;
+		}
+		return result;
+	}
+
+	/// <summary>
+	/// Count the number of times a value appears in the list.
+	/// Uses a vectorised scan for numbers.
+	/// </summary>
+	/// <param name="value">The value to count.</param>
+	/// <returns>The number of values equal to the value.</returns>
+	size_t Count(const T& value) const
+	{
+		return SimdKernels::Count(data, size, value);
+	}
+
+	/// <summary>
+	/// Count the values in the list that match a condition.
+	/// The condition is called from several threads at the same time if more than one thread is used.
+	/// </summary>
+	/// <param name="pred">Returns true for the values to count.</param>
+	/// <param name="threads">The number of threads to use for large lists. 0 uses one thread per hardware core.</param>
+	/// <returns>The number of values that match.</returns>
+	template <typename Predicate>
+	size_t CountIf(Predicate pred, unsigned int threads = 1) const
+	{
+		size_t blocks = BlockCount(threads, PARALLEL_AGGREGATE_MIN_BLOCK);
+		List<size_t> counts(blocks);
+		for (size_t i = 0; i < blocks; ++i)
+			counts.Push(0);
+		ForEachBlock(blocks, [this, &counts, &pred](size_t block, size_t low, size_t high)
+		{
+			size_t count = 0;
+			for (size_t i = low; i < high; ++i)
+				if (pred(data[i]))
+					++count;
+			counts[block] = count;
+		});
+
+		size_t total = 0;
+		for (size_t i = 0; i < blocks; ++i)
+			total += counts[i];
+		return total;
+	}
+
+	/// <summary>
+	/// Replace each value with the sum of itself and every value before it (an inclusive prefix sum), using the vectorised kernels.
+	/// With more than one thread, each block is added up, then each block is summed starting from the total of the blocks before it.
+	/// Sums are made in the list's own type, so integers can overflow. Floats can round slightly differently to adding them in order.
+	/// Only available for arithmetic types.
+	/// </summary>
+	/// <param name="threads">The number of threads to use for large lists. 0 uses one thread per hardware core.</param>
+	template <typename U = T, typename = enable_if_t<is_arithmetic_v<U>>>
+	void PrefixSum(unsigned int threads = 1)
+	{
+		knownSorted = false;
+		size_t blocks = BlockCount(threads, PARALLEL_AGGREGATE_MIN_BLOCK);
+		if (blocks == 1)
+		{
+			SimdKernels::PrefixSum(data, size, (T)0);
+			return;
+		}
+
+		List<T> offsets(blocks);
+		for (size_t i = 0; i < blocks; ++i)
+			offsets.Push((T)0);
+		ForEachBlock(blocks, [this, &offsets](size_t block, size_t low, size_t high) { offsets[block] = (T)SimdKernels::Sum(data + low, high - low); });
+
+		//Each block starts from the total of the blocks before it
+		T total = 0;
+		for (size_t i = 0; i < blocks; ++i)
+		{
+			T blockSum = offsets[i];
+			offsets[i] = total;
+			total = (T)(total + blockSum);
+		}
+		ForEachBlock(blocks, [this, &offsets](size_t block, size_t low, size_t high) { SimdKernels::PrefixSum(data + low, high - low, offsets[block]); });
+	}
+
+	/// <summary>
+	/// Replace each value with the sum of every value before it (an exclusive prefix sum), so the first value becomes 0.
+	/// Works the same way as PrefixSum().
+	/// Only available for arithmetic types.
+	/// </summary>
+	/// <param name="threads">The number of threads to use for large lists. 0 uses one thread per hardware core.</param>
+	template <typename U = T, typename = enable_if_t<is_arithmetic_v<U>>>
+	void ExclusivePrefixSum(unsigned int threads = 1)
+	{
+		if (size == 0)
+			return;
+
+		PrefixSum(threads);
+		memmove(data + 1, data, sizeof(T) * (size - 1));
+		data[0] = (T)0;
+	}
+
+	/// <summary>
+	/// Check if the list is known to be in ascending order.
+	/// The sorts mark the list as sorted, and pushing, inserting or removing out of order clears the mark.
+	/// Values changed through operator[] aren't tracked, so call InvalidateSorted() after writing to a sorted list that way.
+	/// </summary>
+	/// <returns>True if the list is known to be sorted. Lists with fewer than two values are always sorted.</returns>
+	bool KnownSorted() const
+	{
+		return knownSorted || size < 2;
+	}
+
+	/// <summary>
+	/// Check every value to see if the list is in ascending order, and remember the result for Find().
+	/// Useful for lists that are filled in order rather than sorted.
+	/// </summary>
+	/// <returns>True if the list is sorted.</returns>
+	bool CheckSorted()
+	{
+		knownSorted = true;
+		for (size_t i = 1; i < size && knownSorted; ++i)
+			if (data[i] < data[i - 1])
+				knownSorted = false;
+		return knownSorted;
+	}
+
+	/// <summary>
+	/// Forget that the list is sorted.
+	/// Must be called after changing the values of a sorted list through operator[].
+	/// </summary>
+	void InvalidateSorted()
+	{
+		knownSorted = false;
+	}
+
+	/// <summary>
+	/// Write the list to a binary writer.
+	/// Trivially copyable elements are written straight from the array in one piece.
+	/// </summary>
+	/// <param name="writer">The writer to write to.</param>
+	void Serialize(BinaryWriter& writer) const
+	{
+		writer.WriteHeader<T>(SERIAL_LIST, size, knownSorted ? SERIAL_SORTED : 0);
+		writer.WriteValues(data, size);
+	}
+
+	/// <summary>
+	/// Replace the values of the list with a list read from a binary reader.
+	/// Trivially copyable elements are read straight into the array, a piece at a time as the list grows.
+	/// Whether the list was known to be sorted is kept, so Find() doesn't need to check again.
+	/// </summary>
+	/// <param name="reader">The reader to read from.</param>
+	void Deserialize(BinaryReader& reader)
+	{
+		size_t count = reader.ReadHeader<T>(SERIAL_LIST);
+		Clear();
+
+		//Grow as the values are read, so a corrupt count runs out of stream before it can allocate more than the stream holds
+		const size_t chunk = DESERIALIZE_CHUNK_BYTES / sizeof(T) > 0 ? DESERIALIZE_CHUNK_BYTES / sizeof(T) : 1;
+		while (size < count)
+		{
+			size_t piece = count - size < chunk ? count - size : chunk;
+			if (size + piece > capacity)
+			{
+				size_t newCapacity = NextCapacity();
+				if (newCapacity < size + piece)
+					newCapacity = size + piece;
+				Reserve(newCapacity < count ? newCapacity : count);
+			}
+
+			if constexpr (is_trivially_copyable_v<T>)
+			{
+				reader.ReadValues(data + size, piece);
+				size += piece;
+			}
+			else
+			{
+				for (size_t i = 0; i < piece; ++i)
+				{
+					T value;
+					reader.ReadValue(value);
+					EmplaceBack(move(value));
+				}
+			}
+		}
+		knownSorted = (reader.Flags() & SERIAL_SORTED) != 0;
+	}
+
+	/// <summary>
+	/// Get the array the elements are stored in, for loops that don't need operator[]'s range check.
+	/// The pointer is only valid until the list's capacity changes.
+	/// Values changed through it aren't tracked, so call InvalidateSorted() after writing to a sorted list.
+	/// </summary>
+	/// <returns>A pointer to the first element.</returns>
+	T* Data()
+	{
+		return data;
+	}
+
+	/// <summary>
+	/// Get the array the elements are stored in, for read-only loops that don't need operator[]'s range check.
+	/// The pointer is only valid until the list's capacity changes.
+	/// </summary>
+	/// <returns>A pointer to the first element.</returns>
+	const T* Data() const
+	{
+		return data;
+	}
+
 	/// <summary>
 	/// Getter for the size of the list.
 	/// </summary>
 	/// <returns>The number of elements in the list.</returns>
-	unsigned int Size() const
+	size_t Size() const
 	{
 		return size;
 	}
@@ -621,18 +3020,40 @@ public:
 	/// Getter for the current capacity of the list.
 	/// </summary>
 	/// <returns>The current capacity of the list.</returns>
-	unsigned int Capacity() const
+	size_t Capacity() const
 	{
 		return capacity;
 	}
 
 	/// <summary>
 	/// Getter for the maximum possible capacity for any list.
+	/// This is only limited by the size of the address space.
 	/// </summary>
 	/// <returns>The maximum possible capacity for any list.</returns>
-	const unsigned int MaxCapacity() const
+	size_t MaxCapacity() const
+	{
+		return numeric_limits<size_t>::max() / sizeof(T);
+	}
+
+	/// <summary>
+	/// Getter for the factor the capacity grows by when the list is full.
+	/// </summary>
+	/// <returns>The growth factor of the list.</returns>
+	float GrowthFactor() const
+	{
+		return growthFactor;
+	}
+
+	/// <summary>
+	/// Set the factor the capacity grows by when the list is full.
+	/// 1.5 uses less memory while 2 reallocates less often.
+	/// </summary>
+	/// <param name="factor">The growth factor. Must be greater than 1.</param>
+	void SetGrowthFactor(float factor)
 	{
-		return MAX_CAPACITY;
+		if (factor <= 1.0f)
+			throw invalid_argument("Growth factor must be greater than 1.");
+		growthFactor = factor;
 	}
 
 	/// <summary>
@@ -642,11 +3063,64 @@ public:
 	/// <returns>This list with copied data.</returns>
 	List& operator= (const List& other)
 	{
-		delete[] data;
+		if (this == &other)
+			return *this;
+
+		//A small list copies straight into its inline storage when the values fit (if a copy throws, this list is left empty)
+		if (inlineData != nullptr && other.size <= inlineCapacity)
+		{
+			Destroy(data, size);
+			FreeData();
+			data = inlineData;
+			size = 0;
+			capacity = inlineCapacity;
+			CopyConstruct(data, other.data, other.size);
+			size = other.size;
+			growthFactor = other.growthFactor;
+			knownSorted = other.knownSorted;
+			return *this;
+		}
+
+		//Copy into new memory first so this list is left untouched if a copy throws
+		T* newData = Allocate(other.capacity);
+		try
+		{
+			CopyConstruct(newData, other.data, other.size);
+		}
+		catch (...)
+		{
+			Deallocate(newData);
+			throw;
+		}
+
+		Destroy(data, size);
+		FreeData();
+		data = newData;
 		capacity = other.capacity;
 		size = other.size;
-		data = new T[capacity];
-		memcpy(data, other.data, sizeof(T) * capacity);
+		growthFactor = other.growthFactor;
+		knownSorted = other.knownSorted;
+		return *this;
+	}
+
+	/// <summary>
+	/// Move assignment operator overload.
+	/// Takes the data from the other list, leaving it empty.
+	/// If the other list is a small list using its inline storage then its elements are moved instead.
+	/// </summary>
+	/// <param name="other">The other list to move data from.</param>
+	/// <returns>This list with the moved data.</returns>
+	List& operator= (List&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		Destroy(data, size);
+		FreeData();
+		data = inlineData;
+		size = 0;
+		capacity = inlineCapacity;
+		TakeData(other);
 		return *this;
 	}
 
@@ -657,10 +3131,10 @@ public:
 	/// <param name="os">The ostream to display the list to.</param>
 	/// <param name="list">The list to display,</param>
 	/// <returns>The ostream with the list displayed.</returns>
-	friend ostream& operator<< (ostream& os, const List<T>& list)
+	friend ostream& operator<< (ostream& os, const List& list)
 	{
 		os << "[";
-		for (unsigned int i = 0; i < list.Size(); ++i)
+		for (size_t i = 0; i < list.Size(); ++i)
 		{
 			if (i != 0)
 				os << ", ";
@@ -676,35 +3150,63 @@ public:
 	/// </summary>
 	/// <param name="index">The index to access.</param>
 	/// <returns>The element at the specified index.</returns>
-	T& operator[] (const unsigned int index) const
+	T& operator[] (const size_t index) const
 	{
-		if (index >= 0 && index < size)
+		if (index < size)
 			return data[index];
 
 		//Throw an error if the index is outside the range of the list
 		throw out_of_range("Index out of range.");
 	}
 
+	/// <summary>
+	/// Append the list to a text buffer in the same format as the << operator.
+	/// Reusing the buffer avoids allocating, and numbers are written with to_chars.
+	/// </summary>
+	/// <param name="buffer">The buffer to append to.</param>
+	/// <param name="maxElements">The most elements to show, the rest are replaced by "...".</param>
+	void Format(TextBuffer& buffer, size_t maxElements = FORMAT_ALL) const
+	{
+		size_t shown = size < maxElements ? size : maxElements;
+		buffer.Append('[');
+		for (size_t i = 0; i < shown; ++i)
+		{
+			if (i != 0)
+				buffer.Append(", ");
+			buffer.Append(data[i]);
+		}
+		if (shown < size)
+			buffer.Append(shown == 0 ? "..." : ", ...");
+		buffer.Append(']');
+	}
+
 	/// <summary>
 	/// Print details about this list to std::cout.
+	/// The line is formatted in a buffer and written in one piece, without flushing std::cout.
 	/// </summary>
-	void PrintDetails() const
+	/// <param name="maxElements">The most elements to show, the rest are replaced by "...".</param>
+	void PrintDetails(size_t maxElements = FORMAT_ALL) const
 	{
-		cout << "Size: " << size << "   ";
-		cout << "Capacity: " << capacity << "   ";
-		for (unsigned int i = 0; i < size; ++i)
-			cout << data[i] << " ";
-		cout << endl;
+		size_t shown = size < maxElements ? size : maxElements;
+		TextBuffer& buffer = ScratchTextBuffer();
+		buffer.Append("Size: ").Append(size).Append("   ");
+		buffer.Append("Capacity: ").Append(capacity).Append("   ");
+		for (size_t i = 0; i < shown; ++i)
+			buffer.Append(data[i]).Append(' ');
+		if (shown < size)
+			buffer.Append("... ");
+		buffer.Append('\n').WriteTo(cout);
 	}
 
 	/// <summary>
 	/// Get the list represented as a string.
 	/// </summary>
+	/// <param name="maxElements">The most elements to show, the rest are replaced by "...".</param>
 	/// <returns>A string representation of the list.</returns>
-	string ToString() const
+	string ToString(size_t maxElements = FORMAT_ALL) const
 	{
-		ostringstream stream;
-		stream << *this;
-		return stream.str();
+		TextBuffer buffer;
+		Format(buffer, maxElements);
+		return buffer.Str();
 	}
 };
\ No newline at end of file
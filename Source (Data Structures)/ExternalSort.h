@@ -0,0 +1,519 @@
+/*
+	File: ExternalSort.h
+	Contains: ExternalSort
+*/
+
+#pragma once
+#include <fstream>
+#include <string>
+#include <memory>
+#include <future>
+#include <random>
+#include <stdexcept>
+#include <filesystem>
+#include "DynamicList.h"
+
+using namespace std;
+
+/// <summary>
+/// The External Sort sorts a binary file of fixed-size records that can be much larger than memory.
+/// The file is read in chunks that fit in the memory budget, each chunk is introsorted in a List and spilled to a temporary run file,
+/// then the runs are merged into the output with a heap of each run's smallest record.
+/// If there are too many runs to merge at once within the budget, they are merged in groups over several passes.
+/// Reads are double-buffered: the next block of a file is read on another thread while the current block is used.
+/// Records are read and written as raw bytes, so the type must be trivially copyable.
+/// </summary>
+template <typename T>
+class ExternalSort
+{
+private:
+	static_assert(is_trivially_copyable_v<T>, "The external sort reads and writes records as raw bytes, so they must be trivially copyable.");
+
+	/// <summary>
+	/// Reads a file of records one block at a time, reading the next block on another thread while the current one is used.
+	/// </summary>
+	class BlockReader
+	{
+	private:
+		ifstream file;			//The file being read
+		T* memory;				//The two blocks, one after the other
+		T* block;				//The block being used
+		size_t blockSize;		//The number of records that fit in a block
+		size_t count;			//The number of records in the block being used
+		size_t position;		//The index of the next record in the block being used
+		bool finished;			//Whether the end of the file has been reached, so there is nothing left to read
+		future<size_t> pending;	//The read of the next block, into whichever block isn't being used
+
+		/// <summary>
+		/// Start reading the next block of the file on another thread.
+		/// </summary>
+		/// <param name="target">The block to read into.</param>
+		void StartRead(T* target)
+		{
+			pending = async(launch::async, [this, target]()
+			{
+				file.read(reinterpret_cast<char*>(target), (streamsize)(sizeof(T) * blockSize));
+				size_t bytes = (size_t)file.gcount();
+				if (bytes % sizeof(T) != 0)
+					throw runtime_error("The file ends part way through a record.");
+				return bytes / sizeof(T);
+			});
+		}
+
+	public:
+		/// <summary>
+		/// Overloaded constructor.
+		/// Starts reading the first block.
+		/// </summary>
+		/// <param name="path">The file to read.</param>
+		/// <param name="_blockSize">The number of records in a block.</param>
+		BlockReader(const string& path, size_t _blockSize)
+		{
+			file.open(path, ios::binary);
+			if (!file)
+				throw runtime_error("Could not open " + path + " for reading.");
+
+			blockSize = _blockSize;
+			memory = static_cast<T*>(::operator new(sizeof(T) * blockSize * 2));
+			block = memory + blockSize;
+			count = 0;
+			position = 0;
+			finished = false;
+			try
+			{
+				StartRead(memory);
+				NextBlock();
+			}
+			catch (...)
+			{
+				if (pending.valid())
+					pending.wait();
+				::operator delete(memory);
+				throw;
+			}
+		}
+
+		BlockReader(const BlockReader&) = delete;
+		BlockReader& operator= (const BlockReader&) = delete;
+
+		/// <summary>
+		/// Deconstructor.
+		/// Waits for any read that is still running.
+		/// </summary>
+		~BlockReader()
+		{
+			if (pending.valid())
+				pending.wait();
+			::operator delete(memory);
+		}
+
+		/// <summary>
+		/// Wait for the block being read and start using it, then start reading the one after it.
+		/// Leaves the reader empty once the whole file has been used.
+		/// </summary>
+		void NextBlock()
+		{
+			position = 0;
+			count = 0;
+			if (finished)
+				return;
+
+			count = pending.get();
+			block = block == memory ? memory + blockSize : memory;
+			if (count < blockSize)
+				finished = true;
+			else
+				StartRead(block == memory ? memory + blockSize : memory);
+		}
+
+		/// <summary>
+		/// Check if every record in the file has been used.
+		/// </summary>
+		/// <returns>True if there are no records left.</returns>
+		bool Empty() const
+		{
+			return position == count;
+		}
+
+		/// <summary>
+		/// Get the next record without using it.
+		/// </summary>
+		/// <returns>The next record.</returns>
+		const T& Front() const
+		{
+			return block[position];
+		}
+
+		/// <summary>
+		/// Use the next record, moving on to the next block once this one is used up.
+		/// </summary>
+		void Advance()
+		{
+			if (++position == count)
+				NextBlock();
+		}
+
+		/// <summary>
+		/// Use up to a number of records from the current block at once.
+		/// The records stay valid until the next call to NextBlock(), which must be called to move on once the block is used up.
+		/// </summary>
+		/// <param name="records">Receives the start of the records.</param>
+		/// <param name="maxCount">The most records to take.</param>
+		/// <returns>The number of records taken.</returns>
+		size_t Take(const T*& records, size_t maxCount)
+		{
+			records = block + position;
+			size_t taken = count - position < maxCount ? count - position : maxCount;
+			position += taken;
+			return taken;
+		}
+	};
+
+	/// <summary>
+	/// Writes records to a file through a block of memory, so the file is written in large pieces.
+	/// </summary>
+	class BlockWriter
+	{
+	private:
+		ofstream file;		//The file being written
+		string path;		//The path of the file, for error messages
+		T* block;			//The records waiting to be written
+		size_t blockSize;	//The number of records that fit in the block
+		size_t count;		//The number of records in the block
+
+		/// <summary>
+		/// Write the records waiting in the block to the file.
+		/// </summary>
+		void WriteBlock()
+		{
+			if (count > 0)
+			{
+				file.write(reinterpret_cast<const char*>(block), (streamsize)(sizeof(T) * count));
+				count = 0;
+				if (!file)
+					throw runtime_error("Could not write to " + path + ".");
+			}
+		}
+
+	public:
+		/// <summary>
+		/// Overloaded constructor.
+		/// </summary>
+		/// <param name="_path">The file to write, replacing it if it exists.</param>
+		/// <param name="_blockSize">The number of records in a block.</param>
+		BlockWriter(const string& _path, size_t _blockSize)
+		{
+			path = _path;
+			file.open(path, ios::binary | ios::trunc);
+			if (!file)
+				throw runtime_error("Could not open " + path + " for writing.");
+
+			blockSize = _blockSize;
+			block = static_cast<T*>(::operator new(sizeof(T) * blockSize));
+			count = 0;
+		}
+
+		BlockWriter(const BlockWriter&) = delete;
+		BlockWriter& operator= (const BlockWriter&) = delete;
+
+		/// <summary>
+		/// Deconstructor.
+		/// Records that haven't been flushed are lost.
+		/// </summary>
+		~BlockWriter()
+		{
+			::operator delete(block);
+		}
+
+		/// <summary>
+		/// Add a record to the end of the file.
+		/// </summary>
+		/// <param name="record">The record to write.</param>
+		void Push(const T& record)
+		{
+			new (block + count) T(record);
+			if (++count == blockSize)
+				WriteBlock();
+		}
+
+		/// <summary>
+		/// Write an array of records straight to the file, after any records waiting in the block.
+		/// </summary>
+		/// <param name="records">The records to write.</param>
+		/// <param name="recordCount">The number of records.</param>
+		void Write(const T* records, size_t recordCount)
+		{
+			WriteBlock();
+			file.write(reinterpret_cast<const char*>(records), (streamsize)(sizeof(T) * recordCount));
+			if (!file)
+				throw runtime_error("Could not write to " + path + ".");
+		}
+
+		/// <summary>
+		/// Write the records waiting in the block and flush the file, checking that everything was written.
+		/// </summary>
+		void Flush()
+		{
+			WriteBlock();
+			file.flush();
+			if (!file)
+				throw runtime_error("Could not write to " + path + ".");
+		}
+	};
+
+	size_t memoryBudget;			//The most memory the sort uses for records, in bytes
+	string tempDirectory;			//The directory the run files are written to
+	unsigned long long tempId;		//A random number in the name of the run files, so sorts running at the same time don't share files
+	size_t tempCount;				//The number of run files that have been named
+
+	/// <summary>
+	/// Get a new path for a run file.
+	/// </summary>
+	/// <returns>The path of the run file.</returns>
+	string NextTempPath()
+	{
+		filesystem::path path = filesystem::path(tempDirectory) / ("ExternalSort-" + to_string(tempId) + "-" + to_string(tempCount++) + ".run");
+		return path.string();
+	}
+
+	/// <summary>
+	/// Delete run files, ignoring any that can't be deleted.
+	/// </summary>
+	/// <param name="paths">The run files to delete.</param>
+	static void RemoveFiles(const List<string>& paths)
+	{
+		for (size_t i = 0; i < paths.Size(); ++i)
+		{
+			error_code error;
+			filesystem::remove(paths[i], error);
+		}
+	}
+
+	/// <summary>
+	/// Calculate the number of records in each block of a merge.
+	/// Each of the runs has two blocks for its reader, and the output has one.
+	/// </summary>
+	/// <param name="fanIn">The number of runs being merged.</param>
+	/// <returns>The number of records in a block.</returns>
+	size_t MergeBlockSize(size_t fanIn) const
+	{
+		size_t records = memoryBudget / (sizeof(T) * (2 * fanIn + 1));
+		return records > 0 ? records : 1;
+	}
+
+	/// <summary>
+	/// Move a run down the merge heap until it is not ordered after either of its children.
+	/// </summary>
+	/// <param name="heap">The indices of the runs, ordered by their next record.</param>
+	/// <param name="heapSize">The number of runs in the heap.</param>
+	/// <param name="index">The position in the heap of the run to move.</param>
+	/// <param name="readers">The readers of the runs.</param>
+	/// <param name="comp">Returns true if the first record should be ordered before the second.</param>
+	template <typename Compare>
+	static void SiftDown(size_t* heap, size_t heapSize, size_t index, const List<unique_ptr<BlockReader>>& readers, Compare& comp)
+	{
+		while (true)
+		{
+			size_t smallest = index;
+			size_t child = 2 * index + 1;
+			if (child < heapSize && comp(readers[heap[child]]->Front(), readers[heap[smallest]]->Front()))
+				smallest = child;
+			if (child + 1 < heapSize && comp(readers[heap[child + 1]]->Front(), readers[heap[smallest]]->Front()))
+				smallest = child + 1;
+			if (smallest == index)
+				return;
+
+			size_t temp = heap[index];
+			heap[index] = heap[smallest];
+			heap[smallest] = temp;
+			index = smallest;
+		}
+	}
+
+	/// <summary>
+	/// Merge sorted run files into one sorted file.
+	/// </summary>
+	/// <param name="runs">The run files to merge.</param>
+	/// <param name="first">The index of the first run to merge.</param>
+	/// <param name="fanIn">The number of runs to merge.</param>
+	/// <param name="outputPath">The file to write the merged records to.</param>
+	/// <param name="comp">Returns true if the first record should be ordered before the second.</param>
+	template <typename Compare>
+	void Merge(const List<string>& runs, size_t first, size_t fanIn, const string& outputPath, Compare& comp)
+	{
+		size_t blockSize = MergeBlockSize(fanIn);
+		List<unique_ptr<BlockReader>> readers(fanIn);
+		for (size_t i = 0; i < fanIn; ++i)
+			readers.Push(make_unique<BlockReader>(runs[first + i], blockSize));
+		BlockWriter writer(outputPath, blockSize);
+
+		//Build a heap of the runs that have records left, ordered by their next record
+		unique_ptr<size_t[]> heap(new size_t[fanIn]);
+		size_t heapSize = 0;
+		for (size_t i = 0; i < fanIn; ++i)
+			if (!readers[i]->Empty())
+				heap[heapSize++] = i;
+		for (size_t i = heapSize / 2; i > 0; --i)
+			SiftDown(heap.get(), heapSize, i - 1, readers, comp);
+
+		//Take the smallest record, then move its run back into place by its next record
+		while (heapSize > 0)
+		{
+			BlockReader& reader = *readers[heap[0]];
+			writer.Push(reader.Front());
+			reader.Advance();
+			if (reader.Empty())
+				heap[0] = heap[--heapSize];
+			SiftDown(heap.get(), heapSize, 0, readers, comp);
+		}
+		writer.Flush();
+	}
+
+public:
+	static const size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;	//The memory budget of the default constructor, in bytes
+	static const size_t MIN_BLOCK_BYTES = 64 * 1024;				//The smallest block a merge reads or writes, which limits how many runs it merges at once
+
+	/// <summary>
+	/// Overloaded constructor.
+	/// </summary>
+	/// <param name="_memoryBudget">The most memory the sort uses for records, in bytes. Must be at least 5 * MIN_BLOCK_BYTES.</param>
+	/// <param name="_tempDirectory">The directory to write the run files to, the system's temporary directory if empty.</param>
+	ExternalSort(size_t _memoryBudget = DEFAULT_MEMORY_BUDGET, const string& _tempDirectory = "")
+	{
+		if (_memoryBudget < 5 * MIN_BLOCK_BYTES)
+			throw invalid_argument("The memory budget must be at least 5 * MIN_BLOCK_BYTES.");
+
+		memoryBudget = _memoryBudget;
+		tempDirectory = _tempDirectory.empty() ? filesystem::temp_directory_path().string() : _tempDirectory;
+		tempId = random_device()();
+		tempCount = 0;
+	}
+
+	/// <summary>
+	/// Sort a file of records into ascending order.
+	/// </summary>
+	/// <param name="inputPath">The file to sort.</param>
+	/// <param name="outputPath">The file to write the sorted records to. It may be the input file.</param>
+	void Sort(const string& inputPath, const string& outputPath)
+	{
+		Sort(inputPath, outputPath, less<T>());
+	}
+
+	/// <summary>
+	/// Sort a file of records with a custom ordering.
+	/// The file is split into runs of about three quarters of the memory budget, which are sorted and spilled to the temporary directory,
+	/// then merged MaxFanIn() runs at a time until one is left. A file that fits in a single run is never spilled.
+	/// The run files are deleted when the sort finishes, even if it throws.
+	/// </summary>
+	/// <param name="inputPath">The file to sort.</param>
+	/// <param name="outputPath">The file to write the sorted records to. It may be the input file.</param>
+	/// <param name="comp">Returns true if the first record should be ordered before the second.</param>
+	template <typename Compare>
+	void Sort(const string& inputPath, const string& outputPath, Compare comp)
+	{
+		List<string> runs;
+		List<string> merged;
+		try
+		{
+			//The reader's two blocks take a quarter of the budget and the run being sorted takes the rest
+			size_t readBlockSize = memoryBudget / (sizeof(T) * 8);
+			if (readBlockSize == 0)
+				readBlockSize = 1;
+			size_t runSize = memoryBudget / sizeof(T) - 2 * readBlockSize;
+			if (runSize < readBlockSize)
+				runSize = readBlockSize;
+
+			List<T, KeepCapacityListPolicy> run(runSize);
+			{
+				BlockReader reader(inputPath, readBlockSize);
+				while (!reader.Empty())
+				{
+					//Fill the run a block at a time, the reader fetches the next block in the background
+					while (!reader.Empty() && run.Size() < runSize)
+					{
+						const T* records;
+						size_t count = reader.Take(records, runSize - run.Size());
+						run.Insert(run.Size(), records, count);
+						if (reader.Empty())
+							reader.NextBlock();
+					}
+
+					run.IntroSort(comp);
+					if (runs.Size() == 0 && reader.Empty())
+						break;
+
+					runs.Push(NextTempPath());
+					BlockWriter writer(runs[runs.Size() - 1], 1);
+					if (run.Size() > 0)
+						writer.Write(&run[0], run.Size());
+					writer.Flush();
+					run.Clear();
+				}
+			}
+
+			if (runs.Size() == 0)
+			{
+				//Everything fit in one run, so it goes straight to the output once the input is closed
+				BlockWriter writer(outputPath, 1);
+				if (run.Size() > 0)
+					writer.Write(&run[0], run.Size());
+				writer.Flush();
+				return;
+			}
+			run.ShrinkToFit();
+
+			//Merge groups of runs until they can all be merged into the output at once
+			size_t fanIn = MaxFanIn();
+			while (runs.Size() > fanIn)
+			{
+				for (size_t first = 0; first < runs.Size(); first += fanIn)
+				{
+					size_t count = runs.Size() - first < fanIn ? runs.Size() - first : fanIn;
+					merged.Push(NextTempPath());
+					Merge(runs, first, count, merged[merged.Size() - 1], comp);
+				}
+				RemoveFiles(runs);
+				runs = move(merged);
+			}
+
+			Merge(runs, 0, runs.Size(), outputPath, comp);
+			RemoveFiles(runs);
+		}
+		catch (...)
+		{
+			RemoveFiles(runs);
+			RemoveFiles(merged);
+			throw;
+		}
+	}
+
+	/// <summary>
+	/// Get the most runs that are merged at once, which keeps every block at least MIN_BLOCK_BYTES within the memory budget.
+	/// </summary>
+	/// <returns>The most runs merged at once.</returns>
+	size_t MaxFanIn() const
+	{
+		size_t blocks = memoryBudget / (MIN_BLOCK_BYTES > sizeof(T) ? MIN_BLOCK_BYTES : sizeof(T));
+		return blocks >= 5 ? (blocks - 1) / 2 : 2;
+	}
+
+	/// <summary>
+	/// Get the memory budget.
+	/// </summary>
+	/// <returns>The most memory the sort uses for records, in bytes.</returns>
+	size_t GetMemoryBudget() const
+	{
+		return memoryBudget;
+	}
+
+	/// <summary>
+	/// Set the memory budget for the next sort.
+	/// </summary>
+	/// <param name="_memoryBudget">The most memory the sort uses for records, in bytes. Must be at least 5 * MIN_BLOCK_BYTES.</param>
+	void SetMemoryBudget(size_t _memoryBudget)
+	{
+		if (_memoryBudget < 5 * MIN_BLOCK_BYTES)
+			throw invalid_argument("The memory budget must be at least 5 * MIN_BLOCK_BYTES.");
+		memoryBudget = _memoryBudget;
+	}
+};
\ No newline at end of file
@@ -6,6 +6,10 @@
 #pragma once
 #include <iostream>
 #include <sstream>
+#include <functional>
+#include "Serialization.h"
+#include "TextBuffer.h"
+#include "NodePool.h"
 
 using namespace std;
 
@@ -13,19 +17,20 @@ using namespace std;
 /// The Linked List is a container that links elements (nodes) together using pointers.
 /// This is a Doubly-Linked List because each node containers a pointer to the next node and previous node.
 /// The class also implements a custom iterator to allow traversing the list.
+/// The nodes are allocated by the Allocator, e.g. PoolAllocator<> to take them from a pool instead of calling new for every node.
 /// </summary>
-template <typename T>
+template <typename T, typename Allocator = NewAllocator>
 class LinkedList
 {
 private:
 	/// <summary>
 	/// The Linked List Node contains the data and a pointer to the next & previous node.
 	/// </summary>
-	template <typename T>
+	template <typename U>
 	class LinkedListNode
 	{
 	public:
-		T data;						//The data in the node
+		U data;						//The data in the node
 		LinkedListNode* next;		//A pointer to the next node
 		LinkedListNode* previous;	//A pointer to the previous node
 
@@ -36,8 +41,8 @@ private:
 		/// <param name="_previous">A pointer to the previous node.</param>
 		LinkedListNode(LinkedListNode* _next, LinkedListNode* _previous)
 		{
-			_next = next;
-			_previous = previous;
+			next = _next;
+			previous = _previous;
 		}
 		
 		/// <summary>
@@ -46,12 +51,26 @@ private:
 		/// <param name="_data">The data to store in the node.</param>
 		/// <param name="_next">A pointer to the next node.</param>
 		/// <param name="_previous">A pointer to the previous node.</param>
-		LinkedListNode(const T& _data, LinkedListNode* _next, LinkedListNode* _previous)
+		LinkedListNode(const U& _data, LinkedListNode* _next, LinkedListNode* _previous)
 		{
 			data = _data;
 			next = _next;
 			previous = _previous;
 		}
+
+		/// <summary>
+		/// Overloaded constructor.
+		/// Moves the data into the node rather than copying it.
+		/// </summary>
+		/// <param name="_data">The data to move into the node.</param>
+		/// <param name="_next">A pointer to the next node.</param>
+		/// <param name="_previous">A pointer to the previous node.</param>
+		LinkedListNode(U&& _data, LinkedListNode* _next, LinkedListNode* _previous)
+		{
+			data = move(_data);
+			next = _next;
+			previous = _previous;
+		}
 	};
 
 public:
@@ -59,11 +78,13 @@ public:
 	/// The Linked List Iterator class allows iterating through a linked list.
 	/// Implementation helped by https://codereview.stackexchange.com/questions/74609/custom-iterator-for-a-linked-list-class
 	/// </summary>
-	template <typename T>
+	template <typename U>
 	class LinkedListIterator
 	{
 	private:
-		LinkedListNode<T>* node;	//The node that this iterator is pointing to
+		LinkedListNode<U>* node;	//The node that this iterator is pointing to
+
+		friend class LinkedList;	//The list uses the node directly, so positional edits don't have to search for it
 
 	public:
 		/// <summary>
@@ -78,7 +99,7 @@ public:
 		/// Overloaded constructor.
 		/// </summary>
 		/// <param name="_node">A pointer to to node that this iterator should point to.</param>
-		LinkedListIterator(LinkedListNode<T>* _node)
+		LinkedListIterator(LinkedListNode<U>* _node)
 		{
 			node = _node;
 		}
@@ -90,7 +111,7 @@ public:
 		/// </summary>
 		/// <param name="other">The other iterator to check against.</param>
 		/// <returns>True if the two iterators are equal.</returns>
-		bool operator== (const LinkedListIterator<T>& other) const
+		bool operator== (const LinkedListIterator<U>& other) const
 		{
 			return node != nullptr && other.node != nullptr && node == other.node;
 		}
@@ -101,22 +122,22 @@ public:
 		/// </summary>
 		/// <param name="other">The other iterator to check against.</param>
 		/// <returns>True if the two iterators are not equal.</returns>
-		bool operator!= (const LinkedListIterator<T>& other) const
+		bool operator!= (const LinkedListIterator<U>& other) const
 		{
 			return !(*this == other);
 		}
 
-		LinkedListIterator<T> Next() const
+		LinkedListIterator<U> Next() const
 		{
-			LinkedListIterator<T> iter(node);
+			LinkedListIterator<U> iter(node);
 			if (iter.node != nullptr)
 				iter.node = iter.node->next;
 			return iter;
 		}
 
-		LinkedListIterator<T> Next(unsigned int increment) const
+		LinkedListIterator<U> Next(unsigned int increment) const
 		{
-			LinkedListIterator<T> iter(node);
+			LinkedListIterator<U> iter(node);
 			while (increment > 0)
 			{
 				if (iter.node != nullptr)
@@ -128,17 +149,17 @@ public:
 			return iter;
 		}
 
-		LinkedListIterator<T> Previous() const
+		LinkedListIterator<U> Previous() const
 		{
-			LinkedListIterator<T> iter(node);
+			LinkedListIterator<U> iter(node);
 			if (iter.node != nullptr)
 				iter.node = iter.node->previous;
 			return iter;
 		}
 
-		LinkedListIterator<T> Previous(unsigned int increment) const
+		LinkedListIterator<U> Previous(unsigned int increment) const
 		{
-			LinkedListIterator<T> iter(node);
+			LinkedListIterator<U> iter(node);
 			while (increment > 0)
 			{
 				if (iter.node != nullptr)
@@ -179,7 +200,7 @@ public:
 		/// Will return the data within the node.
 		/// </summary>
 		/// <returns>The data of the node that the iterator is representing.</returns>
-		T& operator* () const
+		U& operator* () const
 		{
 			if (node != nullptr)
 				return node->data;
@@ -193,7 +214,7 @@ public:
 		/// Will return the data within the node.
 		/// </summary>
 		/// <returns>The data of the node that the iterator is representing.</returns>
-		T& operator-> () const
+		U& operator-> () const
 		{
 			if (node != nullptr)
 				return node->data;
@@ -208,6 +229,19 @@ private:
 	LinkedListNode<T>* tail;	//The tail of the linked list (last node)
 	LinkedListNode<T>* end;		//One past the tail used for iterating through the linked list
 	unsigned int size;			//The number of nodes in the linked list
+	Allocator allocator;		//Allocates the nodes
+
+	/// <summary>
+	/// Create the head and end nodes of an empty linked list.
+	/// </summary>
+	void CreateEmpty()
+	{
+		head = allocator.template New<LinkedListNode<T>>(nullptr, nullptr);
+		tail = head;
+		end = allocator.template New<LinkedListNode<T>>(nullptr, tail);
+		head->next = end;
+		size = 0;
+	}
 
 	/// <summary>
 	/// A function that removes a specific node from the linked list.
@@ -225,40 +259,241 @@ private:
 			//Otherwise delete the node and readjust the pointers
 			node->previous->next = node->next;
 			node->next->previous = node->previous;
-			delete node;
+			allocator.Delete(node);
 			--size;
 		}
 	}
 
 	/// <summary>
-	/// Find a node that an iterator points to.
+	/// A chain of linked nodes that ends in nullptr, e.g. a sorted run in the merge sort.
 	/// </summary>
-	/// <param name="iter">The iterator.</param>
-	/// <returns>The node that the iterator points to.</returns>
-	LinkedListNode<T>* FindNode(LinkedListIterator<T> iter) const
+	struct NodeChain
 	{
-		//If the linked list is empty, then return
-		if (size == 0)
-			return nullptr;
-		//If the iterator points to the first position, return the first node
-		else if (iter == Begin())
-			return head;
-		//If the iterator points to the second last position, return the last node
-		else if (iter == End().Previous())
-			return tail;
+		LinkedListNode<T>* first;	//The first node, or nullptr if the chain is empty
+		LinkedListNode<T>* last;	//The last node
+	};
+
+	/// <summary>
+	/// Merge two sorted chains of nodes by relinking them, without copying any values.
+	/// Whatever is left of one chain once the other runs out is attached in one step.
+	/// The merge is stable: of two equal values, the one from the first chain comes first.
+	/// </summary>
+	/// <param name="a">The first chain.</param>
+	/// <param name="b">The second chain.</param>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	/// <returns>The merged chain.</returns>
+	template <typename Compare>
+	static NodeChain MergeChains(NodeChain a, NodeChain b, Compare& comp)
+	{
+		NodeChain merged = { nullptr, nullptr };
+		LinkedListNode<T>** link = &merged.first;	//The pointer the next node is linked to
+		while (a.first != nullptr && b.first != nullptr)
+		{
+			//Only take from the second chain when its value is strictly before, to keep equal values in order
+			LinkedListNode<T>* node;
+			if (comp(b.first->data, a.first->data))
+			{
+				node = b.first;
+				b.first = node->next;
+			}
+			else
+			{
+				node = a.first;
+				a.first = node->next;
+			}
+
+			*link = node;
+			node->previous = merged.last;
+			merged.last = node;
+			link = &node->next;
+		}
+
+		//The rest of the other chain is already linked together
+		NodeChain& rest = a.first != nullptr ? a : b;
+		*link = rest.first;
+		if (rest.first != nullptr)
+		{
+			rest.first->previous = merged.last;
+			merged.last = rest.last;
+		}
+		return merged;
+	}
+
+	/// <summary>
+	/// Give the linked list a new empty head node, after all of its nodes have been moved to another list.
+	/// </summary>
+	void ResetEmpty()
+	{
+		head = allocator.template New<LinkedListNode<T>>(end, nullptr);
+		tail = head;
+		end->previous = tail;
+		size = 0;
+	}
+
+	/// <summary>
+	/// Unlink a range of nodes from the linked list, leaving them linked to each other in a chain that ends in nullptr.
+	/// </summary>
+	/// <param name="first">The first node to unlink.</param>
+	/// <param name="last">The last node to unlink.</param>
+	/// <param name="count">The number of nodes being unlinked.</param>
+	void Unlink(LinkedListNode<T>* first, LinkedListNode<T>* last, unsigned int count)
+	{
+		if (first == head && last == tail)	//If every node is unlinked, the list needs a new empty head
+			ResetEmpty();
 		else
 		{
-			//Find the node that the iterator points to and return it
-			LinkedListNode<T>* node = head->next;
-			for (auto i = Begin().Next(); i != End().Previous(); ++i)
+			if (first == head)
 			{
-				if (iter == i)
-					return node;
-				node = node->next;
+				head = last->next;
+				head->previous = nullptr;
+			}
+			else if (last == tail)
+			{
+				tail = first->previous;
+				tail->next = end;
+				end->previous = tail;
+			}
+			else
+			{
+				first->previous->next = last->next;
+				last->next->previous = first->previous;
 			}
+			size -= count;
+		}
+		first->previous = nullptr;
+		last->next = nullptr;
+	}
+
+	/// <summary>
+	/// Link a chain of nodes into the linked list before a node.
+	/// </summary>
+	/// <param name="position">The node to link the chain before, or nullptr for the end.</param>
+	/// <param name="first">The first node of the chain.</param>
+	/// <param name="last">The last node of the chain.</param>
+	/// <param name="count">The number of nodes in the chain.</param>
+	void Link(LinkedListNode<T>* position, LinkedListNode<T>* first, LinkedListNode<T>* last, unsigned int count)
+	{
+		if (size == 0)	//If there are no nodes, the chain replaces the empty head
+		{
+			allocator.Delete(head);
+			head = first;
+			head->previous = nullptr;
+			tail = last;
+			tail->next = end;
+			end->previous = tail;
+		}
+		else if (position == head)
+		{
+			first->previous = nullptr;
+			last->next = head;
+			head->previous = last;
+			head = first;
+		}
+		else
+		{
+			if (position == nullptr)
+				position = end;
+			first->previous = position->previous;
+			position->previous->next = first;
+			last->next = position;
+			position->previous = last;
+			if (position == end)
+				tail = last;
+		}
+		size += count;
+	}
+
+	/// <summary>
+	/// Move a range of values from another list one at a time, for allocators that can't share nodes between lists.
+	/// </summary>
+	/// <param name="iter">The position to insert the values before.</param>
+	/// <param name="other">The list to take the values from.</param>
+	/// <param name="first">The first value to move.</param>
+	/// <param name="last">The position after the last value to move.</param>
+	void MoveValues(LinkedListIterator<T> iter, LinkedList& other, LinkedListIterator<T> first, LinkedListIterator<T> last)
+	{
+		bool atEnd = size == 0 || iter.node == end || iter.node == nullptr;
+		while (other.size > 0 && first.node != nullptr && first.node != other.end && first != last)
+		{
+			if (atEnd)
+				PushBack(move(*first));
+			else
+				Insert(iter, move(*first));
+			first = other.Erase(first);
+		}
+	}
+
+	/// <summary>
+	/// Push a value to the front of the linked list, copying or moving it as it was passed.
+	/// </summary>
+	/// <param name="value">The value to push.</param>
+	template <typename V>
+	void PushFrontValue(V&& value)
+	{
+		if (size == 0)	//If there are no nodes, set the data on the head
+			head->data = forward<V>(value);
+		else
+		{
+			//Create a new node and readjust the head pointer
+			LinkedListNode<T>* newNode = allocator.template New<LinkedListNode<T>>(forward<V>(value), head, nullptr);
+			head->previous = newNode;
+			head = newNode;
+		}
+		++size;
+	}
+
+	/// <summary>
+	/// Push a value to the end of the linked list, copying or moving it as it was passed.
+	/// </summary>
+	/// <param name="value">The value to push.</param>
+	template <typename V>
+	void PushBackValue(V&& value)
+	{
+		if (size == 0)	//If there are no nodes, set the data on the tail
+			tail->data = forward<V>(value);
+		else
+		{
+			//Create a new node and readjust the tail pointer and the end pointer
+			LinkedListNode<T>* newNode = allocator.template New<LinkedListNode<T>>(forward<V>(value), nullptr, tail);
+			tail->next = newNode;
+			tail = newNode;
+			tail->next = end;
+		}
+		end->previous = tail;
+		++size;
+	}
+
+	/// <summary>
+	/// Insert a value before the given iterator, copying or moving it as it was passed.
+	/// </summary>
+	/// <param name="iter">The iterator to insert a node before.</param>
+	/// <param name="value">The value to insert.</param>
+	/// <returns>An iterator pointing to the inserted value.</returns>
+	template <typename V>
+	LinkedListIterator<T> InsertValue(LinkedListIterator<T> iter, V&& value)
+	{
+		//If the linked list is empty or the iterator points to the first position, push to the front
+		if (size == 0 || iter.node == head)
+		{
+			PushFrontValue(forward<V>(value));
+			return Begin();
+		}
+		//If the iterator points to the last position, push to the back
+		else if (iter.node == end)
+		{
+			PushBackValue(forward<V>(value));
+			return LinkedListIterator<T>(tail);
 		}
+		else if (iter.node == nullptr)
+			return End();
 
-		return nullptr;
+		//Link a new node in between the iterator's node and the one before it
+		LinkedListNode<T>* node = iter.node;
+		LinkedListNode<T>* newNode = allocator.template New<LinkedListNode<T>>(forward<V>(value), node, node->previous);
+		node->previous->next = newNode;
+		node->previous = newNode;
+		++size;
+		return LinkedListIterator<T>(newNode);
 	}
 
 	/// <summary>
@@ -280,43 +515,45 @@ public:
 	LinkedList()
 	{
 		//Set all the values to their initial state
-		head = new LinkedListNode<T>(nullptr, nullptr);
-		tail = head;
-		end = new LinkedListNode<T>(nullptr, tail);
-		head->next = end;
-		size = 0;
+		CreateEmpty();
 	}
 	
 	/// <summary>
 	/// Copy constructor.
 	/// </summary>
 	/// <param name="copy">The list we are copying.</param>
-	LinkedList(const LinkedList<T>& copy)
+	LinkedList(const LinkedList& copy)
 	{
 		//Set all the values to their initial state
-		head = new LinkedListNode<T>(nullptr, nullptr);
-		tail = head;
-		end = new LinkedListNode<T>(nullptr, tail);
-		head->next = end;
-		size = 0;
+		CreateEmpty();
 
 		//Iterate through the copy and push its data into this list
 		for (auto i = copy.Begin(); i != copy.End(); ++i)
 			PushBack(*i);
 	}
 
+	/// <summary>
+	/// Move constructor.
+	/// Takes the nodes of another list without copying them, leaving the other list empty.
+	/// </summary>
+	/// <param name="other">The list to take the nodes from.</param>
+	LinkedList(LinkedList&& other)
+	{
+		CreateEmpty();
+		Splice(End(), other);
+	}
+
 	/// <summary>
 	/// Deconstructor.
 	/// </summary>
 	~LinkedList()
 	{
-		//Pop the nodes until none remain
-		while (size > 0)
-			PopFront();
+		//Remove the nodes until none remain
+		Clear();
 
 		//Delete remaining pointers
-		delete end;
-		delete head;
+		allocator.Delete(end);
+		allocator.Delete(head);
 	}
 	
 	/// <summary>
@@ -325,16 +562,16 @@ public:
 	/// <param name="value">The value to push.</param>
 	void PushFront(const T& value)
 	{
-		if (size == 0)	//If there are no nodes, set the data on the head
-			head->data = value;
-		else
-		{
-			//Create a new node and readjust the head pointer
-			LinkedListNode<T>* newNode = new LinkedListNode<T>(value, head, nullptr);
-			head->previous = newNode;
-			head = newNode;
-		}
-		++size;
+		PushFrontValue(value);
+	}
+
+	/// <summary>
+	/// Push a value to the front of the linked list, moving it rather than copying it.
+	/// </summary>
+	/// <param name="value">The value to move into the list.</param>
+	void PushFront(T&& value)
+	{
+		PushFrontValue(move(value));
 	}
 
 	/// <summary>
@@ -355,7 +592,7 @@ public:
 		{
 			//Delete the head and readjust the pointers
 			head = head->next;
-			delete head->previous;
+			allocator.Delete(head->previous);
 			head->previous = nullptr;
 		}
 		--size;
@@ -367,18 +604,16 @@ public:
 	/// <param name="value">The value to push.</param>
 	void PushBack(const T& value)
 	{
-		if (size == 0)	//If there are no nodes, set the data on the tail
-			tail->data = value;
-		else
-		{
-			//Create a new node and readjust the tail pointer and the end pointer
-			LinkedListNode<T>* newNode = new LinkedListNode<T>(value, nullptr, tail);
-			tail->next = newNode;
-			tail = newNode;
-			tail->next = end;
-		}
-		end->previous = tail;
-		++size;
+		PushBackValue(value);
+	}
+
+	/// <summary>
+	/// Push a value to the end of the linked list, moving it rather than copying it.
+	/// </summary>
+	/// <param name="value">The value to move into the list.</param>
+	void PushBack(T&& value)
+	{
+		PushBackValue(move(value));
 	}
 
 	/// <summary>
@@ -399,7 +634,7 @@ public:
 		{
 			//Delete the tail and readjust the pointers, and set the end pointer
 			tail = tail->previous;
-			delete tail->next;
+			allocator.Delete(tail->next);
 			tail->next = end;
 			end->previous = tail;
 		}
@@ -408,80 +643,295 @@ public:
 
 	/// <summary>
 	/// Inserts a value before the given iterator.
+	/// Takes constant time, as the iterator already points to its node.
 	/// </summary>
 	/// <param name="iter">The iterator to insert a node before.</param>
 	/// <param name="value">The value to insert into the linked list.</param>
-	void Insert(LinkedListIterator<T>& iter, const T& value)
+	/// <returns>An iterator pointing to the inserted value.</returns>
+	LinkedListIterator<T> Insert(LinkedListIterator<T> iter, const T& value)
 	{
-		//If the linked list is empty or the iterator points to the first position, push to the front
-		if (size == 0 || iter == Begin())
-			PushFront(value);
-		//If the iterator points to the last position, push to the back
-		else if (iter == End())
-			PushBack(value);
-		else
+		return InsertValue(iter, value);
+	}
+
+	/// <summary>
+	/// Inserts a value before the given iterator, moving it rather than copying it.
+	/// Takes constant time, as the iterator already points to its node.
+	/// </summary>
+	/// <param name="iter">The iterator to insert a node before.</param>
+	/// <param name="value">The value to move into the linked list.</param>
+	/// <returns>An iterator pointing to the inserted value.</returns>
+	LinkedListIterator<T> Insert(LinkedListIterator<T> iter, T&& value)
+	{
+		return InsertValue(iter, move(value));
+	}
+
+	/// <summary>
+	/// Remove all occurrences of a specific value from the linked list.
+	/// </summary>
+	/// <param name="value">The value to remove from the linked list.</param>
+	void Remove(const T& value)
+	{
+		//Copy the value as it could be in a node that is about to be deleted
+		T target = value;
+
+		//Walk the nodes once, removing the matches as they are found
+		LinkedListNode<T>* node = head;
+		while (size > 0 && node != end)
 		{
-			//Find the node
-			LinkedListNode<T>* node = FindNode(iter);
-			if (node != nullptr)
+			LinkedListNode<T>* next = node->next;
+			if (node->data == target)
+				Remove(node);
+			node = next;
+		}
+	}
+
+	/// <summary>
+	/// Erase a specific node from the linked list.
+	/// Takes constant time, as the iterator already points to its node.
+	/// </summary>
+	/// <param name="iter">The position of the node to remove.</param>
+	/// <returns>An iterator pointing to the node after the erased one, so nodes can be erased while iterating.</returns>
+	LinkedListIterator<T> Erase(LinkedListIterator<T> iter)
+	{
+		LinkedListNode<T>* node = iter.node;
+		if (size == 0 || node == nullptr || node == end)
+			return End();
+
+		LinkedListNode<T>* next = node->next;
+		Remove(node);
+		return next == end ? End() : LinkedListIterator<T>(next);
+	}
+
+	/// <summary>
+	/// Erase the nodes from one iterator up to, but not including, another.
+	/// Takes time proportional to the number of nodes erased.
+	/// </summary>
+	/// <param name="first">The first node to remove.</param>
+	/// <param name="last">The node after the last one to remove, e.g. End().</param>
+	/// <returns>An iterator pointing to the node after the erased ones.</returns>
+	LinkedListIterator<T> Erase(LinkedListIterator<T> first, LinkedListIterator<T> last)
+	{
+		LinkedListNode<T>* node = first.node;
+		while (size > 0 && node != nullptr && node != last.node && node != end)
+		{
+			LinkedListNode<T>* next = node->next;
+			Remove(node);
+			node = next;
+		}
+		return size == 0 || node == nullptr || node == end ? End() : LinkedListIterator<T>(node);
+	}
+
+	/// <summary>
+	/// Move every node of another linked list into this one before a position, leaving the other list empty.
+	/// Takes constant time, as the nodes are relinked rather than copied. Iterators to the moved values stay valid and now belong to this list.
+	/// If the allocator doesn't let lists share nodes (e.g. PoolAllocator<>), the values are moved one at a time instead.
+	/// </summary>
+	/// <param name="iter">The position to insert the nodes before, e.g. End().</param>
+	/// <param name="other">The list to take the nodes from.</param>
+	void Splice(LinkedListIterator<T> iter, LinkedList& other)
+	{
+		if (&other == this || other.size == 0)
+			return;
+
+		if constexpr (Allocator::SHARED_NODES)
+		{
+			if (size == 0)
 			{
-				//Insert the node into the linked list
-				LinkedListNode<T>* newNode = new LinkedListNode<T>(value, node, node->previous);
-				node->previous->next = newNode;
-				node->previous = newNode;
+				//Swap the lists, so the other list takes this list's empty head instead of allocating a new one
+				swap(head, other.head);
+				swap(tail, other.tail);
+				swap(end, other.end);
+				swap(size, other.size);
+			}
+			else
+			{
+				LinkedListNode<T>* first = other.head;
+				LinkedListNode<T>* last = other.tail;
+				unsigned int count = other.size;
+				other.Unlink(first, last, count);
+				Link(iter.node, first, last, count);
 			}
 		}
+		else
+			MoveValues(iter, other, other.Begin(), other.End());
 	}
 
 	/// <summary>
-	/// Remove all occurrences of a specific value from the linked list.
+	/// Move a range of nodes from another linked list, or from elsewhere in this one, into this list before a position.
+	/// The nodes are relinked rather than copied. Moving within this list or moving the whole of the other list takes constant time,
+	/// otherwise the moved nodes are counted, taking time proportional to their number.
+	/// The position must not be inside the range.
 	/// </summary>
-	/// <param name="value">The value to remove from the linked list.</param>
-	void Remove(const T& value)
+	/// <param name="iter">The position to insert the nodes before, e.g. End().</param>
+	/// <param name="other">The list to take the nodes from, which can be this list.</param>
+	/// <param name="first">The first node to move.</param>
+	/// <param name="last">The node after the last one to move, e.g. other.End().</param>
+	void Splice(LinkedListIterator<T> iter, LinkedList& other, LinkedListIterator<T> first, LinkedListIterator<T> last)
 	{
-		if (size == 0)	//If there are no nodes then return
+		if (other.size == 0 || first.node == nullptr || first.node == other.end || first == last)
 			return;
+
+		LinkedListNode<T>* lastNode = last.node == nullptr || last.node == other.end ? other.tail : last.node->previous;
+		if (&other == this)
+		{
+			//Moving the range to where it already is changes nothing, and the size stays the same
+			if ((first.node == head && lastNode == tail) || iter.node == first.node)
+				return;
+			Unlink(first.node, lastNode, 0);
+			Link(iter.node, first.node, lastNode, 0);
+		}
+		else if constexpr (Allocator::SHARED_NODES)
+		{
+			if (first.node == other.head && lastNode == other.tail)
+			{
+				Splice(iter, other);
+				return;
+			}
+
+			unsigned int count = 1;
+			for (LinkedListNode<T>* node = first.node; node != lastNode; node = node->next)
+				++count;
+			other.Unlink(first.node, lastNode, count);
+			Link(iter.node, first.node, lastNode, count);
+		}
 		else
+			MoveValues(iter, other, first, last);
+	}
+
+	/// <summary>
+	/// Split the linked list in two at a position. This list keeps the values before the position and the rest are moved to a new list.
+	/// The nodes are relinked rather than copied. Counting them takes time proportional to the shorter of the two halves.
+	/// </summary>
+	/// <param name="iter">The first value to move to the new list.</param>
+	/// <returns>A list of the values from the position to the end.</returns>
+	LinkedList SplitAt(LinkedListIterator<T> iter)
+	{
+		LinkedList rest;
+		if (size == 0 || iter.node == nullptr || iter.node == end)
+			return rest;
+
+		if constexpr (Allocator::SHARED_NODES)
 		{
-			//Loop through the nodes in the linked list and push the ones to be removed to another linked list
-			LinkedListNode<T>* node = head;
-			LinkedList<LinkedListNode<T>*> toRemove = LinkedList<LinkedListNode<T>*>();
-			while (node != end)
+			if (iter.node == head)
 			{
-				//If the data matches the value to remove add it to the list of nodes to be removed
-				if (node->data == value)
-					toRemove.PushBack(node);
-				node = node->next;
+				rest.Splice(rest.End(), *this);
+				return rest;
 			}
 
-			//Loop through the nodes in the list of nodes to remove, removing the nodes one by one
-			while (toRemove.Size() > 0)
+			//Count the nodes from the position to the end and from the position back to the start at the same time,
+			//stopping at whichever end is reached first
+			unsigned int count;
+			unsigned int before = 0;
+			unsigned int after = 0;
+			LinkedListNode<T>* forward = iter.node;
+			LinkedListNode<T>* backward = iter.node->previous;
+			while (true)
 			{
-				Remove(toRemove.Last());
-				toRemove.PopBack();
+				if (forward == end)
+				{
+					count = after;
+					break;
+				}
+				++after;
+				forward = forward->next;
+
+				if (backward == nullptr)
+				{
+					count = size - before;
+					break;
+				}
+				++before;
+				backward = backward->previous;
 			}
+
+			LinkedListNode<T>* last = tail;
+			Unlink(iter.node, last, count);
+			rest.Link(rest.end, iter.node, last, count);
 		}
+		else
+			rest.Splice(rest.End(), *this, iter, End());
+		return rest;
 	}
 
 	/// <summary>
-	/// Erase a specific node from the linked list.
+	/// Merge another sorted linked list into this sorted one, leaving the other list empty.
+	/// The nodes are relinked rather than copied, so it takes linear time without allocating a node for each value.
+	/// The merge is stable: of two equal values, the one already in this list comes first.
 	/// </summary>
-	/// <param name="iter">The position of the node to remove.</param>
-	void Erase(LinkedListIterator<T>& iter)
+	/// <param name="other">The sorted list to take the nodes from.</param>
+	void Merge(LinkedList& other)
 	{
-		LinkedListNode<T>* node = FindNode(iter);
-		if (node != nullptr)
-			Remove(node);
+		Merge(other, less<T>());
+	}
+
+	/// <summary>
+	/// Merge another linked list into this one, both sorted with a custom ordering, leaving the other list empty.
+	/// </summary>
+	/// <param name="other">The sorted list to take the nodes from.</param>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	template <typename Compare>
+	void Merge(LinkedList& other, Compare comp)
+	{
+		if (&other == this || other.size == 0)
+			return;
+
+		if constexpr (Allocator::SHARED_NODES)
+		{
+			if (size == 0)
+			{
+				Splice(End(), other);
+				return;
+			}
+
+			//Detach both chains of nodes from their end nodes, merge them, then reattach this list's end node
+			NodeChain chain = { head, tail };
+			NodeChain otherChain = { other.head, other.tail };
+			unsigned int count = other.size;
+			other.Unlink(otherChain.first, otherChain.last, count);
+			tail->next = nullptr;
+
+			NodeChain merged = MergeChains(chain, otherChain, comp);
+			head = merged.first;
+			tail = merged.last;
+			tail->next = end;
+			end->previous = tail;
+			size += count;
+		}
+		else
+		{
+			//Insert each of the other list's values before the first value in this list that comes after it
+			LinkedListNode<T>* node = size > 0 ? head : end;
+			for (LinkedListNode<T>* value = other.head; value != other.end; value = value->next)
+			{
+				while (node != end && !comp(value->data, node->data))
+					node = node->next;
+				if (node == end)
+					PushBack(move(value->data));
+				else
+					Insert(LinkedListIterator<T>(node), move(value->data));
+			}
+			other.Clear();
+		}
 	}
 
 	/// <summary>
 	/// Clear all values from the linked list.
+	/// If the allocator can release every node at once and the nodes don't need destroying, this takes constant time.
 	/// </summary>
 	void Clear()
 	{
-		//Pop the front node until there are no more nodes
-		while (size > 0)
-			PopFront();
+		if constexpr (Allocator::BULK_RELEASE && is_trivially_destructible_v<LinkedListNode<T>>)
+		{
+			//Release the nodes, including the head and end, and start again with new ones
+			allocator.Reset();
+			CreateEmpty();
+		}
+		else
+		{
+			//Pop the front node until there are no more nodes
+			while (size > 0)
+				PopFront();
+		}
 	}
 
 	/// <summary>
@@ -504,6 +954,7 @@ public:
 
 	/// <summary>
 	/// Sort the linked list using a bubble sort.
+	/// Takes O(n^2) time and copies the values to swap them, so MergeSort() should be preferred.
 	/// </summary>
 	void BubbleSort()
 	{
@@ -530,19 +981,109 @@ public:
 		}
 	}
 
+	/// <summary>
+	/// Sort the linked list using a bottom-up merge sort.
+	/// Takes O(n log n) time, is stable and allocates nothing. The nodes are relinked rather than their values copied,
+	/// so iterators stay pointing to the same values.
+	/// </summary>
+	void MergeSort()
+	{
+		MergeSort(less<T>());
+	}
+
+	/// <summary>
+	/// Sort the linked list using a bottom-up merge sort with a custom ordering.
+	/// The nodes are taken one at a time and counted up in binary: run i holds 2^i sorted nodes,
+	/// and when a run of the same length already exists the two are merged and carried up to the next run.
+	/// Merging runs while they are small and recently touched keeps the nodes in the cache,
+	/// unlike merging the whole list once for each doubling of the run length.
+	/// </summary>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	template <typename Compare>
+	void MergeSort(Compare comp)
+	{
+		if (size < 2)
+			return;
+
+		NodeChain runs[sizeof(size) * 8 + 1] = {};	//Enough runs to count up to any size
+		LinkedListNode<T>* node = head;
+		for (unsigned int i = 0; i < size; ++i)
+		{
+			//Detach the node, then merge it into the runs like adding 1 to a binary number.
+			//Each run holds nodes from earlier in the list than the carry, so it goes first to keep the sort stable.
+			NodeChain carry = { node, node };
+			node = node->next;
+			carry.first->next = nullptr;
+			carry.first->previous = nullptr;
+
+			size_t r = 0;
+			for (; runs[r].first != nullptr; ++r)
+			{
+				carry = MergeChains(runs[r], carry, comp);
+				runs[r].first = nullptr;
+			}
+			runs[r] = carry;
+		}
+
+		//Merge the runs that are left, from the shortest (latest nodes) to the longest (earliest nodes)
+		NodeChain sorted = { nullptr, nullptr };
+		for (size_t r = 0; r < sizeof(runs) / sizeof(runs[0]); ++r)
+			if (runs[r].first != nullptr)
+				sorted = MergeChains(runs[r], sorted, comp);
+
+		//Reattach the end node to the sorted chain
+		head = sorted.first;
+		tail = sorted.last;
+		tail->next = end;
+		end->previous = tail;
+	}
+
 	/// <summary>
 	/// Performa basic linear search for a value.
+	/// Walks the nodes directly rather than going through the iterator's checks.
 	/// </summary>
 	/// <param name="value">The value to search for.</param>
 	/// <returns>The iterator pointing to the value if found, otherwise points to End().</returns>
 	LinkedListIterator<T> LinearSearch(const T& value) const
 	{
-		for (LinkedListIterator<T> iter = Begin(); iter != End(); ++iter)
-			if (*iter == value)
-				return iter;
+		if (size == 0)
+			return End();
+
+		for (LinkedListNode<T>* node = head; node != end; node = node->next)
+			if (node->data == value)
+				return LinkedListIterator<T>(node);
 		return End();
 	}
 
+	/// <summary>
+	/// Write the linked list to a binary writer, from the first node to the last.
+	/// The nodes are streamed through the writer's buffer, so nothing the size of the list is allocated.
+	/// </summary>
+	/// <param name="writer">The writer to write to.</param>
+	void Serialize(BinaryWriter& writer) const
+	{
+		writer.WriteHeader<T>(SERIAL_LINKED_LIST, size);
+		LinkedListNode<T>* node = head;
+		for (unsigned int i = 0; i < size; ++i, node = node->next)
+			writer.WriteValue(node->data);
+	}
+
+	/// <summary>
+	/// Replace the values of the linked list with a linked list read from a binary reader.
+	/// </summary>
+	/// <param name="reader">The reader to read from.</param>
+	void Deserialize(BinaryReader& reader)
+	{
+		size_t count = reader.ReadHeader<T>(SERIAL_LINKED_LIST);
+		Clear();
+		for (size_t i = 0; i < count; ++i)
+		{
+			T value;
+			reader.ReadValue(value);
+			PushBack(value);
+		}
+	}
+
 	/// <summary>
 	/// Getter for the first value in the linked list.
 	/// </summary>
@@ -595,7 +1136,7 @@ public:
 	/// </summary>
 	/// <param name="other">The list to copy the values from.</param>
 	/// <returns>This linked list with the values from the other linked list.</returns>
-	LinkedList<T>& operator= (const LinkedList<T>& other)
+	LinkedList& operator= (const LinkedList& other)
 	{
 		//Clear this linked list first to clean up memory
 		Clear();
@@ -605,6 +1146,22 @@ public:
 		return *this;
 	}
 
+	/// <summary>
+	/// Move assignment operator overload.
+	/// Takes the nodes of another list without copying them, leaving the other list empty.
+	/// </summary>
+	/// <param name="other">The list to take the nodes from.</param>
+	/// <returns>This linked list with the nodes from the other linked list.</returns>
+	LinkedList& operator= (LinkedList&& other)
+	{
+		if (this != &other)
+		{
+			Clear();
+			Splice(End(), other);
+		}
+		return *this;
+	}
+
 	/// <summary>
 	/// << operator overload.
 	/// Allows displaying the linked list to an output stream.	
@@ -612,7 +1169,7 @@ public:
 	/// <param name="os">The output stream to display to.</param>
 	/// <param name="list">The linked list to display.</param>
 	/// <returns>The output stream with the linked list displayed to it.</returns>
-	friend ostream& operator<< (ostream& os, const LinkedList<T>& list)
+	friend ostream& operator<< (ostream& os, const LinkedList& list)
 	{
 		os << "[";
 		//Iterate through the linked list and output the data to the output stream
@@ -627,27 +1184,54 @@ public:
 	}
 
 	/// <summary>
-	/// Print details about the linked list to std::cout.
+	/// Append the linked list to a text buffer in the same format as the << operator.
+	/// Walks the nodes directly rather than going through the iterator's checks.
 	/// </summary>
-	void PrintDetails()
+	/// <param name="buffer">The buffer to append to.</param>
+	/// <param name="maxElements">The most elements to show, the rest are replaced by "...".</param>
+	void Format(TextBuffer& buffer, size_t maxElements = FORMAT_ALL) const
 	{
-		cout << "Size: " << size << "   ";
-		for (auto i = Begin(); i != End(); ++i)
+		size_t shown = size < maxElements ? size : maxElements;
+		buffer.Append('[');
+		LinkedListNode<T>* node = head;
+		for (size_t i = 0; i < shown; ++i, node = node->next)
 		{
-			cout << *i;
-			cout << " ";
+			if (i != 0)
+				buffer.Append(", ");
+			buffer.Append(node->data);
 		}
-		cout << endl;
+		if (shown < size)
+			buffer.Append(shown == 0 ? "..." : ", ...");
+		buffer.Append(']');
+	}
+
+	/// <summary>
+	/// Print details about the linked list to std::cout.
+	/// The line is formatted in a buffer and written in one piece, without flushing std::cout.
+	/// </summary>
+	/// <param name="maxElements">The most elements to show, the rest are replaced by "...".</param>
+	void PrintDetails(size_t maxElements = FORMAT_ALL) const
+	{
+		size_t shown = size < maxElements ? size : maxElements;
+		TextBuffer& buffer = ScratchTextBuffer();
+		buffer.Append("Size: ").Append(size).Append("   ");
+		LinkedListNode<T>* node = head;
+		for (size_t i = 0; i < shown; ++i, node = node->next)
+			buffer.Append(node->data).Append(' ');
+		if (shown < size)
+			buffer.Append("... ");
+		buffer.Append('\n').WriteTo(cout);
 	}
 
 	/// <summary>
 	/// Get the list represented as a string.
 	/// </summary>
+	/// <param name="maxElements">The most elements to show, the rest are replaced by "...".</param>
 	/// <returns>A string representation of the list.</returns>
-	string ToString() const
+	string ToString(size_t maxElements = FORMAT_ALL) const
 	{
-		ostringstream stream;
-		stream << *this;
-		return stream.str();
+		TextBuffer buffer;
+		Format(buffer, maxElements);
+		return buffer.Str();
 	}
 };
\ No newline at end of file
@@ -0,0 +1,597 @@
+/*
+	File: MappedList.h
+	Contains: MappedList
+*/
+
+#pragma once
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include "DynamicList.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/// <summary>
+/// The header at the start of a mapped list file.
+/// The elements start MAPPED_LIST_HEADER_SIZE bytes into the file.
+/// </summary>
+struct MappedListHeader
+{
+	char magic[8];				//"MAPLIST" and a null, so other files aren't mistaken for a list
+	uint32_t version;			//The version of the file format
+	uint32_t elementSize;		//sizeof(T) of the list that wrote the file
+	uint64_t count;				//The number of elements in the list
+	uint32_t flags;				//MAPPED_LIST_SORTED if the list was known to be sorted
+	uint32_t reserved;
+};
+
+static const char MAPPED_LIST_MAGIC[8] = { 'M', 'A', 'P', 'L', 'I', 'S', 'T', '\0' };
+static const uint32_t MAPPED_LIST_VERSION = 1;
+static const uint32_t MAPPED_LIST_SORTED = 1;
+static const size_t MAPPED_LIST_HEADER_SIZE = 64;		//Leaves the elements aligned to a cache line
+
+/// <summary>
+/// The ways a mapped list can open its file.
+/// </summary>
+enum MAPPING_MODE
+{
+	READ_ONLY,		//The file is never changed. The elements can still be changed (e.g. sorted) in memory, and the list can't grow
+	READ_WRITE		//Changes are written to the file, which is created if it doesn't exist and grows with the list
+};
+
+/// <summary>
+/// The Mapped List is a List whose elements live in a memory-mapped file, for saving and loading large lists of plain records.
+/// Opening a file only maps it, so loading is near-instant whatever its size and pages are read from disk as they are used.
+/// The file starts with a small versioned header, followed by the elements as raw bytes, so the type must be trivially copyable.
+/// It has List's searches, sorts and aggregates (they work in place on the mapped elements) and the List methods that add and remove elements.
+/// Growing extends the file and remaps it, so like List, pointers to elements are invalidated when the list grows.
+/// </summary>
+template <typename T>
+class MappedList : private List<T>
+{
+private:
+	typedef List<T> Base;
+
+	static_assert(is_trivially_copyable_v<T>, "A mapped list stores its elements as raw bytes, so they must be trivially copyable.");
+	static_assert(alignof(T) <= MAPPED_LIST_HEADER_SIZE, "The elements must be aligned within the header size.");
+
+	static const size_t INITIAL_CAPACITY = 1024;	//The capacity of a new file
+
+	string path;			//The path of the file
+	MAPPING_MODE mode;		//How the file was opened
+	unsigned char* view;	//The start of the mapping, which is the header
+	size_t viewSize;		//The size of the mapping in bytes
+#ifdef _WIN32
+	HANDLE file;			//The file handle
+	HANDLE mapping;			//The file mapping handle
+#else
+	int file;				//The file descriptor
+#endif
+
+	/// <summary>
+	/// Get the header at the start of the mapping.
+	/// </summary>
+	/// <returns>The header.</returns>
+	MappedListHeader* Header() const
+	{
+		return reinterpret_cast<MappedListHeader*>(view);
+	}
+
+	/// <summary>
+	/// Calculate the number of elements that fit in a file.
+	/// </summary>
+	/// <param name="bytes">The size of the file.</param>
+	/// <returns>The number of elements after the header.</returns>
+	static size_t CapacityOf(size_t bytes)
+	{
+		return (bytes - MAPPED_LIST_HEADER_SIZE) / sizeof(T);
+	}
+
+	/// <summary>
+	/// Throw an exception for a failed file operation, closing the file first.
+	/// </summary>
+	/// <param name="action">What was being done, e.g. "map".</param>
+	[[noreturn]] void Fail(const string& action)
+	{
+		Close();
+		throw runtime_error("Could not " + action + " " + path + ".");
+	}
+
+	/// <summary>
+	/// Map the first part of the file into memory, replacing any mapping there already is.
+	/// </summary>
+	/// <param name="bytes">The number of bytes to map, which must not be more than the size of the file.</param>
+	void Map(size_t bytes)
+	{
+#ifdef _WIN32
+		if (view != nullptr)
+			UnmapViewOfFile(view);
+		if (mapping != nullptr)
+			CloseHandle(mapping);
+		view = nullptr;
+
+		mapping = CreateFileMappingA(file, nullptr, mode == READ_WRITE ? PAGE_READWRITE : PAGE_WRITECOPY,
+			(DWORD)((uint64_t)bytes >> 32), (DWORD)((uint64_t)bytes & 0xFFFFFFFF), nullptr);
+		if (mapping == nullptr)
+			Fail("map");
+		view = static_cast<unsigned char*>(MapViewOfFile(mapping, mode == READ_WRITE ? FILE_MAP_WRITE : FILE_MAP_COPY, 0, 0, bytes));
+		if (view == nullptr)
+			Fail("map");
+#else
+		void* address;
+#ifdef __linux__
+		if (view != nullptr)
+			address = mremap(view, viewSize, bytes, MREMAP_MAYMOVE);
+		else
+#else
+		if (view != nullptr)
+			munmap(view, viewSize);
+#endif
+			address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, mode == READ_WRITE ? MAP_SHARED : MAP_PRIVATE, file, 0);
+		if (address == MAP_FAILED)
+		{
+			view = nullptr;
+			Fail("map");
+		}
+		view = static_cast<unsigned char*>(address);
+#endif
+		viewSize = bytes;
+	}
+
+	/// <summary>
+	/// Change the size of the file.
+	/// </summary>
+	/// <param name="bytes">The new size of the file.</param>
+	void ResizeFile(size_t bytes)
+	{
+#ifdef _WIN32
+		//The file can't be resized while it is mapped
+		if (view != nullptr)
+			UnmapViewOfFile(view);
+		if (mapping != nullptr)
+			CloseHandle(mapping);
+		view = nullptr;
+		mapping = nullptr;
+
+		LARGE_INTEGER position;
+		position.QuadPart = (LONGLONG)bytes;
+		if (!SetFilePointerEx(file, position, nullptr, FILE_BEGIN) || !SetEndOfFile(file))
+			Fail("resize");
+#else
+		if (ftruncate(file, (off_t)bytes) != 0)
+			Fail("resize");
+#endif
+	}
+
+	/// <summary>
+	/// Write the number of elements and whether they are sorted into the header.
+	/// </summary>
+	void WriteHeader()
+	{
+		MappedListHeader* header = Header();
+		header->count = Base::Size();
+		header->flags = Base::KnownSorted() ? MAPPED_LIST_SORTED : 0;
+	}
+
+	/// <summary>
+	/// Grow or shrink the file to fit a number of elements and map it again, moving the list to the new mapping.
+	/// </summary>
+	/// <param name="newCapacity">The number of elements the file should hold.</param>
+	void Remap(size_t newCapacity)
+	{
+		if (mode == READ_ONLY)
+			throw logic_error("A read only mapped list can't grow.");
+		if (newCapacity > (numeric_limits<size_t>::max() - MAPPED_LIST_HEADER_SIZE) / sizeof(T))
+			throw length_error("Capacity exceeds the maximum capacity of the list.");
+
+		WriteHeader();
+		size_t bytes = MAPPED_LIST_HEADER_SIZE + newCapacity * sizeof(T);
+		bool growing = bytes > viewSize;
+
+		//Grow the file before mapping more of it, and only shrink it once the mapping is smaller
+		if (growing)
+			ResizeFile(bytes);
+		Map(bytes);
+		if (!growing)
+		{
+			ResizeFile(bytes);
+#ifdef _WIN32
+			Map(bytes);
+#endif
+		}
+		Base::AdoptStorage(reinterpret_cast<T*>(view + MAPPED_LIST_HEADER_SIZE), newCapacity, Header()->count, (Header()->flags & MAPPED_LIST_SORTED) != 0);
+	}
+
+	/// <summary>
+	/// Make sure the file has room for a number of elements, growing it geometrically if it doesn't.
+	/// </summary>
+	/// <param name="needed">The number of elements that must fit.</param>
+	void EnsureCapacity(size_t needed)
+	{
+		size_t capacity = Base::Capacity();
+		if (needed <= capacity)
+			return;
+
+		size_t newCapacity = capacity * 2 > needed ? capacity * 2 : needed;
+		Remap(newCapacity);
+	}
+
+	/// <summary>
+	/// Unmap and close the file without saving the header.
+	/// </summary>
+	void Close()
+	{
+		Base::Release();
+#ifdef _WIN32
+		if (view != nullptr)
+			UnmapViewOfFile(view);
+		if (mapping != nullptr)
+			CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE)
+			CloseHandle(file);
+		mapping = nullptr;
+		file = INVALID_HANDLE_VALUE;
+#else
+		if (view != nullptr)
+			munmap(view, viewSize);
+		if (file != -1)
+			close(file);
+		file = -1;
+#endif
+		view = nullptr;
+		viewSize = 0;
+	}
+
+public:
+	/// <summary>
+	/// Overloaded constructor.
+	/// Opens and maps a mapped list file. Nothing is read until the elements are used.
+	/// </summary>
+	/// <param name="_path">The file to open.</param>
+	/// <param name="_mode">How to open the file. READ_WRITE creates the file if it doesn't exist.</param>
+	MappedList(const string& _path, MAPPING_MODE _mode = READ_WRITE) : Base(nullptr, 0)
+	{
+		path = _path;
+		mode = _mode;
+		view = nullptr;
+		viewSize = 0;
+
+		//Open the file and find its size
+		size_t bytes;
+#ifdef _WIN32
+		mapping = nullptr;
+		file = CreateFileA(path.c_str(), GENERIC_READ | (mode == READ_WRITE ? GENERIC_WRITE : 0), FILE_SHARE_READ, nullptr,
+			mode == READ_WRITE ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			Fail("open");
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize))
+			Fail("open");
+		bytes = (size_t)fileSize.QuadPart;
+#else
+		file = open(path.c_str(), mode == READ_WRITE ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+		if (file == -1)
+			Fail("open");
+		struct stat status;
+		if (fstat(file, &status) != 0)
+			Fail("open");
+		bytes = (size_t)status.st_size;
+#endif
+
+		//A new file is given a header and room for the initial capacity
+		bool created = bytes == 0 && mode == READ_WRITE;
+		if (created)
+		{
+			bytes = MAPPED_LIST_HEADER_SIZE + INITIAL_CAPACITY * sizeof(T);
+			ResizeFile(bytes);
+		}
+		if (bytes < MAPPED_LIST_HEADER_SIZE)
+		{
+			Close();
+			throw runtime_error(path + " is not a mapped list file.");
+		}
+		Map(bytes);
+
+		MappedListHeader* header = Header();
+		if (created)
+		{
+			memset(header, 0, MAPPED_LIST_HEADER_SIZE);
+			memcpy(header->magic, MAPPED_LIST_MAGIC, sizeof(MAPPED_LIST_MAGIC));
+			header->version = MAPPED_LIST_VERSION;
+			header->elementSize = (uint32_t)sizeof(T);
+		}
+
+		//Check that the file holds a list of this type before using it
+		const char* problem = nullptr;
+		if (memcmp(header->magic, MAPPED_LIST_MAGIC, sizeof(MAPPED_LIST_MAGIC)) != 0)
+			problem = " is not a mapped list file.";
+		else if (header->version != MAPPED_LIST_VERSION)
+			problem = " was written by a different version of MappedList.";
+		else if (header->elementSize != sizeof(T))
+			problem = " holds elements of a different size.";
+		else if (header->count > CapacityOf(bytes))
+			problem = " is shorter than its header says.";
+		if (problem != nullptr)
+		{
+			Close();
+			throw runtime_error(path + problem);
+		}
+
+		Base::AdoptStorage(reinterpret_cast<T*>(view + MAPPED_LIST_HEADER_SIZE), CapacityOf(bytes), (size_t)header->count,
+			(header->flags & MAPPED_LIST_SORTED) != 0);
+	}
+
+	MappedList(const MappedList&) = delete;
+	MappedList& operator= (const MappedList&) = delete;
+
+	/// <summary>
+	/// Deconstructor.
+	/// Saves the header and unmaps the file. The operating system writes the changed elements back to the file.
+	/// </summary>
+	~MappedList()
+	{
+		if (mode == READ_WRITE && view != nullptr)
+			WriteHeader();
+		Close();
+	}
+
+	/// <summary>
+	/// Save the header and wait for every change to be written to the disk.
+	/// Does nothing for a read only list.
+	/// </summary>
+	void Flush()
+	{
+		if (mode == READ_ONLY)
+			return;
+
+		WriteHeader();
+#ifdef _WIN32
+		if (!FlushViewOfFile(view, 0) || !FlushFileBuffers(file))
+			throw runtime_error("Could not flush " + path + ".");
+#else
+		if (msync(view, viewSize, MS_SYNC) != 0)
+			throw runtime_error("Could not flush " + path + ".");
+#endif
+	}
+
+	/// <summary>
+	/// Make sure the file has room for a number of elements.
+	/// Does nothing if the capacity is already large enough.
+	/// </summary>
+	/// <param name="newCapacity">The minimum capacity the list should have.</param>
+	void Reserve(size_t newCapacity)
+	{
+		if (newCapacity > Base::Capacity())
+			Remap(newCapacity);
+	}
+
+	/// <summary>
+	/// Shrink the file to fit the elements.
+	/// </summary>
+	void ShrinkToFit()
+	{
+		size_t newCapacity = Base::Size() > 0 ? Base::Size() : 1;
+		if (mode == READ_WRITE && newCapacity != Base::Capacity())
+			Remap(newCapacity);
+		Base::ShrinkToFit();
+	}
+
+	/// <summary>
+	/// Push a new value to the list, growing the file if it will not fit.
+	/// </summary>
+	/// <param name="value">The value to push to the list.</param>
+	void Push(const T& value)
+	{
+		//Copy the value first, it could be an element that moves when the file is remapped
+		T copy = value;
+		EnsureCapacity(Base::Size() + 1);
+		Base::Push(copy);
+	}
+
+	/// <summary>
+	/// Construct a new value at the end of the list, growing the file if it will not fit.
+	/// </summary>
+	/// <param name="args">The arguments to pass to the value's constructor.</param>
+	/// <returns>The new value.</returns>
+	template <typename... Args>
+	T& EmplaceBack(Args&&... args)
+	{
+		T value(forward<Args>(args)...);
+		EnsureCapacity(Base::Size() + 1);
+		return Base::EmplaceBack(value);
+	}
+
+	/// <summary>
+	/// Insert a value at a specified index in the list, growing the file if it will not fit.
+	/// </summary>
+	/// <param name="index">The index to insert at.</param>
+	/// <param name="value">The value to insert.</param>
+	void Insert(size_t index, const T& value)
+	{
+		T copy = value;
+		EnsureCapacity(Base::Size() + 1);
+		Base::Insert(index, copy);
+	}
+
+	/// <summary>
+	/// Insert an array of values at a specific index in this list, growing the file if they will not fit.
+	/// </summary>
+	/// <param name="index">The index to insert the values.</param>
+	/// <param name="values">The values to insert.</param>
+	/// <param name="count">The number of values to insert.</param>
+	void Insert(size_t index, const T* values, size_t count)
+	{
+		if (index > Base::Size() || count == 0)
+			return;
+
+		//Values from this list would move when the file is remapped, so copy them out first
+		const T* first = Base::Data();
+		if (values >= first && values < first + Base::Size() && Base::Size() + count > Base::Capacity())
+		{
+			List<T> copy(count);
+			copy.Insert(0, values, count);
+			Insert(index, copy.Data(), count);
+			return;
+		}
+
+		EnsureCapacity(Base::Size() + count);
+		Base::Insert(index, values, count);
+	}
+
+	/// <summary>
+	/// Insert a list at a specific index in this list, growing the file if it will not fit.
+	/// </summary>
+	/// <param name="index">The index to insert the list.</param>
+	/// <param name="values">The list.</param>
+	void Insert(size_t index, const List<T>& values)
+	{
+		Insert(index, values.Data(), values.Size());
+	}
+
+	/// <summary>
+	/// Get the list as a read only List, to pass to anything that takes a List.
+	/// </summary>
+	/// <returns>The list.</returns>
+	const List<T>& AsList() const
+	{
+		return *this;
+	}
+
+	/// <summary>
+	/// Getter for the path of the file.
+	/// </summary>
+	/// <returns>The path the list was opened from.</returns>
+	const string& Path() const
+	{
+		return path;
+	}
+
+	/// <summary>
+	/// Getter for how the file was opened.
+	/// </summary>
+	/// <returns>READ_ONLY or READ_WRITE.</returns>
+	MAPPING_MODE Mode() const
+	{
+		return mode;
+	}
+
+	/// <summary>
+	/// Sort the list in place using a recursive quick sort.
+	/// </summary>
+	void QuickSort()
+	{
+		Base::QuickSort();
+	}
+
+	/// <summary>
+	/// Sort the list in place using an insertion sort.
+	/// </summary>
+	void InsertionSort()
+	{
+		Base::InsertionSort();
+	}
+
+	/// <summary>
+	/// Sort the list in place using a heap sort.
+	/// </summary>
+	void HeapSort()
+	{
+		Base::HeapSort();
+	}
+
+	/// <summary>
+	/// Sort the list in place using an introsort.
+	/// </summary>
+	void IntroSort()
+	{
+		Base::IntroSort();
+	}
+
+	/// <summary>
+	/// Sort the list in place using an introsort with a custom comparison.
+	/// </summary>
+	/// <param name="comp">Returns true if the first value should come before the second.</param>
+	template <typename Compare>
+	void IntroSort(Compare comp)
+	{
+		Base::IntroSort(comp);
+	}
+
+	/// <summary>
+	/// Find the smallest value in the list.
+	/// </summary>
+	/// <param name="threads">The number of threads to split the scan across.</param>
+	/// <returns>The smallest value.</returns>
+	T Min(unsigned int threads = 1) const
+	{
+		return Base::Min(threads);
+	}
+
+	using Base::Pop;
+	using Base::Remove;
+	using Base::RemoveKeepOrder;
+	using Base::RemoveIf;
+	using Base::RemoveAll;
+	using Base::Clear;
+
+	using Base::CocktailShakerSort;
+	using Base::TimSort;
+	using Base::ParallelSort;
+	using Base::RadixSort;
+	using Base::SortBy;
+	using Base::ArgSort;
+
+	using Base::BinarySearch;
+	using Base::FibonacciSearch;
+	using Base::JumpSearch;
+	using Base::LinearSearch;
+	using Base::InterpolationSearch;
+	using Base::Find;
+	using Base::KnownSorted;
+	using Base::CheckSorted;
+	using Base::InvalidateSorted;
+
+	using Base::Sum;
+	using Base::Max;
+	using Base::MinMax;
+	using Base::Count;
+	using Base::CountIf;
+	using Base::PrefixSum;
+	using Base::ExclusivePrefixSum;
+
+	using Base::Data;
+	using Base::Size;
+	using Base::Capacity;
+	using Base::operator[];
+	using Base::Format;
+	using Base::PrintDetails;
+	using Base::ToString;
+
+	/// <summary>
+	/// << operator overload.
+	/// Allows displaying the list to an ostream.
+	/// </summary>
+	/// <param name="os">The ostream to display the list to.</param>
+	/// <param name="list">The list to display,</param>
+	/// <returns>The ostream with the list displayed.</returns>
+	friend ostream& operator<< (ostream& os, const MappedList& list)
+	{
+		return os << list.AsList();
+	}
+};
\ No newline at end of file
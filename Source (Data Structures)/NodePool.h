@@ -0,0 +1,363 @@
+/*
+	File: NodePool.h
+	Contains: NodePoolStatistics, NodePool, NewAllocator, PoolAllocator, ThreadPoolAllocator
+*/
+
+#pragma once
+#include <new>
+#include <cstddef>
+#include <utility>
+#include <stdexcept>
+
+using namespace std;
+
+/// <summary>
+/// Counters kept by a node pool that collects statistics.
+/// </summary>
+struct NodePoolStatistics
+{
+	size_t allocations = 0;		//The number of nodes allocated
+	size_t deallocations = 0;	//The number of nodes given back one at a time
+	size_t resets = 0;			//The number of times every node was released at once
+	size_t live = 0;			//The number of nodes in use
+	size_t peak = 0;			//The most nodes that have been in use at once
+	size_t slabs = 0;			//The number of slabs allocated
+	size_t bytes = 0;			//The memory held by the slabs
+};
+
+/// <summary>
+/// The Node Pool hands out fixed-size nodes from large slabs, instead of calling new for every node.
+/// Freed nodes go on a free list and are handed out again first. Otherwise nodes are taken from the current slab in order.
+/// Reset() releases every node at once in constant time by starting again at the first slab, keeping the memory.
+/// The node size is set by the first allocation, so a pool only serves one type of node.
+/// It isn't thread safe, so each pool should only be used by one thread at a time.
+/// </summary>
+template <bool CollectStatistics = false>
+class NodePool
+{
+private:
+	/// <summary>
+	/// The start of a slab, linking it to the next one. The nodes follow it.
+	/// </summary>
+	struct Slab
+	{
+		Slab* next;
+	};
+
+	/// <summary>
+	/// A node on the free list, which reuses the node's memory for the link.
+	/// </summary>
+	struct FreeNode
+	{
+		FreeNode* next;
+	};
+
+	size_t nodeSize;			//The size of a node, rounded up to its alignment
+	size_t nodeAlignment;		//The alignment of the nodes and the slabs
+	size_t nodesPerSlab;		//The number of nodes in a slab
+	Slab* firstSlab;			//The oldest slab, where Reset() starts again
+	Slab* currentSlab;			//The slab nodes are being taken from
+	char* next;					//The next node in the current slab
+	char* slabEnd;				//One past the last node in the current slab
+	FreeNode* freeList;			//The nodes that have been given back
+	NodePoolStatistics statistics;
+
+	/// <summary>
+	/// Get the offset of the first node in a slab, after the link to the next slab.
+	/// </summary>
+	/// <returns>The offset in bytes.</returns>
+	size_t HeaderSize() const
+	{
+		return (sizeof(Slab) + nodeAlignment - 1) / nodeAlignment * nodeAlignment;
+	}
+
+	/// <summary>
+	/// Move on to the next slab, allocating it if it doesn't exist yet.
+	/// </summary>
+	void NextSlab()
+	{
+		Slab* slab = currentSlab == nullptr ? firstSlab : currentSlab->next;
+		if (slab == nullptr)
+		{
+			size_t bytes = HeaderSize() + nodeSize * nodesPerSlab;
+			slab = static_cast<Slab*>(::operator new(bytes, align_val_t(nodeAlignment)));
+			slab->next = nullptr;
+			if (currentSlab == nullptr)
+				firstSlab = slab;
+			else
+				currentSlab->next = slab;
+			if constexpr (CollectStatistics)
+			{
+				++statistics.slabs;
+				statistics.bytes += bytes;
+			}
+		}
+
+		currentSlab = slab;
+		next = reinterpret_cast<char*>(slab) + HeaderSize();
+		slabEnd = next + nodeSize * nodesPerSlab;
+	}
+
+public:
+	/// <summary>
+	/// Overloaded constructor.
+	/// No memory is allocated until the first node is.
+	/// </summary>
+	/// <param name="_nodesPerSlab">The number of nodes in each slab.</param>
+	NodePool(size_t _nodesPerSlab = 256)
+	{
+		nodeSize = 0;
+		nodeAlignment = alignof(FreeNode);
+		nodesPerSlab = _nodesPerSlab > 0 ? _nodesPerSlab : 1;
+		firstSlab = nullptr;
+		currentSlab = nullptr;
+		next = nullptr;
+		slabEnd = nullptr;
+		freeList = nullptr;
+	}
+
+	NodePool(const NodePool&) = delete;
+	NodePool& operator= (const NodePool&) = delete;
+
+	/// <summary>
+	/// Deconstructor.
+	/// Frees the slabs. Any nodes still in use must have been destroyed.
+	/// </summary>
+	~NodePool()
+	{
+		Release();
+	}
+
+	/// <summary>
+	/// Allocate memory for a node.
+	/// </summary>
+	/// <param name="size">The size of the node.</param>
+	/// <param name="alignment">The alignment of the node.</param>
+	/// <returns>Uninitialised memory for the node.</returns>
+	void* Allocate(size_t size, size_t alignment)
+	{
+		if (nodeSize == 0)
+		{
+			//The first node sets the size, which must also fit the free list link
+			nodeAlignment = alignment > alignof(FreeNode) ? alignment : alignof(FreeNode);
+			size_t minimum = size > sizeof(FreeNode) ? size : sizeof(FreeNode);
+			nodeSize = (minimum + nodeAlignment - 1) / nodeAlignment * nodeAlignment;
+		}
+		else if (size > nodeSize || alignment > nodeAlignment)
+			throw logic_error("A node pool can only allocate nodes of one size.");
+
+		void* node;
+		if (freeList != nullptr)
+		{
+			node = freeList;
+			freeList = freeList->next;
+		}
+		else
+		{
+			if (next == slabEnd)
+				NextSlab();
+			node = next;
+			next += nodeSize;
+		}
+
+		if constexpr (CollectStatistics)
+		{
+			++statistics.allocations;
+			if (++statistics.live > statistics.peak)
+				statistics.peak = statistics.live;
+		}
+		return node;
+	}
+
+	/// <summary>
+	/// Give a node back to the pool, to be handed out again.
+	/// The node must already be destroyed.
+	/// </summary>
+	/// <param name="node">The node.</param>
+	void Deallocate(void* node)
+	{
+		FreeNode* freeNode = static_cast<FreeNode*>(node);
+		freeNode->next = freeList;
+		freeList = freeNode;
+
+		if constexpr (CollectStatistics)
+		{
+			++statistics.deallocations;
+			--statistics.live;
+		}
+	}
+
+	/// <summary>
+	/// Release every node at once, keeping the slabs for the next nodes.
+	/// Takes constant time. The nodes must already be destroyed, or be trivially destructible.
+	/// </summary>
+	void Reset()
+	{
+		freeList = nullptr;
+		currentSlab = nullptr;
+		next = nullptr;
+		slabEnd = nullptr;
+
+		if constexpr (CollectStatistics)
+		{
+			++statistics.resets;
+			statistics.live = 0;
+		}
+	}
+
+	/// <summary>
+	/// Release every node and free the slabs.
+	/// </summary>
+	void Release()
+	{
+		while (firstSlab != nullptr)
+		{
+			Slab* slab = firstSlab;
+			firstSlab = slab->next;
+			::operator delete(slab, align_val_t(nodeAlignment));
+		}
+		Reset();
+
+		if constexpr (CollectStatistics)
+		{
+			statistics.slabs = 0;
+			statistics.bytes = 0;
+		}
+	}
+
+	/// <summary>
+	/// Getter for the pool's counters.
+	/// They stay at zero unless the pool collects statistics.
+	/// </summary>
+	/// <returns>The counters.</returns>
+	const NodePoolStatistics& Statistics() const
+	{
+		return statistics;
+	}
+};
+
+/// <summary>
+/// The default node allocator, which allocates every node with new.
+/// A node allocator is a container template parameter with New<Node>(args...) and Delete(node).
+/// If BULK_RELEASE is true, the container may release all of its nodes with Reset() instead of deleting them one by one.
+/// If SHARED_NODES is true, a node allocated by one container may be freed by another, so nodes can be moved between containers.
+/// </summary>
+struct NewAllocator
+{
+	static constexpr bool BULK_RELEASE = false;
+	static constexpr bool SHARED_NODES = true;
+
+	template <typename Node, typename... Args>
+	Node* New(Args&&... args)
+	{
+		return new Node(forward<Args>(args)...);
+	}
+
+	template <typename Node>
+	void Delete(Node* node)
+	{
+		delete node;
+	}
+
+	void Reset() {}
+};
+
+/// <summary>
+/// A node allocator with a pool for each container.
+/// Clear() releases the nodes in constant time when the elements don't need destroying.
+/// Copying a container gives the copy its own empty pool, and nodes can't be moved from one container to another.
+/// </summary>
+template <size_t NodesPerSlab = 256, bool CollectStatistics = false>
+class PoolAllocator
+{
+private:
+	NodePool<CollectStatistics> pool;	//The pool the container's nodes come from
+
+public:
+	static constexpr bool BULK_RELEASE = true;
+	static constexpr bool SHARED_NODES = false;
+
+	PoolAllocator() : pool(NodesPerSlab) {}
+	PoolAllocator(const PoolAllocator&) : pool(NodesPerSlab) {}
+	PoolAllocator& operator= (const PoolAllocator&) { return *this; }
+
+	template <typename Node, typename... Args>
+	Node* New(Args&&... args)
+	{
+		void* memory = pool.Allocate(sizeof(Node), alignof(Node));
+		try
+		{
+			return new (memory) Node(forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			pool.Deallocate(memory);
+			throw;
+		}
+	}
+
+	template <typename Node>
+	void Delete(Node* node)
+	{
+		node->~Node();
+		pool.Deallocate(node);
+	}
+
+	void Reset()
+	{
+		pool.Reset();
+	}
+
+	const NodePoolStatistics& Statistics() const
+	{
+		return pool.Statistics();
+	}
+};
+
+/// <summary>
+/// A node allocator with a pool for each thread and type of node, shared by every container using it on that thread.
+/// Nodes must be freed on the thread that allocated them, and the pool is freed when the thread exits,
+/// so the containers must not outlive the thread that filled them.
+/// </summary>
+template <size_t NodesPerSlab = 256, bool CollectStatistics = false>
+struct ThreadPoolAllocator
+{
+	static constexpr bool BULK_RELEASE = false;
+	static constexpr bool SHARED_NODES = true;
+
+	/// <summary>
+	/// Get this thread's pool for a type of node.
+	/// </summary>
+	/// <returns>The pool.</returns>
+	template <typename Node>
+	static NodePool<CollectStatistics>& Pool()
+	{
+		static thread_local NodePool<CollectStatistics> pool(NodesPerSlab);
+		return pool;
+	}
+
+	template <typename Node, typename... Args>
+	Node* New(Args&&... args)
+	{
+		NodePool<CollectStatistics>& pool = Pool<Node>();
+		void* memory = pool.Allocate(sizeof(Node), alignof(Node));
+		try
+		{
+			return new (memory) Node(forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			pool.Deallocate(memory);
+			throw;
+		}
+	}
+
+	template <typename Node>
+	void Delete(Node* node)
+	{
+		node->~Node();
+		Pool<Node>().Deallocate(node);
+	}
+
+	void Reset() {}
+};
\ No newline at end of file
@@ -0,0 +1,271 @@
+/*
+	File: SearchIndex.h
+	Contains: SearchIndex
+*/
+
+#pragma once
+#include <cstdint>
+#include "DynamicList.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <xmmintrin.h>
+#endif
+
+using namespace std;
+
+/// <summary>
+/// The Search Index is a read-only copy of a sorted list that is laid out for fast searching.
+/// The values are stored in Eytzinger (breadth-first) order: the root of an implicit binary search tree is at index 1
+/// and the children of index k are at 2k and 2k + 1.
+/// Unlike a binary search over the sorted list, the first few levels of the tree share a handful of cache lines,
+/// and the values that the search will visit next are close together in memory, so they can be prefetched.
+/// https://arxiv.org/abs/1509.05053
+/// </summary>
+template <typename T>
+class SearchIndex
+{
+private:
+	T* keys;			//The values in Eytzinger order, starting at index 1
+	size_t* indices;	//The index in the sorted list of each value in keys
+	size_t size;		//The number of values in the index
+
+	static const size_t BATCH_SIZE = 8;		//The number of searches that the batch find runs side by side
+
+	/// <summary>
+	/// Copy the sorted list into Eytzinger order using an in-order traversal of the implicit tree.
+	/// </summary>
+	/// <param name="sorted">The sorted list.</param>
+	/// <param name="i">The index of the next value to take from the sorted list.</param>
+	/// <param name="k">The position in the tree to fill.</param>
+	/// <returns>The index of the next value to take from the sorted list.</returns>
+	template <typename Policy>
+	size_t Build(const List<T, Policy>& sorted, size_t i, size_t k)
+	{
+		if (k <= size)
+		{
+			i = Build(sorted, i, 2 * k);
+			keys[k] = sorted[i];
+			indices[k] = i;
+			++i;
+			i = Build(sorted, i, 2 * k + 1);
+		}
+		return i;
+	}
+
+	/// <summary>
+	/// Hint to the processor that some memory will be read soon.
+	/// The address is worked out as an integer, because the search prefetches past the end of the array near the bottom of the tree
+	/// and forming a pointer out of bounds is undefined. A prefetch never faults, so the address doesn't have to be mapped.
+	/// </summary>
+	/// <param name="address">The address that will be read.</param>
+	static void Prefetch(uintptr_t address)
+	{
+#ifdef _MSC_VER
+		_mm_prefetch((const char*)address, _MM_HINT_T0);
+#else
+		__builtin_prefetch((const void*)address);
+#endif
+	}
+
+	/// <summary>
+	/// Count the number of zero bits below the lowest set bit.
+	/// </summary>
+	/// <param name="value">The value to check. Must not be zero.</param>
+	/// <returns>The number of trailing zero bits.</returns>
+	static unsigned int CountTrailingZeros(unsigned long long value)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return (unsigned int)index;
+#else
+		return (unsigned int)__builtin_ctzll(value);
+#endif
+	}
+
+	/// <summary>
+	/// Move one step down the tree towards a value.
+	/// Goes right if the current key is smaller than the value, otherwise left, without branching.
+	/// Also prefetches the cache line holding the descendants a few levels further down.
+	/// </summary>
+	/// <param name="k">The current position in the tree.</param>
+	/// <param name="value">The value being searched for.</param>
+	/// <returns>The next position in the tree.</returns>
+	size_t Step(size_t k, const T& value) const
+	{
+		Prefetch((uintptr_t)keys + k * PrefetchDistance() * sizeof(T));
+		return 2 * k + (size_t)(keys[k] < value);
+	}
+
+	/// <summary>
+	/// Turn the position that a search fell out of the tree at into the result of the search.
+	/// The last right turn is undone by removing the trailing ones and the final step,
+	/// leaving the position of the first key that is not smaller than the value.
+	/// </summary>
+	/// <param name="k">The position past the bottom of the tree.</param>
+	/// <param name="value">The value being searched for.</param>
+	/// <returns>The index of the value in the sorted list, or -1 if not found.</returns>
+	ptrdiff_t Finish(size_t k, const T& value) const
+	{
+		k >>= CountTrailingZeros(~(unsigned long long)k) + 1;
+		if (k == 0 || value < keys[k])
+			return -1;
+		return (ptrdiff_t)indices[k];
+	}
+
+	/// <summary>
+	/// The number of levels to prefetch ahead of the search.
+	/// A cache line holds the descendants of a key this many levels down.
+	/// </summary>
+	/// <returns>The number of keys that fit in a cache line, at least 1.</returns>
+	static constexpr size_t PrefetchDistance()
+	{
+		return sizeof(T) >= 64 ? 1 : 64 / sizeof(T);
+	}
+
+public:
+	/// <summary>
+	/// Overloaded constructor.
+	/// Builds the index from a list that is already sorted in ascending order.
+	/// </summary>
+	/// <param name="sorted">The sorted list to index.</param>
+	template <typename Policy>
+	SearchIndex(const List<T, Policy>& sorted)
+	{
+		size = sorted.Size();
+		keys = new T[size + 1];
+		indices = new size_t[size + 1];
+		Build(sorted, 0, 1);
+	}
+
+	/// <summary>
+	/// Copy constructor.
+	/// </summary>
+	/// <param name="copy">The index to copy.</param>
+	SearchIndex(const SearchIndex& copy)
+	{
+		size = copy.size;
+		keys = new T[size + 1];
+		indices = new size_t[size + 1];
+		for (size_t k = 1; k <= size; ++k)
+		{
+			keys[k] = copy.keys[k];
+			indices[k] = copy.indices[k];
+		}
+	}
+
+	/// <summary>
+	/// Deconstructor.
+	/// </summary>
+	~SearchIndex()
+	{
+		delete[] keys;
+		delete[] indices;
+	}
+
+	/// <summary>
+	/// Search for a value.
+	/// </summary>
+	/// <param name="value">The value to search for.</param>
+	/// <returns>The index of the value in the sorted list, or -1 if not found. If the value appears more than once, the first index is returned.</returns>
+	ptrdiff_t Find(const T& value) const
+	{
+		size_t k = 1;
+		while (k <= size)
+			k = Step(k, value);
+		return Finish(k, value);
+	}
+
+	/// <summary>
+	/// Search for many values at once.
+	/// Runs several searches side by side so that their cache misses overlap.
+	/// </summary>
+	/// <param name="values">The values to search for.</param>
+	/// <param name="count">The number of values.</param>
+	/// <param name="results">Receives the index of each value in the sorted list, or -1 if not found.</param>
+	void Find(const T* values, size_t count, ptrdiff_t* results) const
+	{
+		size_t k[BATCH_SIZE];
+		for (size_t start = 0; start < count; start += BATCH_SIZE)
+		{
+			size_t batch = (count - start < BATCH_SIZE) ? count - start : BATCH_SIZE;
+			for (size_t j = 0; j < batch; ++j)
+				k[j] = 1;
+
+			//Every search in the batch takes the same number of steps, give or take one
+			bool searching = size > 0;
+			while (searching)
+			{
+				searching = false;
+				for (size_t j = 0; j < batch; ++j)
+					if (k[j] <= size)
+					{
+						k[j] = Step(k[j], values[start + j]);
+						searching = true;
+					}
+			}
+
+			for (size_t j = 0; j < batch; ++j)
+				results[start + j] = Finish(k[j], values[start + j]);
+		}
+	}
+
+	/// <summary>
+	/// Search for many values at once.
+	/// </summary>
+	/// <param name="values">The values to search for.</param>
+	/// <returns>A list with the index of each value in the sorted list, or -1 if not found.</returns>
+	template <typename Policy>
+	List<ptrdiff_t> Find(const List<T, Policy>& values) const
+	{
+		List<ptrdiff_t> results(values.Size());
+		for (size_t i = 0; i < values.Size(); ++i)
+			results.Push(-1);
+		if (values.Size() > 0)
+			Find(&values[0], values.Size(), &results[0]);
+		return results;
+	}
+
+	/// <summary>
+	/// Check if the index contains a value.
+	/// </summary>
+	/// <param name="value">The value to search for.</param>
+	/// <returns>True if the value is in the index.</returns>
+	bool Contains(const T& value) const
+	{
+		return Find(value) != -1;
+	}
+
+	/// <summary>
+	/// Getter for the size of the index.
+	/// </summary>
+	/// <returns>The number of values in the index.</returns>
+	size_t Size() const
+	{
+		return size;
+	}
+
+	/// <summary>
+	/// Assignment operator overload.
+	/// </summary>
+	/// <param name="other">The index to copy.</param>
+	/// <returns>This index with the values of the other index.</returns>
+	SearchIndex& operator= (const SearchIndex& other)
+	{
+		if (this == &other)
+			return *this;
+
+		delete[] keys;
+		delete[] indices;
+		size = other.size;
+		keys = new T[size + 1];
+		indices = new size_t[size + 1];
+		for (size_t k = 1; k <= size; ++k)
+		{
+			keys[k] = other.keys[k];
+			indices[k] = other.indices[k];
+		}
+		return *this;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,507 @@
+/*
+	File: SegmentedList.h
+	Contains: SegmentedList
+*/
+
+#pragma once
+#include "DynamicList.h"
+
+using namespace std;
+
+/// <summary>
+/// The Segmented List is a list that stores its elements in fixed-size chunks instead of one array.
+/// Growing allocates one more chunk and never moves the existing elements, so pushing has no copy spikes
+/// and pointers to elements stay valid until the element is removed.
+/// A directory of chunk pointers gives O(1) random access: the chunk is the index shifted down, the slot is the index masked.
+/// It has the same Push/Pop/operator[]/Remove interface as List.
+/// </summary>
+template <typename T, size_t ChunkSize = 1024>
+class SegmentedList
+{
+private:
+	static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "The chunk size must be a power of two, so indexing is a shift and a mask.");
+
+	/// <summary>
+	/// Calculate log2 of a power of two.
+	/// </summary>
+	static constexpr size_t Log2(size_t value)
+	{
+		return value > 1 ? 1 + Log2(value >> 1) : 0;
+	}
+
+	static const size_t CHUNK_SHIFT = Log2(ChunkSize);		//The index of an element's chunk is its index shifted down by this
+	static const size_t CHUNK_MASK = ChunkSize - 1;			//The index of an element in its chunk is its index masked by this
+
+	List<T*> chunks;	//The chunk directory. Chunks are never moved, and are only freed by ShrinkToFit()
+	size_t size;		//The size of the list
+
+	/// <summary>
+	/// Get an element without checking the index.
+	/// </summary>
+	/// <param name="index">The index of the element.</param>
+	/// <returns>The element.</returns>
+	T& At(size_t index) const
+	{
+		return chunks.Data()[index >> CHUNK_SHIFT][index & CHUNK_MASK];
+	}
+
+	/// <summary>
+	/// Allocate uninitialised memory for a chunk.
+	/// </summary>
+	/// <returns>A pointer to the start of the chunk.</returns>
+	static T* AllocateChunk()
+	{
+		return static_cast<T*>(::operator new(sizeof(T) * ChunkSize));
+	}
+
+	/// <summary>
+	/// Destroy every element, leaving the chunks allocated.
+	/// </summary>
+	void DestroyAll()
+	{
+		if constexpr (!is_trivially_destructible_v<T>)
+			for (size_t i = 0; i < size; ++i)
+				At(i).~T();
+		size = 0;
+	}
+
+	/// <summary>
+	/// Free the chunks past a number of chunks.
+	/// The chunks must not contain any elements.
+	/// </summary>
+	/// <param name="keep">The number of chunks to keep.</param>
+	void FreeChunks(size_t keep)
+	{
+		while (chunks.Size() > keep)
+		{
+			::operator delete(chunks[chunks.Size() - 1]);
+			chunks.Pop();
+		}
+	}
+
+	/// <summary>
+	/// Copy the elements of another list onto the end of this one.
+	/// </summary>
+	/// <param name="other">The list to copy.</param>
+	void CopyFrom(const SegmentedList& other)
+	{
+		Reserve(size + other.size);
+		for (size_t i = 0; i < other.size; ++i)
+			EmplaceBack(other.At(i));
+	}
+
+public:
+	/// <summary>
+	/// Default constructor.
+	/// No chunks are allocated until the first element is pushed.
+	/// </summary>
+	SegmentedList()
+	{
+		size = 0;
+	}
+
+	/// <summary>
+	/// Overloaded constructor.
+	/// </summary>
+	/// <param name="_capacity">The number of elements to allocate chunks for.</param>
+	SegmentedList(size_t _capacity)
+	{
+		size = 0;
+		Reserve(_capacity);
+	}
+
+	/// <summary>
+	/// Copy constructor.
+	/// </summary>
+	/// <param name="copy">The list to copy.</param>
+	SegmentedList(const SegmentedList& copy)
+	{
+		size = 0;
+		try
+		{
+			CopyFrom(copy);
+		}
+		catch (...)
+		{
+			DestroyAll();
+			FreeChunks(0);
+			throw;
+		}
+	}
+
+	/// <summary>
+	/// Move constructor.
+	/// Takes the chunks of the other list, leaving it empty.
+	/// </summary>
+	/// <param name="other">The list to move from.</param>
+	SegmentedList(SegmentedList&& other) noexcept : chunks(move(other.chunks))
+	{
+		size = other.size;
+		other.size = 0;
+	}
+
+	/// <summary>
+	/// Deconstructor.
+	/// </summary>
+	~SegmentedList()
+	{
+		DestroyAll();
+		FreeChunks(0);
+	}
+
+	/// <summary>
+	/// Allocate chunks until the list can hold a number of elements.
+	/// Does nothing if the capacity is already large enough.
+	/// </summary>
+	/// <param name="newCapacity">The minimum capacity the list should have.</param>
+	void Reserve(size_t newCapacity)
+	{
+		size_t needed = (newCapacity + CHUNK_MASK) >> CHUNK_SHIFT;
+		if (needed <= chunks.Size())
+			return;
+
+		chunks.Reserve(needed);
+		while (chunks.Size() < needed)
+			chunks.Push(AllocateChunk());
+	}
+
+	/// <summary>
+	/// Push a new value to the list.
+	/// If it will not fit then a new chunk is allocated.
+	/// </summary>
+	/// <param name="value">The value to push to the list.</param>
+	void Push(const T& value)
+	{
+		EmplaceBack(value);
+	}
+
+	/// <summary>
+	/// Push a new value to the list by moving it.
+	/// If it will not fit then a new chunk is allocated.
+	/// </summary>
+	/// <param name="value">The value to move into the list.</param>
+	void Push(T&& value)
+	{
+		EmplaceBack(move(value));
+	}
+
+	/// <summary>
+	/// Construct a new value in place at the end of the list.
+	/// If it will not fit then a new chunk is allocated. No existing value is moved.
+	/// </summary>
+	/// <param name="args">The arguments to pass to the value's constructor.</param>
+	/// <returns>The new value.</returns>
+	template <typename... Args>
+	T& EmplaceBack(Args&&... args)
+	{
+		if ((size >> CHUNK_SHIFT) == chunks.Size())
+			chunks.Push(AllocateChunk());
+
+		T* slot = chunks.Data()[size >> CHUNK_SHIFT] + (size & CHUNK_MASK);
+		new (slot) T(forward<Args>(args)...);
+		++size;
+		return *slot;
+	}
+
+	/// <summary>
+	/// Pop the element off the end of the list.
+	/// The chunk it was in is kept for the next push.
+	/// </summary>
+	void Pop()
+	{
+		if (size > 0)
+		{
+			--size;
+			At(size).~T();
+		}
+	}
+
+	/// <summary>
+	/// Remove the value at a specific index from the list.
+	/// The last value is moved into its place, so this will remove any order from the list.
+	/// To preserve order, RemoveKeepOrder() should be used.
+	/// </summary>
+	/// <param name="index">The index of the value to be removed.</param>
+	void Remove(size_t index)
+	{
+		if (index >= size)
+			return;
+		if (index != size - 1)
+			At(index) = move(At(size - 1));
+		Pop();
+	}
+
+	/// <summary>
+	/// Remove all occurences of a value from the list.
+	/// This will remove any order from the list.
+	/// To preserve order, RemoveKeepOrder() should be used.
+	/// </summary>
+	/// <param name="value">The value to remove from the list.</param>
+	void Remove(T& value)
+	{
+		//Copy the value as it could be an element that is about to be overwritten
+		T target = value;
+		size_t i = 0;
+		while (i < size)
+		{
+			//The last value is moved into the removed value's place, so check the same index again
+			if (At(i) == target)
+				Remove(i);
+			else
+				++i;
+		}
+	}
+
+	/// <summary>
+	/// Remove the value at a specific index from the list.
+	/// This will keep any order in the list. Every value after the index moves back one position.
+	/// </summary>
+	/// <param name="index">The index of the value to be removed.</param>
+	void RemoveKeepOrder(size_t index)
+	{
+		if (index >= size)
+			return;
+		for (size_t i = index; i + 1 < size; ++i)
+			At(i) = move(At(i + 1));
+		Pop();
+	}
+
+	/// <summary>
+	/// Remove all values from the list.
+	/// The chunks are kept for the next values, ShrinkToFit() frees them.
+	/// </summary>
+	void Clear()
+	{
+		DestroyAll();
+	}
+
+	/// <summary>
+	/// Free the chunks that aren't being used.
+	/// </summary>
+	void ShrinkToFit()
+	{
+		FreeChunks((size + CHUNK_MASK) >> CHUNK_SHIFT);
+		chunks.ShrinkToFit();
+	}
+
+	/// <summary>
+	/// Perform a linear search for a value, one chunk at a time.
+	/// Uses a vectorised scan for numbers.
+	/// </summary>
+	/// <param name="value">The value to search for.</param>
+	/// <returns>The index of the value in the list, or -1 if not found.</returns>
+	ptrdiff_t LinearSearch(const T& value) const
+	{
+		for (size_t first = 0; first < size; first += ChunkSize)
+		{
+			size_t count = size - first < ChunkSize ? size - first : ChunkSize;
+			size_t index = SimdKernels::FindFirst(chunks.Data()[first >> CHUNK_SHIFT], count, value);
+			if (index < count)
+				return (ptrdiff_t)(first + index);
+		}
+		return -1;
+	}
+
+	/// <summary>
+	/// Write the list to a binary writer, one chunk at a time.
+	/// Uses the same format as List, so either can read what the other wrote.
+	/// </summary>
+	/// <param name="writer">The writer to write to.</param>
+	void Serialize(BinaryWriter& writer) const
+	{
+		writer.WriteHeader<T>(SERIAL_LIST, size);
+		for (size_t first = 0; first < size; first += ChunkSize)
+			writer.WriteValues(chunks.Data()[first >> CHUNK_SHIFT], size - first < ChunkSize ? size - first : ChunkSize);
+	}
+
+	/// <summary>
+	/// Replace the values of the list with a list read from a binary reader.
+	/// Trivially copyable elements are read straight into the chunks.
+	/// Chunks are allocated as they are read, so a corrupt count runs out of stream before it can allocate more than the stream holds.
+	/// </summary>
+	/// <param name="reader">The reader to read from.</param>
+	void Deserialize(BinaryReader& reader)
+	{
+		size_t count = reader.ReadHeader<T>(SERIAL_LIST);
+		Clear();
+		if constexpr (is_trivially_copyable_v<T>)
+		{
+			for (size_t first = 0; first < count; first += ChunkSize)
+			{
+				size_t chunkCount = count - first < ChunkSize ? count - first : ChunkSize;
+				Reserve(first + chunkCount);
+				reader.ReadValues(chunks.Data()[first >> CHUNK_SHIFT], chunkCount);
+				size += chunkCount;
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				T value;
+				reader.ReadValue(value);
+				EmplaceBack(move(value));
+			}
+		}
+	}
+
+	/// <summary>
+	/// Getter for the size of the list.
+	/// </summary>
+	/// <returns>The number of elements in the list.</returns>
+	size_t Size() const
+	{
+		return size;
+	}
+
+	/// <summary>
+	/// Getter for the current capacity of the list.
+	/// </summary>
+	/// <returns>The number of elements that fit in the allocated chunks.</returns>
+	size_t Capacity() const
+	{
+		return chunks.Size() * ChunkSize;
+	}
+
+	/// <summary>
+	/// Getter for the number of allocated chunks.
+	/// </summary>
+	/// <returns>The number of chunks.</returns>
+	size_t ChunkCount() const
+	{
+		return chunks.Size();
+	}
+
+	/// <summary>
+	/// Get one of the chunks the elements are stored in, for loops that don't need operator[]'s range check.
+	/// Every chunk holds ChunkSize elements except the last one in use, which holds the rest.
+	/// </summary>
+	/// <param name="chunk">The index of the chunk.</param>
+	/// <returns>A pointer to the first element of the chunk.</returns>
+	T* Chunk(size_t chunk) const
+	{
+		return chunks[chunk];
+	}
+
+	/// <summary>
+	/// = operator overload.
+	/// Copy the values of another list.
+	/// The chunks this list already has are reused.
+	/// </summary>
+	/// <param name="other">The list to copy.</param>
+	/// <returns>This list.</returns>
+	SegmentedList& operator= (const SegmentedList& other)
+	{
+		if (this == &other)
+			return *this;
+
+		DestroyAll();
+		CopyFrom(other);
+		return *this;
+	}
+
+	/// <summary>
+	/// = operator overload.
+	/// Take the chunks of another list, leaving it empty.
+	/// </summary>
+	/// <param name="other">The list to move from.</param>
+	/// <returns>This list.</returns>
+	SegmentedList& operator= (SegmentedList&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		DestroyAll();
+		FreeChunks(0);
+		chunks = move(other.chunks);
+		size = other.size;
+		other.size = 0;
+		return *this;
+	}
+
+	/// <summary>
+	/// [] sub-script operator overload.
+	/// Allow accessing the list using square brackets.
+	/// </summary>
+	/// <param name="index">The index to access.</param>
+	/// <returns>The element at the specified index.</returns>
+	T& operator[] (const size_t index) const
+	{
+		if (index < size)
+			return At(index);
+
+		//Throw an error if the index is outside the range of the list
+		throw out_of_range("Index out of range.");
+	}
+
+	/// <summary>
+	/// Append the list to a text buffer in the same format as the << operator.
+	/// </summary>
+	/// <param name="buffer">The buffer to append to.</param>
+	/// <param name="maxElements">The most elements to show, the rest are replaced by "...".</param>
+	void Format(TextBuffer& buffer, size_t maxElements = FORMAT_ALL) const
+	{
+		size_t shown = size < maxElements ? size : maxElements;
+		buffer.Append('[');
+		for (size_t i = 0; i < shown; ++i)
+		{
+			if (i != 0)
+				buffer.Append(", ");
+			buffer.Append(At(i));
+		}
+		if (shown < size)
+			buffer.Append(shown == 0 ? "..." : ", ...");
+		buffer.Append(']');
+	}
+
+	/// <summary>
+	/// Print details about this list to std::cout.
+	/// The line is formatted in a buffer and written in one piece, without flushing std::cout.
+	/// </summary>
+	/// <param name="maxElements">The most elements to show, the rest are replaced by "...".</param>
+	void PrintDetails(size_t maxElements = FORMAT_ALL) const
+	{
+		size_t shown = size < maxElements ? size : maxElements;
+		TextBuffer& buffer = ScratchTextBuffer();
+		buffer.Append("Size: ").Append(size).Append("   ");
+		buffer.Append("Capacity: ").Append(Capacity()).Append("   ");
+		buffer.Append("Chunks: ").Append(chunks.Size()).Append("   ");
+		for (size_t i = 0; i < shown; ++i)
+			buffer.Append(At(i)).Append(' ');
+		if (shown < size)
+			buffer.Append("... ");
+		buffer.Append('\n').WriteTo(cout);
+	}
+
+	/// <summary>
+	/// << operator overload.
+	/// Allows displaying the list to an ostream.
+	/// </summary>
+	/// <param name="os">The ostream to display the list to.</param>
+	/// <param name="list">The list to display,</param>
+	/// <returns>The ostream with the list displayed.</returns>
+	friend ostream& operator<< (ostream& os, const SegmentedList& list)
+	{
+		os << "[";
+		for (size_t i = 0; i < list.Size(); ++i)
+		{
+			if (i != 0)
+				os << ", ";
+			os << list.At(i);
+		}
+		os << "]";
+		return os;
+	}
+
+	/// <summary>
+	/// Get the list represented as a string.
+	/// </summary>
+	/// <param name="maxElements">The most elements to show, the rest are replaced by "...".</param>
+	/// <returns>A string representation of the list.</returns>
+	string ToString(size_t maxElements = FORMAT_ALL) const
+	{
+		TextBuffer buffer;
+		Format(buffer, maxElements);
+		return buffer.Str();
+	}
+};
\ No newline at end of file
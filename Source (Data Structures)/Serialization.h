@@ -0,0 +1,511 @@
+/*
+	File: Serialization.h
+	Contains: BinaryWriter, BinaryReader, SerialTraits
+*/
+
+#pragma once
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+using namespace std;
+
+//The kind of container a stream holds, so a stream written by one container isn't read as another
+enum SERIAL_CONTAINER { SERIAL_LIST = 1, SERIAL_LINKED_LIST, SERIAL_DEQUEUE, SERIAL_STACK, SERIAL_HEAP, SERIAL_BINARY_TREE };
+
+//How the elements of a container are stored in a stream
+enum SERIAL_ENCODING
+{
+	SERIAL_RAW,			//The bytes of each element, copied in bulk. Used for trivially copyable types
+	SERIAL_VARINT,		//Integers as variable-length (LEB128) numbers, zigzagged if signed, so small values take one byte
+	SERIAL_ELEMENTWISE	//Each element written by its SerialTraits, e.g. strings as a length and their characters
+};
+
+static const char SERIAL_MAGIC[4] = { 'D', 'S', 'B', 'F' };
+static const uint8_t SERIAL_VERSION = 1;
+static const uint8_t SERIAL_BIG_ENDIAN = 1;		//Header flag: raw elements were written by a big-endian machine
+static const uint8_t SERIAL_SORTED = 2;			//Header flag: the container was known to be sorted
+
+/// <summary>
+/// Serial Traits describe how to write a type that isn't trivially copyable.
+/// Specialise this for a type with static Write(BinaryWriter&, const T&) and Read(BinaryReader&, T&) functions
+/// and SUPPORTED set to true to let containers of it be serialized. Strings are supported below.
+/// </summary>
+template <typename T>
+struct SerialTraits
+{
+	static constexpr bool SUPPORTED = false;
+};
+
+/// <summary>
+/// The Binary Writer writes containers to an output stream in a compact binary format.
+/// Each container is a 20 byte header (magic, version, container, encoding, flags, element size and count) followed by its elements.
+/// Writes go through a 64KB buffer, so containers of nodes are streamed out in large pieces,
+/// and arrays larger than the buffer are written straight from the container without being copied.
+/// Nothing is guaranteed to reach the stream until Flush() is called.
+/// </summary>
+class BinaryWriter
+{
+private:
+	static const size_t BUFFER_SIZE = 65536;
+
+	ostream& stream;	//The stream being written to
+	char* buffer;		//The bytes waiting to be written
+	size_t used;		//The number of bytes in the buffer
+	bool varints;		//Whether integers are written as varints
+
+	/// <summary>
+	/// Write the bytes waiting in the buffer to the stream.
+	/// </summary>
+	void WriteBuffer()
+	{
+		if (used > 0)
+		{
+			stream.write(buffer, (streamsize)used);
+			used = 0;
+			if (!stream)
+				throw runtime_error("Could not write to the stream.");
+		}
+	}
+
+	/// <summary>
+	/// Write an unsigned number as a fixed number of little-endian bytes.
+	/// </summary>
+	/// <param name="value">The number to write.</param>
+	/// <param name="bytes">The number of bytes to write it in.</param>
+	void WriteFixed(uint64_t value, size_t bytes)
+	{
+		unsigned char encoded[8];
+		for (size_t i = 0; i < bytes; ++i)
+			encoded[i] = (unsigned char)(value >> (8 * i));
+		WriteBytes(encoded, bytes);
+	}
+
+public:
+	/// <summary>
+	/// Overloaded constructor.
+	/// </summary>
+	/// <param name="_stream">The stream to write to. It should be opened in binary mode.</param>
+	/// <param name="_varints">Whether to write integers as varints, which is smaller for small values but can't be copied in bulk.</param>
+	BinaryWriter(ostream& _stream, bool _varints = false) : stream(_stream)
+	{
+		buffer = new char[BUFFER_SIZE];
+		used = 0;
+		varints = _varints;
+	}
+
+	BinaryWriter(const BinaryWriter&) = delete;
+	BinaryWriter& operator= (const BinaryWriter&) = delete;
+
+	/// <summary>
+	/// Deconstructor.
+	/// Bytes that haven't been flushed are lost.
+	/// </summary>
+	~BinaryWriter()
+	{
+		delete[] buffer;
+	}
+
+	/// <summary>
+	/// Get the encoding the elements of a type are written in.
+	/// </summary>
+	/// <returns>The encoding.</returns>
+	template <typename T>
+	SERIAL_ENCODING EncodingOf() const
+	{
+		if constexpr (is_integral_v<T> && sizeof(T) > 1)
+		{
+			if (varints)
+				return SERIAL_VARINT;
+		}
+
+		if constexpr (is_trivially_copyable_v<T>)
+			return SERIAL_RAW;
+		else
+		{
+			static_assert(SerialTraits<T>::SUPPORTED, "The type isn't trivially copyable, so SerialTraits must be specialised for it.");
+			return SERIAL_ELEMENTWISE;
+		}
+	}
+
+	/// <summary>
+	/// Write some bytes.
+	/// </summary>
+	/// <param name="bytes">The bytes to write.</param>
+	/// <param name="count">The number of bytes.</param>
+	void WriteBytes(const void* bytes, size_t count)
+	{
+		if (used + count > BUFFER_SIZE)
+			WriteBuffer();
+
+		//Anything too large for the buffer goes straight to the stream
+		if (count >= BUFFER_SIZE)
+		{
+			stream.write(static_cast<const char*>(bytes), (streamsize)count);
+			if (!stream)
+				throw runtime_error("Could not write to the stream.");
+			return;
+		}
+
+		memcpy(buffer + used, bytes, count);
+		used += count;
+	}
+
+	/// <summary>
+	/// Write an unsigned number as a varint: seven bits to a byte, lowest first, with the top bit set on every byte but the last.
+	/// </summary>
+	/// <param name="value">The number to write.</param>
+	void WriteVarint(uint64_t value)
+	{
+		unsigned char encoded[10];
+		size_t count = 0;
+		while (value >= 0x80)
+		{
+			encoded[count++] = (unsigned char)(value | 0x80);
+			value >>= 7;
+		}
+		encoded[count++] = (unsigned char)value;
+		WriteBytes(encoded, count);
+	}
+
+	/// <summary>
+	/// Write the header of a container.
+	/// </summary>
+	/// <param name="container">The kind of container.</param>
+	/// <param name="count">The number of elements that will follow.</param>
+	/// <param name="flags">Extra flags, e.g. SERIAL_SORTED.</param>
+	template <typename T>
+	void WriteHeader(SERIAL_CONTAINER container, size_t count, uint8_t flags = 0)
+	{
+		SERIAL_ENCODING encoding = EncodingOf<T>();
+		const uint16_t order = 1;
+		if (encoding == SERIAL_RAW && *reinterpret_cast<const uint8_t*>(&order) == 0)
+			flags |= SERIAL_BIG_ENDIAN;
+
+		WriteBytes(SERIAL_MAGIC, sizeof(SERIAL_MAGIC));
+		WriteFixed(SERIAL_VERSION, 1);
+		WriteFixed((uint8_t)container, 1);
+		WriteFixed((uint8_t)encoding, 1);
+		WriteFixed(flags, 1);
+		WriteFixed(encoding == SERIAL_ELEMENTWISE ? 0 : sizeof(T), 4);
+		WriteFixed(count, 8);
+	}
+
+	/// <summary>
+	/// Write one element.
+	/// </summary>
+	/// <param name="value">The element to write.</param>
+	template <typename T>
+	void WriteValue(const T& value)
+	{
+		if constexpr (is_integral_v<T> && sizeof(T) > 1)
+		{
+			if (varints)
+			{
+				if constexpr (is_signed_v<T>)
+				{
+					//Zigzag so small negative numbers are small too: 0, -1, 1, -2... become 0, 1, 2, 3...
+					uint64_t bits = (uint64_t)(int64_t)value;
+					WriteVarint((bits << 1) ^ (uint64_t)((int64_t)value >> 63));
+				}
+				else
+					WriteVarint((uint64_t)value);
+				return;
+			}
+		}
+
+		if constexpr (is_trivially_copyable_v<T>)
+			WriteBytes(&value, sizeof(T));
+		else
+			SerialTraits<T>::Write(*this, value);
+	}
+
+	/// <summary>
+	/// Write an array of elements.
+	/// Raw elements are copied in one piece.
+	/// </summary>
+	/// <param name="values">The elements to write.</param>
+	/// <param name="count">The number of elements.</param>
+	template <typename T>
+	void WriteValues(const T* values, size_t count)
+	{
+		if (count > 0 && EncodingOf<T>() == SERIAL_RAW)
+			WriteBytes(values, sizeof(T) * count);
+		else
+			for (size_t i = 0; i < count; ++i)
+				WriteValue(values[i]);
+	}
+
+	/// <summary>
+	/// Write the bytes waiting in the buffer and flush the stream, checking that everything was written.
+	/// </summary>
+	void Flush()
+	{
+		WriteBuffer();
+		stream.flush();
+		if (!stream)
+			throw runtime_error("Could not write to the stream.");
+	}
+};
+
+/// <summary>
+/// The Binary Reader reads containers written by a Binary Writer from an input stream.
+/// Reads go through a 64KB buffer, and arrays larger than the buffer are read straight into the container.
+/// The reader reads ahead, so the same reader should be used for everything after the first container in a stream.
+/// </summary>
+class BinaryReader
+{
+private:
+	static const size_t BUFFER_SIZE = 65536;
+
+	istream& stream;			//The stream being read from
+	char* buffer;				//The bytes read from the stream that haven't been used
+	size_t position;			//The index of the next byte in the buffer
+	size_t available;			//The number of bytes in the buffer
+	SERIAL_ENCODING encoding;	//The encoding of the container being read
+	uint8_t flags;				//The flags of the container being read
+
+	/// <summary>
+	/// Throw an exception for a stream that ended too early.
+	/// </summary>
+	[[noreturn]] static void Truncated()
+	{
+		throw runtime_error("The stream ended part way through a container.");
+	}
+
+	/// <summary>
+	/// Read a fixed number of little-endian bytes as an unsigned number.
+	/// </summary>
+	/// <param name="bytes">The number of bytes to read.</param>
+	/// <returns>The number.</returns>
+	uint64_t ReadFixed(size_t bytes)
+	{
+		unsigned char encoded[8];
+		ReadBytes(encoded, bytes);
+		uint64_t value = 0;
+		for (size_t i = 0; i < bytes; ++i)
+			value |= (uint64_t)encoded[i] << (8 * i);
+		return value;
+	}
+
+public:
+	/// <summary>
+	/// Overloaded constructor.
+	/// </summary>
+	/// <param name="_stream">The stream to read from. It should be opened in binary mode.</param>
+	BinaryReader(istream& _stream) : stream(_stream)
+	{
+		buffer = new char[BUFFER_SIZE];
+		position = 0;
+		available = 0;
+		encoding = SERIAL_RAW;
+		flags = 0;
+	}
+
+	BinaryReader(const BinaryReader&) = delete;
+	BinaryReader& operator= (const BinaryReader&) = delete;
+
+	/// <summary>
+	/// Deconstructor.
+	/// </summary>
+	~BinaryReader()
+	{
+		delete[] buffer;
+	}
+
+	/// <summary>
+	/// Read some bytes, throwing an exception if the stream ends first.
+	/// </summary>
+	/// <param name="bytes">Where to put the bytes.</param>
+	/// <param name="count">The number of bytes to read.</param>
+	void ReadBytes(void* bytes, size_t count)
+	{
+		char* target = static_cast<char*>(bytes);
+
+		//Use the bytes already in the buffer first
+		size_t buffered = available - position < count ? available - position : count;
+		memcpy(target, buffer + position, buffered);
+		position += buffered;
+		target += buffered;
+		count -= buffered;
+		if (count == 0)
+			return;
+
+		//Read anything too large for the buffer straight into the target
+		if (count >= BUFFER_SIZE)
+		{
+			stream.read(target, (streamsize)count);
+			if ((size_t)stream.gcount() != count)
+				Truncated();
+			return;
+		}
+
+		stream.read(buffer, (streamsize)BUFFER_SIZE);
+		available = (size_t)stream.gcount();
+		position = 0;
+		if (available < count)
+			Truncated();
+		memcpy(target, buffer, count);
+		position = count;
+	}
+
+	/// <summary>
+	/// Read a varint written by BinaryWriter::WriteVarint().
+	/// </summary>
+	/// <returns>The number.</returns>
+	uint64_t ReadVarint()
+	{
+		uint64_t value = 0;
+		for (unsigned int shift = 0; shift < 64; shift += 7)
+		{
+			unsigned char byte;
+			ReadBytes(&byte, 1);
+			value |= (uint64_t)(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+				return value;
+		}
+		throw runtime_error("The stream holds a varint that is too long.");
+	}
+
+	/// <summary>
+	/// Read the header of a container and check that it holds elements of this type.
+	/// </summary>
+	/// <param name="container">The kind of container that is expected.</param>
+	/// <returns>The number of elements that follow.</returns>
+	template <typename T>
+	size_t ReadHeader(SERIAL_CONTAINER container)
+	{
+		char magic[sizeof(SERIAL_MAGIC)];
+		ReadBytes(magic, sizeof(magic));
+		if (memcmp(magic, SERIAL_MAGIC, sizeof(SERIAL_MAGIC)) != 0)
+			throw runtime_error("The stream does not hold a serialized container.");
+		if (ReadFixed(1) != SERIAL_VERSION)
+			throw runtime_error("The stream was written by a different version of the format.");
+		if (ReadFixed(1) != (uint64_t)container)
+			throw runtime_error("The stream holds a different kind of container.");
+		encoding = (SERIAL_ENCODING)ReadFixed(1);
+		flags = (uint8_t)ReadFixed(1);
+		uint64_t elementSize = ReadFixed(4);
+		uint64_t count = ReadFixed(8);
+
+		//Check the elements can be read as this type
+		bool readable;
+		if (encoding == SERIAL_RAW)
+		{
+			const uint16_t order = 1;
+			bool bigEndian = *reinterpret_cast<const uint8_t*>(&order) == 0;
+			if (((flags & SERIAL_BIG_ENDIAN) != 0) != bigEndian)
+				throw runtime_error("The stream was written by a machine with a different byte order.");
+			readable = is_trivially_copyable_v<T> && elementSize == sizeof(T);
+		}
+		else if (encoding == SERIAL_VARINT)
+			readable = is_integral_v<T> && elementSize == sizeof(T);
+		else if (encoding == SERIAL_ELEMENTWISE)
+			readable = SerialTraits<T>::SUPPORTED;
+		else
+			readable = false;
+		if (!readable)
+			throw runtime_error("The stream holds elements of a different type.");
+		if (count > (uint64_t)numeric_limits<size_t>::max())
+			throw length_error("The stream holds more elements than can be addressed.");
+
+		return (size_t)count;
+	}
+
+	/// <summary>
+	/// Get the flags of the last header that was read, e.g. SERIAL_SORTED.
+	/// </summary>
+	/// <returns>The flags.</returns>
+	uint8_t Flags() const
+	{
+		return flags;
+	}
+
+	/// <summary>
+	/// Read one element.
+	/// </summary>
+	/// <param name="value">The element to read into.</param>
+	template <typename T>
+	void ReadValue(T& value)
+	{
+		if constexpr (is_integral_v<T>)
+		{
+			if (encoding == SERIAL_VARINT)
+			{
+				uint64_t bits = ReadVarint();
+				if constexpr (is_signed_v<T>)
+					value = (T)(int64_t)((bits >> 1) ^ (0 - (bits & 1)));
+				else
+					value = (T)bits;
+				return;
+			}
+		}
+
+		if constexpr (is_trivially_copyable_v<T>)
+		{
+			if (encoding == SERIAL_RAW)
+				ReadBytes(&value, sizeof(T));
+		}
+		if constexpr (SerialTraits<T>::SUPPORTED)
+		{
+			if (encoding == SERIAL_ELEMENTWISE)
+				SerialTraits<T>::Read(*this, value);
+		}
+	}
+
+	/// <summary>
+	/// Read an array of elements.
+	/// Raw elements are copied in one piece, so for trivially copyable types the array can be uninitialised memory.
+	/// </summary>
+	/// <param name="values">The array to read into.</param>
+	/// <param name="count">The number of elements to read.</param>
+	template <typename T>
+	void ReadValues(T* values, size_t count)
+	{
+		if constexpr (is_trivially_copyable_v<T>)
+		{
+			if (encoding == SERIAL_RAW)
+			{
+				if (count > 0)
+					ReadBytes(values, sizeof(T) * count);
+				return;
+			}
+		}
+
+		for (size_t i = 0; i < count; ++i)
+			ReadValue(values[i]);
+	}
+};
+
+/// <summary>
+/// Strings are written as a varint length followed by their characters.
+/// </summary>
+template <>
+struct SerialTraits<string>
+{
+	static constexpr bool SUPPORTED = true;
+
+	static void Write(BinaryWriter& writer, const string& value)
+	{
+		writer.WriteVarint(value.size());
+		writer.WriteBytes(value.data(), value.size());
+	}
+
+	static void Read(BinaryReader& reader, string& value)
+	{
+		//Read long strings in pieces so a corrupt length can't allocate more than the stream holds
+		size_t length = (size_t)reader.ReadVarint();
+		value.clear();
+		while (value.size() < length)
+		{
+			size_t piece = length - value.size() < 65536 ? length - value.size() : 65536;
+			size_t start = value.size();
+			value.resize(start + piece);
+			reader.ReadBytes(&value[start], piece);
+		}
+	}
+};
\ No newline at end of file
@@ -0,0 +1,893 @@
+/*
+	File: SimdKernels.h
+	Contains: SimdKernels
+*/
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIMD_KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+//GCC and Clang only allow AVX2/SSE4.2 instructions in functions that are marked for them,
+//MSVC allows them anywhere
+#if defined(SIMD_KERNELS_X86) && !defined(_MSC_VER)
+#define SIMD_TARGET_SSE42 __attribute__((target("sse4.2,popcnt")))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#else
+#define SIMD_TARGET_SSE42
+#define SIMD_TARGET_AVX2
+#endif
+
+using namespace std;
+
+/// <summary>
+/// Vectorised kernels for scanning contiguous arrays of numbers.
+/// Each kernel has an AVX2, an SSE4.2 and a scalar version, and the best one the processor supports is picked at runtime.
+/// Types without a vectorised version (including non-arithmetic types) always use the scalar version, so the kernels can be called with any T that has ==.
+/// The reductions (Sum, MinMax) and the prefix sum only take arithmetic types.
+/// </summary>
+namespace SimdKernels
+{
+	//The instruction sets that the kernels can use
+	enum SIMD_LEVEL { SIMD_SCALAR, SIMD_SSE42, SIMD_AVX2 };
+
+	/// <summary>
+	/// Ask the processor which instruction sets it supports.
+	/// </summary>
+	/// <returns>The best instruction set that the kernels can use.</returns>
+	inline SIMD_LEVEL DetectLevel()
+	{
+#if defined(SIMD_KERNELS_X86) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+		__cpuid(info, 1);
+		bool sse42 = (info[2] & (1 << 20)) != 0;
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		bool avx2 = false;
+		if (maxLeaf >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+		}
+
+		//The operating system must also save the AVX registers
+		if (avx2 && osxsave && avx && (_xgetbv(0) & 6) == 6)
+			return SIMD_AVX2;
+		if (sse42)
+			return SIMD_SSE42;
+		return SIMD_SCALAR;
+#elif defined(SIMD_KERNELS_X86)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			return SIMD_AVX2;
+		if (__builtin_cpu_supports("sse4.2"))
+			return SIMD_SSE42;
+		return SIMD_SCALAR;
+#else
+		return SIMD_SCALAR;
+#endif
+	}
+
+	/// <summary>
+	/// Get the instruction set that the kernels use.
+	/// The processor is only asked once.
+	/// </summary>
+	/// <returns>The best instruction set that the kernels can use.</returns>
+	inline SIMD_LEVEL Level()
+	{
+		static const SIMD_LEVEL level = DetectLevel();
+		return level;
+	}
+
+	/// <summary>
+	/// Get the instruction set that the kernels use, capped at a limit.
+	/// </summary>
+	/// <param name="limit">The most advanced instruction set to use.</param>
+	/// <returns>The lower of the limit and the best instruction set the processor supports.</returns>
+	inline SIMD_LEVEL LimitLevel(SIMD_LEVEL limit)
+	{
+		SIMD_LEVEL level = Level();
+		return limit < level ? limit : level;
+	}
+
+	/// <summary>
+	/// True if T has a vectorised version of the kernels.
+	/// Integers are compared by their bits and floats with the processor's float compare, so the result always matches ==.
+	/// </summary>
+	template <typename T>
+	constexpr bool HasKernel = (is_integral_v<T> && !is_same_v<T, bool> && sizeof(T) <= 8)
+		|| is_same_v<T, float> || is_same_v<T, double>;
+
+	/// <summary>
+	/// The type that the vectorised kernels treat T as.
+	/// Integers of any signedness compare the same by their bits, so they share the signed kernels.
+	/// </summary>
+	template <typename T>
+	using LaneType = conditional_t<is_floating_point_v<T>, T,
+		conditional_t<sizeof(T) == 1, int8_t,
+		conditional_t<sizeof(T) == 2, int16_t,
+		conditional_t<sizeof(T) == 4, int32_t, int64_t>>>>;
+
+	/// <summary>
+	/// True if T has a vectorised version of the reductions and the prefix sum.
+	/// Only signed integers are vectorised, as the vector min, max and widening instructions differ for unsigned ones.
+	/// </summary>
+	template <typename T>
+	constexpr bool HasReductionKernel = (is_integral_v<T> && is_signed_v<T> && (sizeof(T) == 4 || sizeof(T) == 8))
+		|| is_same_v<T, float> || is_same_v<T, double>;
+
+	/// <summary>
+	/// The type that Sum() adds values up in.
+	/// Integers are widened to 64 bits so that sums of small integers don't overflow.
+	/// </summary>
+	template <typename T>
+	using SumType = conditional_t<is_floating_point_v<T>, T, conditional_t<is_signed_v<T>, long long, unsigned long long>>;
+
+	/// <summary>
+	/// Count the number of zero bits below the lowest set bit.
+	/// </summary>
+	/// <param name="value">The value to check. Must not be zero.</param>
+	/// <returns>The number of trailing zero bits.</returns>
+	inline unsigned int CountTrailingZeros(uint32_t value)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, value);
+		return (unsigned int)index;
+#else
+		return (unsigned int)__builtin_ctz(value);
+#endif
+	}
+
+	/// <summary>
+	/// Count the number of set bits.
+	/// </summary>
+	/// <param name="value">The value to check.</param>
+	/// <returns>The number of set bits.</returns>
+	inline unsigned int PopCount(uint32_t value)
+	{
+#ifdef _MSC_VER
+		value = value - ((value >> 1) & 0x55555555);
+		value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+		return (((value + (value >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+#else
+		return (unsigned int)__builtin_popcount(value);
+#endif
+	}
+
+	/// <summary>
+	/// Keep every second bit of a mask and pack them together.
+	/// Byte masks of 16-bit lanes have two bits per lane, this turns them into one bit per lane.
+	/// </summary>
+	/// <param name="mask">A mask with pairs of equal bits.</param>
+	/// <returns>The mask with one bit per pair.</returns>
+	inline uint32_t PackEvenBits(uint32_t mask)
+	{
+		mask &= 0x55555555;
+		mask = (mask | (mask >> 1)) & 0x33333333;
+		mask = (mask | (mask >> 2)) & 0x0F0F0F0F;
+		mask = (mask | (mask >> 4)) & 0x00FF00FF;
+		mask = (mask | (mask >> 8)) & 0x0000FFFF;
+		return mask;
+	}
+
+#ifdef SIMD_KERNELS_X86
+	//Each Match function compares one vector of values against the value being searched for,
+	//and returns a mask with one bit per lane that is set where the values are equal
+
+	SIMD_TARGET_SSE42 inline uint32_t MatchSse(const void* data, int8_t value)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i*)data);
+		return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(value)));
+	}
+
+	SIMD_TARGET_SSE42 inline uint32_t MatchSse(const void* data, int16_t value)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i*)data);
+		return PackEvenBits((uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi16(block, _mm_set1_epi16(value))));
+	}
+
+	SIMD_TARGET_SSE42 inline uint32_t MatchSse(const void* data, int32_t value)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i*)data);
+		return (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, _mm_set1_epi32(value))));
+	}
+
+	SIMD_TARGET_SSE42 inline uint32_t MatchSse(const void* data, int64_t value)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i*)data);
+		return (uint32_t)_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(block, _mm_set1_epi64x(value))));
+	}
+
+	SIMD_TARGET_SSE42 inline uint32_t MatchSse(const void* data, float value)
+	{
+		return (uint32_t)_mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps((const float*)data), _mm_set1_ps(value)));
+	}
+
+	SIMD_TARGET_SSE42 inline uint32_t MatchSse(const void* data, double value)
+	{
+		return (uint32_t)_mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd((const double*)data), _mm_set1_pd(value)));
+	}
+
+	SIMD_TARGET_AVX2 inline uint32_t MatchAvx2(const void* data, int8_t value)
+	{
+		__m256i block = _mm256_loadu_si256((const __m256i*)data);
+		return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(value)));
+	}
+
+	SIMD_TARGET_AVX2 inline uint32_t MatchAvx2(const void* data, int16_t value)
+	{
+		__m256i block = _mm256_loadu_si256((const __m256i*)data);
+		return PackEvenBits((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi16(block, _mm256_set1_epi16(value))));
+	}
+
+	SIMD_TARGET_AVX2 inline uint32_t MatchAvx2(const void* data, int32_t value)
+	{
+		__m256i block = _mm256_loadu_si256((const __m256i*)data);
+		return (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(block, _mm256_set1_epi32(value))));
+	}
+
+	SIMD_TARGET_AVX2 inline uint32_t MatchAvx2(const void* data, int64_t value)
+	{
+		__m256i block = _mm256_loadu_si256((const __m256i*)data);
+		return (uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(block, _mm256_set1_epi64x(value))));
+	}
+
+	SIMD_TARGET_AVX2 inline uint32_t MatchAvx2(const void* data, float value)
+	{
+		return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps((const float*)data), _mm256_set1_ps(value), _CMP_EQ_OQ));
+	}
+
+	SIMD_TARGET_AVX2 inline uint32_t MatchAvx2(const void* data, double value)
+	{
+		return (uint32_t)_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd((const double*)data), _mm256_set1_pd(value), _CMP_EQ_OQ));
+	}
+
+	/// <summary>
+	/// Find the first value using SSE4.2.
+	/// </summary>
+	template <typename Lane, typename T>
+	SIMD_TARGET_SSE42 size_t FindFirstSse(const T* data, size_t count, const T& value)
+	{
+		const size_t WIDTH = 16 / sizeof(T);
+		Lane needle;
+		memcpy(&needle, &value, sizeof(T));
+
+		size_t i = 0;
+		for (; i + WIDTH <= count; i += WIDTH)
+		{
+			uint32_t mask = MatchSse(data + i, needle);
+			if (mask != 0)
+				return i + CountTrailingZeros(mask);
+		}
+		for (; i < count; ++i)
+			if (data[i] == value)
+				return i;
+		return count;
+	}
+
+	/// <summary>
+	/// Find the first value using AVX2.
+	/// </summary>
+	template <typename Lane, typename T>
+	SIMD_TARGET_AVX2 size_t FindFirstAvx2(const T* data, size_t count, const T& value)
+	{
+		const size_t WIDTH = 32 / sizeof(T);
+		Lane needle;
+		memcpy(&needle, &value, sizeof(T));
+
+		size_t i = 0;
+		for (; i + WIDTH <= count; i += WIDTH)
+		{
+			uint32_t mask = MatchAvx2(data + i, needle);
+			if (mask != 0)
+				return i + CountTrailingZeros(mask);
+		}
+		for (; i < count; ++i)
+			if (data[i] == value)
+				return i;
+		return count;
+	}
+
+	/// <summary>
+	/// Count a value using SSE4.2.
+	/// </summary>
+	template <typename Lane, typename T>
+	SIMD_TARGET_SSE42 size_t CountSse(const T* data, size_t count, const T& value)
+	{
+		const size_t WIDTH = 16 / sizeof(T);
+		Lane needle;
+		memcpy(&needle, &value, sizeof(T));
+
+		size_t total = 0;
+		size_t i = 0;
+		for (; i + WIDTH <= count; i += WIDTH)
+			total += PopCount(MatchSse(data + i, needle));
+		for (; i < count; ++i)
+			if (data[i] == value)
+				++total;
+		return total;
+	}
+
+	/// <summary>
+	/// Count a value using AVX2.
+	/// </summary>
+	template <typename Lane, typename T>
+	SIMD_TARGET_AVX2 size_t CountAvx2(const T* data, size_t count, const T& value)
+	{
+		const size_t WIDTH = 32 / sizeof(T);
+		Lane needle;
+		memcpy(&needle, &value, sizeof(T));
+
+		size_t total = 0;
+		size_t i = 0;
+		for (; i + WIDTH <= count; i += WIDTH)
+			total += PopCount(MatchAvx2(data + i, needle));
+		for (; i < count; ++i)
+			if (data[i] == value)
+				++total;
+		return total;
+	}
+
+	/// <summary>
+	/// Find every position of a value using SSE4.2.
+	/// The vector width always divides 64, so a vector's bits never straddle two words of the mask.
+	/// </summary>
+	template <typename Lane, typename T>
+	SIMD_TARGET_SSE42 void FindAllSse(const T* data, size_t count, const T& value, uint64_t* mask)
+	{
+		const size_t WIDTH = 16 / sizeof(T);
+		Lane needle;
+		memcpy(&needle, &value, sizeof(T));
+
+		size_t i = 0;
+		for (; i + WIDTH <= count; i += WIDTH)
+			mask[i / 64] |= (uint64_t)MatchSse(data + i, needle) << (i % 64);
+		for (; i < count; ++i)
+			if (data[i] == value)
+				mask[i / 64] |= (uint64_t)1 << (i % 64);
+	}
+
+	/// <summary>
+	/// Find every position of a value using AVX2.
+	/// </summary>
+	template <typename Lane, typename T>
+	SIMD_TARGET_AVX2 void FindAllAvx2(const T* data, size_t count, const T& value, uint64_t* mask)
+	{
+		const size_t WIDTH = 32 / sizeof(T);
+		Lane needle;
+		memcpy(&needle, &value, sizeof(T));
+
+		size_t i = 0;
+		for (; i + WIDTH <= count; i += WIDTH)
+			mask[i / 64] |= (uint64_t)MatchAvx2(data + i, needle) << (i % 64);
+		for (; i < count; ++i)
+			if (data[i] == value)
+				mask[i / 64] |= (uint64_t)1 << (i % 64);
+	}
+
+	/// <summary>
+	/// Add up an array using SSE4.2.
+	/// 32-bit integers are widened to 64 bits before they are added.
+	/// </summary>
+	template <typename T>
+	SIMD_TARGET_SSE42 SumType<T> SumSse(const T* data, size_t count)
+	{
+		const size_t WIDTH = 16 / sizeof(T);
+		SumType<T> total = 0;
+		size_t i = 0;
+		if constexpr (is_same_v<T, float>)
+		{
+			__m128 sum = _mm_setzero_ps();
+			for (; i + WIDTH <= count; i += WIDTH)
+				sum = _mm_add_ps(sum, _mm_loadu_ps((const float*)(data + i)));
+			float lanes[4];
+			_mm_storeu_ps(lanes, sum);
+			total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		}
+		else if constexpr (is_same_v<T, double>)
+		{
+			__m128d sum = _mm_setzero_pd();
+			for (; i + WIDTH <= count; i += WIDTH)
+				sum = _mm_add_pd(sum, _mm_loadu_pd((const double*)(data + i)));
+			double lanes[2];
+			_mm_storeu_pd(lanes, sum);
+			total = lanes[0] + lanes[1];
+		}
+		else
+		{
+			__m128i sum = _mm_setzero_si128();
+			for (; i + WIDTH <= count; i += WIDTH)
+			{
+				__m128i block = _mm_loadu_si128((const __m128i*)(data + i));
+				if constexpr (sizeof(T) == 4)
+					sum = _mm_add_epi64(sum, _mm_add_epi64(_mm_cvtepi32_epi64(block), _mm_cvtepi32_epi64(_mm_srli_si128(block, 8))));
+				else
+					sum = _mm_add_epi64(sum, block);
+			}
+			long long lanes[2];
+			_mm_storeu_si128((__m128i*)lanes, sum);
+			total = (SumType<T>)((unsigned long long)lanes[0] + (unsigned long long)lanes[1]);
+		}
+		for (; i < count; ++i)
+			total += data[i];
+		return total;
+	}
+
+	/// <summary>
+	/// Add up an array using AVX2.
+	/// </summary>
+	template <typename T>
+	SIMD_TARGET_AVX2 SumType<T> SumAvx2(const T* data, size_t count)
+	{
+		const size_t WIDTH = 32 / sizeof(T);
+		SumType<T> total = 0;
+		size_t i = 0;
+		if constexpr (is_same_v<T, float>)
+		{
+			__m256 sum = _mm256_setzero_ps();
+			for (; i + WIDTH <= count; i += WIDTH)
+				sum = _mm256_add_ps(sum, _mm256_loadu_ps((const float*)(data + i)));
+			float lanes[8];
+			_mm256_storeu_ps(lanes, sum);
+			total = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+		}
+		else if constexpr (is_same_v<T, double>)
+		{
+			__m256d sum = _mm256_setzero_pd();
+			for (; i + WIDTH <= count; i += WIDTH)
+				sum = _mm256_add_pd(sum, _mm256_loadu_pd((const double*)(data + i)));
+			double lanes[4];
+			_mm256_storeu_pd(lanes, sum);
+			total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		}
+		else
+		{
+			__m256i sum = _mm256_setzero_si256();
+			for (; i + WIDTH <= count; i += WIDTH)
+			{
+				__m256i block = _mm256_loadu_si256((const __m256i*)(data + i));
+				if constexpr (sizeof(T) == 4)
+					sum = _mm256_add_epi64(sum, _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(block)),
+						_mm256_cvtepi32_epi64(_mm256_extracti128_si256(block, 1))));
+				else
+					sum = _mm256_add_epi64(sum, block);
+			}
+			long long lanes[4];
+			_mm256_storeu_si256((__m256i*)lanes, sum);
+			unsigned long long bits = 0;
+			for (int lane = 0; lane < 4; ++lane)
+				bits += (unsigned long long)lanes[lane];
+			total = (SumType<T>)bits;
+		}
+		for (; i < count; ++i)
+			total += data[i];
+		return total;
+	}
+
+	/// <summary>
+	/// Find the smallest and largest values of a non-empty array using SSE4.2.
+	/// </summary>
+	template <typename T>
+	SIMD_TARGET_SSE42 void MinMaxSse(const T* data, size_t count, T& smallest, T& largest)
+	{
+		const size_t WIDTH = 16 / sizeof(T);
+		smallest = data[0];
+		largest = data[0];
+		size_t i = 0;
+		if (count >= WIDTH)
+		{
+			T lanesMin[WIDTH];
+			T lanesMax[WIDTH];
+			if constexpr (is_same_v<T, float>)
+			{
+				__m128 low = _mm_set1_ps(data[0]);
+				__m128 high = low;
+				for (; i + WIDTH <= count; i += WIDTH)
+				{
+					__m128 block = _mm_loadu_ps((const float*)(data + i));
+					low = _mm_min_ps(block, low);
+					high = _mm_max_ps(block, high);
+				}
+				_mm_storeu_ps((float*)lanesMin, low);
+				_mm_storeu_ps((float*)lanesMax, high);
+			}
+			else if constexpr (is_same_v<T, double>)
+			{
+				__m128d low = _mm_set1_pd(data[0]);
+				__m128d high = low;
+				for (; i + WIDTH <= count; i += WIDTH)
+				{
+					__m128d block = _mm_loadu_pd((const double*)(data + i));
+					low = _mm_min_pd(block, low);
+					high = _mm_max_pd(block, high);
+				}
+				_mm_storeu_pd((double*)lanesMin, low);
+				_mm_storeu_pd((double*)lanesMax, high);
+			}
+			else
+			{
+				__m128i low = sizeof(T) == 4 ? _mm_set1_epi32((int32_t)data[0]) : _mm_set1_epi64x((long long)data[0]);
+				__m128i high = low;
+				for (; i + WIDTH <= count; i += WIDTH)
+				{
+					__m128i block = _mm_loadu_si128((const __m128i*)(data + i));
+					if constexpr (sizeof(T) == 4)
+					{
+						low = _mm_min_epi32(low, block);
+						high = _mm_max_epi32(high, block);
+					}
+					else
+					{
+						low = _mm_blendv_epi8(low, block, _mm_cmpgt_epi64(low, block));
+						high = _mm_blendv_epi8(high, block, _mm_cmpgt_epi64(block, high));
+					}
+				}
+				_mm_storeu_si128((__m128i*)lanesMin, low);
+				_mm_storeu_si128((__m128i*)lanesMax, high);
+			}
+			for (size_t lane = 0; lane < WIDTH; ++lane)
+			{
+				if (lanesMin[lane] < smallest)
+					smallest = lanesMin[lane];
+				if (largest < lanesMax[lane])
+					largest = lanesMax[lane];
+			}
+		}
+		for (; i < count; ++i)
+		{
+			if (data[i] < smallest)
+				smallest = data[i];
+			if (largest < data[i])
+				largest = data[i];
+		}
+	}
+
+	/// <summary>
+	/// Find the smallest and largest values of a non-empty array using AVX2.
+	/// </summary>
+	template <typename T>
+	SIMD_TARGET_AVX2 void MinMaxAvx2(const T* data, size_t count, T& smallest, T& largest)
+	{
+		const size_t WIDTH = 32 / sizeof(T);
+		smallest = data[0];
+		largest = data[0];
+		size_t i = 0;
+		if (count >= WIDTH)
+		{
+			T lanesMin[WIDTH];
+			T lanesMax[WIDTH];
+			if constexpr (is_same_v<T, float>)
+			{
+				__m256 low = _mm256_set1_ps(data[0]);
+				__m256 high = low;
+				for (; i + WIDTH <= count; i += WIDTH)
+				{
+					__m256 block = _mm256_loadu_ps((const float*)(data + i));
+					low = _mm256_min_ps(block, low);
+					high = _mm256_max_ps(block, high);
+				}
+				_mm256_storeu_ps((float*)lanesMin, low);
+				_mm256_storeu_ps((float*)lanesMax, high);
+			}
+			else if constexpr (is_same_v<T, double>)
+			{
+				__m256d low = _mm256_set1_pd(data[0]);
+				__m256d high = low;
+				for (; i + WIDTH <= count; i += WIDTH)
+				{
+					__m256d block = _mm256_loadu_pd((const double*)(data + i));
+					low = _mm256_min_pd(block, low);
+					high = _mm256_max_pd(block, high);
+				}
+				_mm256_storeu_pd((double*)lanesMin, low);
+				_mm256_storeu_pd((double*)lanesMax, high);
+			}
+			else
+			{
+				__m256i low = sizeof(T) == 4 ? _mm256_set1_epi32((int32_t)data[0]) : _mm256_set1_epi64x((long long)data[0]);
+				__m256i high = low;
+				for (; i + WIDTH <= count; i += WIDTH)
+				{
+					__m256i block = _mm256_loadu_si256((const __m256i*)(data + i));
+					if constexpr (sizeof(T) == 4)
+					{
+						low = _mm256_min_epi32(low, block);
+						high = _mm256_max_epi32(high, block);
+					}
+					else
+					{
+						low = _mm256_blendv_epi8(low, block, _mm256_cmpgt_epi64(low, block));
+						high = _mm256_blendv_epi8(high, block, _mm256_cmpgt_epi64(block, high));
+					}
+				}
+				_mm256_storeu_si256((__m256i*)lanesMin, low);
+				_mm256_storeu_si256((__m256i*)lanesMax, high);
+			}
+			for (size_t lane = 0; lane < WIDTH; ++lane)
+			{
+				if (lanesMin[lane] < smallest)
+					smallest = lanesMin[lane];
+				if (largest < lanesMax[lane])
+					largest = lanesMax[lane];
+			}
+		}
+		for (; i < count; ++i)
+		{
+			if (data[i] < smallest)
+				smallest = data[i];
+			if (largest < data[i])
+				largest = data[i];
+		}
+	}
+
+	/// <summary>
+	/// Replace each value with the sum of itself and every value before it, plus an offset, using SSE4.2.
+	/// Each vector is scanned in two shifted adds, then the running total of the vectors before it is added.
+	/// </summary>
+	template <typename T>
+	SIMD_TARGET_SSE42 T PrefixSumSse(T* data, size_t count, T offset)
+	{
+		const size_t WIDTH = 16 / sizeof(T);
+		size_t i = 0;
+		if constexpr (is_same_v<T, float>)
+		{
+			__m128 carry = _mm_set1_ps(offset);
+			for (; i + WIDTH <= count; i += WIDTH)
+			{
+				__m128 block = _mm_loadu_ps((const float*)(data + i));
+				block = _mm_add_ps(block, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(block), 4)));
+				block = _mm_add_ps(block, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(block), 8)));
+				block = _mm_add_ps(block, carry);
+				_mm_storeu_ps((float*)(data + i), block);
+				carry = _mm_shuffle_ps(block, block, 0xFF);
+			}
+			offset = _mm_cvtss_f32(carry);
+		}
+		else if constexpr (is_same_v<T, double>)
+		{
+			__m128d carry = _mm_set1_pd(offset);
+			for (; i + WIDTH <= count; i += WIDTH)
+			{
+				__m128d block = _mm_loadu_pd((const double*)(data + i));
+				block = _mm_add_pd(block, _mm_castsi128_pd(_mm_slli_si128(_mm_castpd_si128(block), 8)));
+				block = _mm_add_pd(block, carry);
+				_mm_storeu_pd((double*)(data + i), block);
+				carry = _mm_unpackhi_pd(block, block);
+			}
+			offset = _mm_cvtsd_f64(carry);
+		}
+		else if constexpr (sizeof(T) == 4)
+		{
+			__m128i carry = _mm_set1_epi32((int32_t)offset);
+			for (; i + WIDTH <= count; i += WIDTH)
+			{
+				__m128i block = _mm_loadu_si128((const __m128i*)(data + i));
+				block = _mm_add_epi32(block, _mm_slli_si128(block, 4));
+				block = _mm_add_epi32(block, _mm_slli_si128(block, 8));
+				block = _mm_add_epi32(block, carry);
+				_mm_storeu_si128((__m128i*)(data + i), block);
+				carry = _mm_shuffle_epi32(block, 0xFF);
+			}
+			offset = (T)_mm_cvtsi128_si32(carry);
+		}
+		else
+		{
+			__m128i carry = _mm_set1_epi64x((long long)offset);
+			for (; i + WIDTH <= count; i += WIDTH)
+			{
+				__m128i block = _mm_loadu_si128((const __m128i*)(data + i));
+				block = _mm_add_epi64(block, _mm_slli_si128(block, 8));
+				block = _mm_add_epi64(block, carry);
+				_mm_storeu_si128((__m128i*)(data + i), block);
+				carry = _mm_unpackhi_epi64(block, block);
+			}
+			long long lanes[2];
+			_mm_storeu_si128((__m128i*)lanes, carry);
+			offset = (T)lanes[0];
+		}
+		for (; i < count; ++i)
+		{
+			offset += data[i];
+			data[i] = offset;
+		}
+		return offset;
+	}
+#endif
+
+	/// <summary>
+	/// Find the first position of a value in an array.
+	/// </summary>
+	/// <param name="data">The array to search.</param>
+	/// <param name="count">The number of values in the array.</param>
+	/// <param name="value">The value to search for.</param>
+	/// <param name="limit">The most advanced instruction set to use, so the versions can be compared. The processor's best is used if it is lower.</param>
+	/// <returns>The index of the first match, or count if the value isn't found.</returns>
+	template <typename T>
+	size_t FindFirst(const T* data, size_t count, const T& value, [[maybe_unused]] SIMD_LEVEL limit = SIMD_AVX2)
+	{
+#ifdef SIMD_KERNELS_X86
+		if constexpr (HasKernel<T>)
+		{
+			SIMD_LEVEL level = LimitLevel(limit);
+			if (level == SIMD_AVX2)
+				return FindFirstAvx2<LaneType<T>>(data, count, value);
+			if (level == SIMD_SSE42)
+				return FindFirstSse<LaneType<T>>(data, count, value);
+		}
+#endif
+		for (size_t i = 0; i < count; ++i)
+			if (data[i] == value)
+				return i;
+		return count;
+	}
+
+	/// <summary>
+	/// Count the number of times a value appears in an array.
+	/// </summary>
+	/// <param name="data">The array to search.</param>
+	/// <param name="count">The number of values in the array.</param>
+	/// <param name="value">The value to count.</param>
+	/// <param name="limit">The most advanced instruction set to use, so the versions can be compared. The processor's best is used if it is lower.</param>
+	/// <returns>The number of matches.</returns>
+	template <typename T>
+	size_t Count(const T* data, size_t count, const T& value, [[maybe_unused]] SIMD_LEVEL limit = SIMD_AVX2)
+	{
+#ifdef SIMD_KERNELS_X86
+		if constexpr (HasKernel<T>)
+		{
+			SIMD_LEVEL level = LimitLevel(limit);
+			if (level == SIMD_AVX2)
+				return CountAvx2<LaneType<T>>(data, count, value);
+			if (level == SIMD_SSE42)
+				return CountSse<LaneType<T>>(data, count, value);
+		}
+#endif
+		size_t total = 0;
+		for (size_t i = 0; i < count; ++i)
+			if (data[i] == value)
+				++total;
+		return total;
+	}
+
+	/// <summary>
+	/// Find every position of a value in an array.
+	/// Bit (i % 64) of mask[i / 64] is set if the value is at index i.
+	/// </summary>
+	/// <param name="data">The array to search.</param>
+	/// <param name="count">The number of values in the array.</param>
+	/// <param name="value">The value to search for.</param>
+	/// <param name="mask">Receives the matches. Must have room for (count + 63) / 64 words.</param>
+	template <typename T>
+	void FindAll(const T* data, size_t count, const T& value, uint64_t* mask)
+	{
+		memset(mask, 0, sizeof(uint64_t) * ((count + 63) / 64));
+#ifdef SIMD_KERNELS_X86
+		if constexpr (HasKernel<T>)
+		{
+			SIMD_LEVEL level = Level();
+			if (level == SIMD_AVX2)
+				return FindAllAvx2<LaneType<T>>(data, count, value, mask);
+			if (level == SIMD_SSE42)
+				return FindAllSse<LaneType<T>>(data, count, value, mask);
+		}
+#endif
+		for (size_t i = 0; i < count; ++i)
+			if (data[i] == value)
+				mask[i / 64] |= (uint64_t)1 << (i % 64);
+	}
+
+	/// <summary>
+	/// Add up the values in an array.
+	/// Floats are added in several lanes at once, so the result can round slightly differently to adding them in order.
+	/// </summary>
+	/// <param name="data">The array to add up.</param>
+	/// <param name="count">The number of values in the array.</param>
+	/// <param name="limit">The most advanced instruction set to use, so the versions can be compared. The processor's best is used if it is lower.</param>
+	/// <returns>The sum of the values, 0 if the array is empty.</returns>
+	template <typename T>
+	SumType<T> Sum(const T* data, size_t count, [[maybe_unused]] SIMD_LEVEL limit = SIMD_AVX2)
+	{
+		static_assert(is_arithmetic_v<T>, "Only arrays of numbers can be added up.");
+#ifdef SIMD_KERNELS_X86
+		if constexpr (HasReductionKernel<T>)
+		{
+			SIMD_LEVEL level = LimitLevel(limit);
+			if (level == SIMD_AVX2)
+				return SumAvx2(data, count);
+			if (level == SIMD_SSE42)
+				return SumSse(data, count);
+		}
+#endif
+		SumType<T> total = 0;
+		for (size_t i = 0; i < count; ++i)
+			total += data[i];
+		return total;
+	}
+
+	/// <summary>
+	/// Find the smallest and largest values in an array in one pass.
+	/// NaNs are skipped, so they are only returned if every value is a NaN.
+	/// </summary>
+	/// <param name="data">The array to search. Must not be empty.</param>
+	/// <param name="count">The number of values in the array.</param>
+	/// <param name="smallest">Receives the smallest value.</param>
+	/// <param name="largest">Receives the largest value.</param>
+	/// <param name="limit">The most advanced instruction set to use, so the versions can be compared. The processor's best is used if it is lower.</param>
+	template <typename T>
+	void MinMax(const T* data, size_t count, T& smallest, T& largest, [[maybe_unused]] SIMD_LEVEL limit = SIMD_AVX2)
+	{
+		static_assert(is_arithmetic_v<T>, "Only arrays of numbers have a minimum and maximum.");
+		if constexpr (is_floating_point_v<T>)
+		{
+			//Start from the first number, as a NaN first value would never be replaced
+			size_t first = 0;
+			while (first < count && data[first] != data[first])
+				++first;
+			if (first == count)
+			{
+				smallest = data[0];
+				largest = data[0];
+				return;
+			}
+			data += first;
+			count -= first;
+		}
+#ifdef SIMD_KERNELS_X86
+		if constexpr (HasReductionKernel<T>)
+		{
+			SIMD_LEVEL level = LimitLevel(limit);
+			if (level == SIMD_AVX2)
+				return MinMaxAvx2(data, count, smallest, largest);
+			if (level == SIMD_SSE42)
+				return MinMaxSse(data, count, smallest, largest);
+		}
+#endif
+		smallest = data[0];
+		largest = data[0];
+		for (size_t i = 1; i < count; ++i)
+		{
+			if (data[i] < smallest)
+				smallest = data[i];
+			if (largest < data[i])
+				largest = data[i];
+		}
+	}
+
+	/// <summary>
+	/// Replace each value in an array with the sum of itself and every value before it, plus an offset (an inclusive prefix sum).
+	/// Floats can round slightly differently to adding them in order.
+	/// </summary>
+	/// <param name="data">The array to sum.</param>
+	/// <param name="count">The number of values in the array.</param>
+	/// <param name="offset">The value added to every sum.</param>
+	/// <returns>The last sum, which is the offset if the array is empty.</returns>
+	template <typename T>
+	T PrefixSum(T* data, size_t count, T offset)
+	{
+		static_assert(is_arithmetic_v<T>, "Only arrays of numbers can be summed.");
+#ifdef SIMD_KERNELS_X86
+		if constexpr (HasReductionKernel<T>)
+		{
+			if (Level() != SIMD_SCALAR)
+				return PrefixSumSse(data, count, offset);
+		}
+#endif
+		for (size_t i = 0; i < count; ++i)
+		{
+			offset += data[i];
+			data[i] = offset;
+		}
+		return offset;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+/*
+	File: SmallList.h
+	Contains: SmallList
+*/
+
+#pragma once
+#include "DynamicList.h"
+
+using namespace std;
+
+/// <summary>
+/// The Small List is a List that keeps up to N elements inside the object itself.
+/// It only allocates memory on the heap once it grows past N elements, and moves back into the inline storage when it shrinks to fit again.
+/// It has the same interface as List and can be passed to anything that takes a List of the same policy.
+/// </summary>
+template <typename T, size_t N, typename Policy = ListPolicy>
+class SmallList : public List<T, Policy>
+{
+private:
+	static_assert(N > 0, "A small list needs room for at least one element.");
+
+	alignas(T) unsigned char buffer[sizeof(T) * N];		//The inline storage for the elements
+
+public:
+	/// <summary>
+	/// Default constructor.
+	/// Uses the inline storage, so nothing is allocated.
+	/// </summary>
+	SmallList() : List<T, Policy>(reinterpret_cast<T*>(buffer), N)
+	{
+
+	}
+
+	/// <summary>
+	/// Overloaded constructor.
+	/// Only allocates if the capacity is larger than N.
+	/// </summary>
+	/// <param name="_capacity">The initial capacity of this list.</param>
+	SmallList(size_t _capacity) : List<T, Policy>(reinterpret_cast<T*>(buffer), N)
+	{
+		this->Reserve(_capacity);
+	}
+
+	/// <summary>
+	/// Copy constructor.
+	/// </summary>
+	/// <param name="copy">The small list to copy.</param>
+	SmallList(const SmallList& copy) : List<T, Policy>(reinterpret_cast<T*>(buffer), N)
+	{
+		List<T, Policy>::operator=(copy);
+	}
+
+	/// <summary>
+	/// Overloaded constructor.
+	/// Copies any list with the same policy.
+	/// </summary>
+	/// <param name="copy">The list to copy.</param>
+	SmallList(const List<T, Policy>& copy) : List<T, Policy>(reinterpret_cast<T*>(buffer), N)
+	{
+		List<T, Policy>::operator=(copy);
+	}
+
+	/// <summary>
+	/// Move constructor.
+	/// Takes the other list's heap storage, or moves its elements if they are in its inline storage.
+	/// </summary>
+	/// <param name="other">The small list to move from.</param>
+	SmallList(SmallList&& other) noexcept : List<T, Policy>(reinterpret_cast<T*>(buffer), N)
+	{
+		List<T, Policy>::operator=(move(other));
+	}
+
+	/// <summary>
+	/// Overloaded constructor.
+	/// Moves from any list with the same policy.
+	/// </summary>
+	/// <param name="other">The list to move from.</param>
+	SmallList(List<T, Policy>&& other) noexcept : List<T, Policy>(reinterpret_cast<T*>(buffer), N)
+	{
+		List<T, Policy>::operator=(move(other));
+	}
+
+	/// <summary>
+	/// Deconstructor.
+	/// The elements are destroyed here, while the inline storage still exists.
+	/// </summary>
+	~SmallList()
+	{
+		this->Release();
+	}
+
+	/// <summary>
+	/// Getter for the inline capacity.
+	/// </summary>
+	/// <returns>The number of elements the list can hold without allocating.</returns>
+	static constexpr size_t InlineCapacity()
+	{
+		return N;
+	}
+
+	using List<T, Policy>::operator=;
+
+	/// <summary>
+	/// Assignment operator overload.
+	/// </summary>
+	/// <param name="other">The other small list to copy data from.</param>
+	/// <returns>This list with copied data.</returns>
+	SmallList& operator= (const SmallList& other)
+	{
+		List<T, Policy>::operator=(other);
+		return *this;
+	}
+
+	/// <summary>
+	/// Move assignment operator overload.
+	/// </summary>
+	/// <param name="other">The other small list to move data from.</param>
+	/// <returns>This list with the moved data.</returns>
+	SmallList& operator= (SmallList&& other) noexcept
+	{
+		List<T, Policy>::operator=(move(other));
+		return *this;
+	}
+};
\ No newline at end of file
@@ -6,11 +6,17 @@
 #pragma once
 #include <iostream>
 #include <sstream>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include "Serialization.h"
+#include "TextBuffer.h"
 
 using namespace std;
 
 /// <summary>
 /// The Stack class uses a dynamically created array to store the values.
+/// Values are only constructed when they are pushed, so the unused part of the array is uninitialised memory.
 /// </summary>
 template <typename T>
 class Stack
@@ -20,6 +26,99 @@ private:
 	unsigned int size;		//The number of values in the stack
 	unsigned int capacity;	//The maximum allowed number of values in the stack
 
+	static const size_t DESERIALIZE_CHUNK_BYTES = 1 << 20;	//The size of the pieces Deserialize() reads, growing the array before each one
+
+	/// <summary>
+	/// Allocate uninitialised memory for a number of values.
+	/// </summary>
+	/// <param name="count">The number of values to allocate memory for.</param>
+	/// <returns>A pointer to the start of the memory.</returns>
+	static T* Allocate(unsigned int count)
+	{
+		return static_cast<T*>(::operator new(sizeof(T) * count));
+	}
+
+	/// <summary>
+	/// Destroy a number of constructed values.
+	/// </summary>
+	/// <param name="first">The first value to destroy.</param>
+	/// <param name="count">The number of values to destroy.</param>
+	static void Destroy(T* first, unsigned int count)
+	{
+		if constexpr (!is_trivially_destructible_v<T>)
+			for (unsigned int i = 0; i < count; ++i)
+				first[i].~T();
+	}
+
+	/// <summary>
+	/// Copy the values of another stack into new memory.
+	/// Uses memcpy if the type allows it.
+	/// </summary>
+	/// <param name="other">The stack to copy.</param>
+	/// <returns>The new array containing the copied values.</returns>
+	static T* CopyData(const Stack<T>& other)
+	{
+		T* newData = Allocate(other.capacity);
+		if constexpr (is_trivially_copyable_v<T>)
+		{
+			if (other.size > 0)
+				memcpy(newData, other.data, sizeof(T) * other.size);
+		}
+		else
+		{
+			unsigned int i = 0;
+			try
+			{
+				for (; i < other.size; ++i)
+					new (newData + i) T(other.data[i]);
+			}
+			catch (...)
+			{
+				//Undo the copies that were made before the exception
+				Destroy(newData, i);
+				::operator delete(newData);
+				throw;
+			}
+		}
+		return newData;
+	}
+
+	/// <summary>
+	/// Move values into a larger array and free the old one.
+	/// If a move throws, the new array is freed and the old one is left as it was.
+	/// </summary>
+	/// <param name="oldData">The array holding the values.</param>
+	/// <param name="count">The number of values in the array.</param>
+	/// <param name="newCapacity">The number of values the new array can hold.</param>
+	/// <returns>The new array containing the values.</returns>
+	static T* Grow(T* oldData, unsigned int count, unsigned int newCapacity)
+	{
+		T* newData = Allocate(newCapacity);
+		if constexpr (is_trivially_copyable_v<T>)
+		{
+			if (count > 0)
+				memcpy(newData, oldData, sizeof(T) * count);
+		}
+		else
+		{
+			unsigned int i = 0;
+			try
+			{
+				for (; i < count; ++i)
+					new (newData + i) T(move(oldData[i]));
+			}
+			catch (...)
+			{
+				Destroy(newData, i);
+				::operator delete(newData);
+				throw;
+			}
+			Destroy(oldData, count);
+		}
+		::operator delete(oldData);
+		return newData;
+	}
+
 public:
 	/// <summary>
 	/// Default constructor.
@@ -29,8 +128,7 @@ public:
 		//Sets the initial values and creates the array
 		capacity = 10;
 		size = 0;
-		data = new T[capacity];
-		memset(data, 0, sizeof(T) * capacity);
+		data = Allocate(capacity);
 	}
 
 	/// <summary>
@@ -42,8 +140,7 @@ public:
 		//Sets values and creates the array
 		capacity = _capacity;
 		size = 0;
-		data = new T[capacity];
-		memset(data, 0, sizeof(T) * capacity);
+		data = Allocate(capacity);
 	}
 	
 	/// <summary>
@@ -53,10 +150,23 @@ public:
 	Stack(const Stack<T>& copy)
 	{
 		//Copy the data from the copy stack to this stack.
+		data = CopyData(copy);
 		capacity = copy.capacity;
 		size = copy.size;
-		data = new T[capacity];
-		memcpy(data, copy.data, sizeof(T) * capacity);
+	}
+
+	/// <summary>
+	/// Move constructor.
+	/// Takes the values from the other stack, leaving it empty.
+	/// </summary>
+	/// <param name="other">The stack to move from.</param>
+	Stack(Stack<T>&& other) noexcept
+	{
+		capacity = other.capacity;
+		size = other.size;
+		data = other.data;
+		other.data = nullptr;
+		other.size = 0;
 	}
 
 	/// <summary>
@@ -64,7 +174,9 @@ public:
 	/// </summary>
 	~Stack()
 	{
-		delete[] data;	//Delete the data
+		//Destroy the values and delete the data
+		Destroy(data, size);
+		::operator delete(data);
 	}
 
 	/// <summary>
@@ -72,10 +184,33 @@ public:
 	/// </summary>
 	/// <param name="value">The value to push.</param>
 	void Push(const T& value)
+	{
+		Emplace(value);
+	}
+
+	/// <summary>
+	/// Push a value to the stack by moving it, if there is space.
+	/// </summary>
+	/// <param name="value">The value to move onto the stack.</param>
+	void Push(T&& value)
+	{
+		Emplace(move(value));
+	}
+
+	/// <summary>
+	/// Construct a value in place on top of the stack if there is space.
+	/// </summary>
+	/// <param name="args">The arguments to pass to the value's constructor.</param>
+	template <typename... Args>
+	void Emplace(Args&&... args)
 	{
 		if (size < capacity)
 		{
-			data[size] = value;
+			//A moved-from stack gets its array back when it is used again
+			if (data == nullptr)
+				data = Allocate(capacity);
+
+			new (data + size) T(forward<Args>(args)...);
 			++size;
 		}
 	}
@@ -86,7 +221,10 @@ public:
 	void Pop()
 	{
 		if (size > 0)
+		{
 			--size;
+			Destroy(data + size, 1);
+		}
 	}
 
 	/// <summary>
@@ -94,6 +232,7 @@ public:
 	/// </summary>
 	void Clear()
 	{
+		Destroy(data, size);
 		size = 0;
 	}
 
@@ -137,6 +276,79 @@ public:
 		throw out_of_range("Top value does not exist.");
 	}
 
+	/// <summary>
+	/// Write the stack to a binary writer, from the bottom value to the top.
+	/// Trivially copyable values are written straight from the array in one piece.
+	/// </summary>
+	/// <param name="writer">The writer to write to.</param>
+	void Serialize(BinaryWriter& writer) const
+	{
+		writer.WriteHeader<T>(SERIAL_STACK, size);
+		writer.WriteValues(data, size);
+	}
+
+	/// <summary>
+	/// Replace the values of the stack with a stack read from a binary reader.
+	/// The capacity grows if the values will not fit.
+	/// The values are read into a new array that grows a piece at a time, so a corrupt count runs out of stream before it can allocate more than the stream holds.
+	/// The stack is only changed once every value has been read, so if the read throws the stack is left as it was.
+	/// </summary>
+	/// <param name="reader">The reader to read from.</param>
+	void Deserialize(BinaryReader& reader)
+	{
+		size_t count = reader.ReadHeader<T>(SERIAL_STACK);
+		if (count > numeric_limits<unsigned int>::max())
+			throw length_error("The stream holds more values than a stack can fit.");
+
+		const size_t chunk = DESERIALIZE_CHUNK_BYTES / sizeof(T) > 0 ? DESERIALIZE_CHUNK_BYTES / sizeof(T) : 1;
+		unsigned int newCapacity = count < capacity ? capacity : (unsigned int)(count < chunk ? count : chunk);
+		T* newData = Allocate(newCapacity);
+		unsigned int read = 0;
+		try
+		{
+			while (read < count)
+			{
+				unsigned int piece = (unsigned int)(count - read < chunk ? count - read : chunk);
+				if (read + piece > newCapacity)
+				{
+					//Double the array, but never past the count
+					size_t grown = (size_t)newCapacity * 2 > read + piece ? (size_t)newCapacity * 2 : read + piece;
+					unsigned int target = (unsigned int)(grown < count ? grown : count);
+					newData = Grow(newData, read, target);
+					newCapacity = target;
+				}
+
+				if constexpr (is_trivially_copyable_v<T>)
+				{
+					reader.ReadValues(newData + read, piece);
+					read += piece;
+				}
+				else
+				{
+					for (unsigned int i = 0; i < piece; ++i)
+					{
+						T value;
+						reader.ReadValue(value);
+						new (newData + read) T(move(value));
+						++read;
+					}
+				}
+			}
+		}
+		catch (...)
+		{
+			Destroy(newData, read);
+			::operator delete(newData);
+			throw;
+		}
+
+		Destroy(data, size);
+		::operator delete(data);
+		data = newData;
+		size = read;
+		capacity = newCapacity;
+	}
+
 	/// <summary>
 	/// = operator overload.
 	/// Copies the values from another stack into this stack.
@@ -145,13 +357,44 @@ public:
 	/// <returns>This stack with values from the other stack.</returns>
 	Stack<T>& operator= (const Stack<T>& other)
 	{
-		delete[] data;	//Delete the data in this stack first
+		if (this == &other)
+			return *this;
+
+		//Copy the data first so this stack is left untouched if a copy throws
+		T* newData = CopyData(other);
+
+		//Delete the data in this stack
+		Destroy(data, size);
+		::operator delete(data);
+
+		//Set the values
+		data = newData;
+		capacity = other.capacity;
+		size = other.size;
+		return *this;
+	}
+
+	/// <summary>
+	/// Move assignment operator overload.
+	/// Takes the values from the other stack, leaving it empty.
+	/// </summary>
+	/// <param name="other">The stack to move values from.</param>
+	/// <returns>This stack with the values from the other stack.</returns>
+	Stack<T>& operator= (Stack<T>&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		//Delete the data in this stack first
+		Destroy(data, size);
+		::operator delete(data);
 
-		//Set the values and copy the data over
+		//Take the data from the other stack
 		capacity = other.capacity;
 		size = other.size;
-		data = new T[capacity];
-		memcpy(data, other.data, sizeof(T) * capacity);
+		data = other.data;
+		other.data = nullptr;
+		other.size = 0;
 		return *this;
 	}
 
@@ -172,17 +415,28 @@ public:
 	}
 
 	/// <summary>
-	/// Print details about the stack to std::cout.
+	/// Append the top value of the stack to a text buffer in the same format as the << operator.
 	/// </summary>
-	void PrintDetails() const
+	/// <param name="buffer">The buffer to append to.</param>
+	void Format(TextBuffer& buffer) const
 	{
-		cout << "Size: " << size << "   ";
-		cout << "Capacity: " << capacity << "   ";
 		if (!Empty())
-			cout << Top();
+			buffer.Append(Top());
 		else
-			cout << "Empty";
-		cout << endl;
+			buffer.Append("Empty");
+	}
+
+	/// <summary>
+	/// Print details about the stack to std::cout.
+	/// The line is formatted in a buffer and written in one piece, without flushing std::cout.
+	/// </summary>
+	void PrintDetails() const
+	{
+		TextBuffer& buffer = ScratchTextBuffer();
+		buffer.Append("Size: ").Append(size).Append("   ");
+		buffer.Append("Capacity: ").Append(capacity).Append("   ");
+		Format(buffer);
+		buffer.Append('\n').WriteTo(cout);
 	}
 
 	/// <summary>
@@ -191,8 +445,8 @@ public:
 	/// <returns>A string representation of the list.</returns>
 	string ToString() const
 	{
-		ostringstream stream;
-		stream << *this;
-		return stream.str();
+		TextBuffer buffer;
+		Format(buffer);
+		return buffer.Str();
 	}
 };
\ No newline at end of file
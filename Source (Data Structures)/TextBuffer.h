@@ -0,0 +1,282 @@
+/*
+	File: TextBuffer.h
+	Contains: TextBuffer, ScratchTextBuffer
+*/
+
+#pragma once
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <charconv>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+using namespace std;
+
+static const size_t FORMAT_ALL = numeric_limits<size_t>::max();		//Pass to Format() to show every element
+
+/// <summary>
+/// The Text Buffer is a growable character buffer for formatting containers without an ostringstream.
+/// Clear() keeps the memory, so a buffer that is reused (e.g. every frame) stops allocating once it has grown to fit.
+/// Numbers are written with to_chars, in the same format an ostream uses by default.
+/// Other types are written with their << operator through a stream that writes straight into the buffer.
+/// </summary>
+class TextBuffer
+{
+private:
+	/// <summary>
+	/// A stream buffer that appends everything written to it to a text buffer.
+	/// </summary>
+	class Sink : public streambuf
+	{
+	private:
+		TextBuffer& owner;	//The buffer to append to
+
+	protected:
+		int_type overflow(int_type c) override
+		{
+			if (!traits_type::eq_int_type(c, traits_type::eof()))
+				owner.Append(traits_type::to_char_type(c));
+			return traits_type::not_eof(c);
+		}
+
+		streamsize xsputn(const char* s, streamsize count) override
+		{
+			owner.Append(s, (size_t)count);
+			return count;
+		}
+
+	public:
+		Sink(TextBuffer& _owner) : owner(_owner) {}
+	};
+
+	char* text;					//The characters
+	size_t length;				//The number of characters in the buffer
+	size_t capacity;			//The number of characters that fit
+	unique_ptr<Sink> sink;		//Created the first time a type without to_chars is appended
+	unique_ptr<ostream> stream;	//Writes to the sink
+
+	/// <summary>
+	/// Get the stream that writes into this buffer, creating it the first time.
+	/// </summary>
+	/// <returns>The stream.</returns>
+	ostream& Stream()
+	{
+		if (stream == nullptr)
+		{
+			sink = make_unique<Sink>(*this);
+			stream = make_unique<ostream>(sink.get());
+		}
+		return *stream;
+	}
+
+public:
+	/// <summary>
+	/// Overloaded constructor.
+	/// </summary>
+	/// <param name="_capacity">The number of characters to allocate room for.</param>
+	TextBuffer(size_t _capacity = 256)
+	{
+		capacity = _capacity > 0 ? _capacity : 1;
+		text = new char[capacity];
+		length = 0;
+	}
+
+	TextBuffer(const TextBuffer&) = delete;
+	TextBuffer& operator= (const TextBuffer&) = delete;
+
+	/// <summary>
+	/// Deconstructor.
+	/// </summary>
+	~TextBuffer()
+	{
+		delete[] text;
+	}
+
+	/// <summary>
+	/// Make sure the buffer can hold a number of characters, doubling its capacity if it can't.
+	/// </summary>
+	/// <param name="newCapacity">The number of characters that must fit.</param>
+	void Reserve(size_t newCapacity)
+	{
+		if (newCapacity <= capacity)
+			return;
+
+		if (newCapacity < capacity * 2)
+			newCapacity = capacity * 2;
+		char* newText = new char[newCapacity];
+		memcpy(newText, text, length);
+		delete[] text;
+		text = newText;
+		capacity = newCapacity;
+	}
+
+	/// <summary>
+	/// Remove the characters, keeping the memory for the next ones.
+	/// </summary>
+	void Clear()
+	{
+		length = 0;
+	}
+
+	/// <summary>
+	/// Append some characters.
+	/// </summary>
+	/// <param name="characters">The characters to append.</param>
+	/// <param name="count">The number of characters.</param>
+	/// <returns>This buffer.</returns>
+	TextBuffer& Append(const char* characters, size_t count)
+	{
+		Reserve(length + count);
+		memcpy(text + length, characters, count);
+		length += count;
+		return *this;
+	}
+
+	/// <summary>
+	/// Append a null-terminated string.
+	/// </summary>
+	/// <param name="characters">The string to append.</param>
+	/// <returns>This buffer.</returns>
+	TextBuffer& Append(const char* characters)
+	{
+		return Append(characters, strlen(characters));
+	}
+
+	/// <summary>
+	/// Append a string.
+	/// </summary>
+	/// <param name="value">The string to append.</param>
+	/// <returns>This buffer.</returns>
+	TextBuffer& Append(const string& value)
+	{
+		return Append(value.data(), value.size());
+	}
+
+	/// <summary>
+	/// Append one character.
+	/// </summary>
+	/// <param name="character">The character to append.</param>
+	/// <returns>This buffer.</returns>
+	TextBuffer& Append(char character)
+	{
+		Reserve(length + 1);
+		text[length++] = character;
+		return *this;
+	}
+
+	/// <summary>
+	/// Append a character a number of times, e.g. for indenting.
+	/// </summary>
+	/// <param name="character">The character to append.</param>
+	/// <param name="count">The number of times to append it.</param>
+	/// <returns>This buffer.</returns>
+	TextBuffer& Repeat(char character, size_t count)
+	{
+		Reserve(length + count);
+		memset(text + length, character, count);
+		length += count;
+		return *this;
+	}
+
+	/// <summary>
+	/// Append a value the way it would be written to an ostream.
+	/// Numbers are converted with to_chars, anything else with its << operator.
+	/// </summary>
+	/// <param name="value">The value to append.</param>
+	/// <returns>This buffer.</returns>
+	template <typename V>
+	TextBuffer& Append(const V& value)
+	{
+		if constexpr (is_same_v<V, bool>)
+			return Append(value ? '1' : '0');
+		else if constexpr (is_same_v<V, signed char> || is_same_v<V, unsigned char>)
+			return Append((char)value);
+		else if constexpr (is_integral_v<V>)
+		{
+			Reserve(length + numeric_limits<V>::digits10 + 3);
+			length = to_chars(text + length, text + capacity, value).ptr - text;
+		}
+		else if constexpr (is_floating_point_v<V>)
+		{
+			//The general format with a precision of 6 matches an ostream's default
+			Reserve(length + 32);
+			length = to_chars(text + length, text + capacity, value, chars_format::general, 6).ptr - text;
+		}
+		else
+			Stream() << value;
+		return *this;
+	}
+
+	/// <summary>
+	/// Get the characters. They aren't null-terminated.
+	/// </summary>
+	/// <returns>A pointer to the first character.</returns>
+	const char* Data() const
+	{
+		return text;
+	}
+
+	/// <summary>
+	/// Getter for the number of characters in the buffer.
+	/// </summary>
+	/// <returns>The number of characters.</returns>
+	size_t Length() const
+	{
+		return length;
+	}
+
+	/// <summary>
+	/// Get a view of the characters, which is valid until the buffer is next changed.
+	/// </summary>
+	/// <returns>The characters.</returns>
+	string_view View() const
+	{
+		return string_view(text, length);
+	}
+
+	/// <summary>
+	/// Copy the characters into a string.
+	/// </summary>
+	/// <returns>The characters.</returns>
+	string Str() const
+	{
+		return string(text, length);
+	}
+
+	/// <summary>
+	/// Write the characters to an ostream in one call, without flushing it.
+	/// </summary>
+	/// <param name="os">The ostream to write to.</param>
+	void WriteTo(ostream& os) const
+	{
+		os.write(text, (streamsize)length);
+	}
+
+	/// <summary>
+	/// << operator overload.
+	/// Writes the characters to an ostream.
+	/// </summary>
+	/// <param name="os">The ostream to write to.</param>
+	/// <param name="buffer">The buffer to write.</param>
+	/// <returns>The ostream.</returns>
+	friend ostream& operator<< (ostream& os, const TextBuffer& buffer)
+	{
+		buffer.WriteTo(os);
+		return os;
+	}
+};
+
+/// <summary>
+/// Get an empty text buffer for this thread to format into.
+/// It is the same buffer every call, so the PrintDetails() functions don't allocate once it has grown.
+/// </summary>
+/// <returns>The buffer, cleared.</returns>
+inline TextBuffer& ScratchTextBuffer()
+{
+	static thread_local TextBuffer buffer(4096);
+	buffer.Clear();
+	return buffer;
+}
\ No newline at end of file
@@ -0,0 +1,1151 @@
+/*
+	File: UnrolledLinkedList.h
+	Contains: UnrolledLinkedList, UnrolledLinkedListNode, UnrolledLinkedListIterator
+*/
+
+#pragma once
+#include <iostream>
+#include <functional>
+#include <type_traits>
+#include "DynamicList.h"
+#include "Serialization.h"
+#include "TextBuffer.h"
+#include "NodePool.h"
+
+using namespace std;
+
+/// <summary>
+/// The Unrolled Linked List is a doubly-linked list where each node holds an array of up to K elements instead of one.
+/// Walking the list reads the elements of a node one after another, so iterating and searching follow one pointer
+/// (and take one cache miss) for every K elements rather than for every element.
+/// Inserting into a full node splits it in half, and erasing from a node that falls below half full merges it with the next node,
+/// or moves some of the next node's elements into it, so the nodes stay at least half full.
+/// It has the same interface as the LinkedList. Inserting or erasing still takes constant time for a given K, but shifts the elements after it in the node,
+/// so it invalidates the iterators into that node (and the one it is split from or merged with). Use the iterator that is returned instead.
+/// The default K fills a node's array with about 256 bytes.
+/// </summary>
+template <typename T, size_t K = (256 / sizeof(T) > 4 ? 256 / sizeof(T) : 4), typename Allocator = NewAllocator>
+class UnrolledLinkedList
+{
+	static_assert(K >= 2, "An unrolled linked list node must hold at least 2 elements.");
+
+private:
+	/// <summary>
+	/// The Unrolled Linked List Node contains an array of elements and a pointer to the next & previous node.
+	/// </summary>
+	class UnrolledLinkedListNode
+	{
+	public:
+		T data[K];							//The elements, of which the first count are in use
+		unsigned int count;					//The number of elements in the node
+		UnrolledLinkedListNode* next;		//A pointer to the next node
+		UnrolledLinkedListNode* previous;	//A pointer to the previous node
+
+		/// <summary>
+		/// Overloaded constructor.
+		/// </summary>
+		/// <param name="_next">A pointer to the next node.</param>
+		/// <param name="_previous">A pointer to the previous node.</param>
+		UnrolledLinkedListNode(UnrolledLinkedListNode* _next, UnrolledLinkedListNode* _previous)
+		{
+			count = 0;
+			next = _next;
+			previous = _previous;
+		}
+	};
+
+public:
+	/// <summary>
+	/// The Unrolled Linked List Iterator class allows iterating through an unrolled linked list.
+	/// It points to a node and the position of an element in it. End() has no node, so comparing against it doesn't read the list.
+	/// </summary>
+	class UnrolledLinkedListIterator
+	{
+	private:
+		UnrolledLinkedListNode* node;		//The node holding the element that this iterator is pointing to, or nullptr at the end
+		unsigned int index;					//The position of the element in the node
+		const UnrolledLinkedList* list;		//The list, so the iterator can move back from the end to the last node
+
+		friend class UnrolledLinkedList;	//The list uses the node directly, so positional edits don't have to search for it
+
+	public:
+		/// <summary>
+		/// Default constructor.
+		/// </summary>
+		UnrolledLinkedListIterator()
+		{
+			node = nullptr;
+			index = 0;
+			list = nullptr;
+		}
+
+		/// <summary>
+		/// Overloaded constructor.
+		/// </summary>
+		/// <param name="_node">A pointer to the node holding the element this iterator should point to, or nullptr for the end.</param>
+		/// <param name="_index">The position of the element in the node.</param>
+		/// <param name="_list">The list the node belongs to.</param>
+		UnrolledLinkedListIterator(UnrolledLinkedListNode* _node, unsigned int _index, const UnrolledLinkedList* _list)
+		{
+			node = _node;
+			index = _index;
+			list = _list;
+		}
+
+		/// <summary>
+		/// == operator overload.
+		/// Checks if this iterator is equal to another by testing if they point to the same position in the same node.
+		/// </summary>
+		/// <param name="other">The other iterator to check against.</param>
+		/// <returns>True if the two iterators are equal.</returns>
+		bool operator== (const UnrolledLinkedListIterator& other) const
+		{
+			return node == other.node && index == other.index;
+		}
+
+		/// <summary>
+		/// != operator overload.
+		/// Checks if this iterator is not equal to another.
+		/// </summary>
+		/// <param name="other">The other iterator to check against.</param>
+		/// <returns>True if the two iterators are not equal.</returns>
+		bool operator!= (const UnrolledLinkedListIterator& other) const
+		{
+			return !(*this == other);
+		}
+
+		UnrolledLinkedListIterator Next() const
+		{
+			UnrolledLinkedListIterator iter(*this);
+			++iter;
+			return iter;
+		}
+
+		UnrolledLinkedListIterator Next(unsigned int increment) const
+		{
+			//Skip over whole nodes rather than stepping through each of their elements
+			UnrolledLinkedListIterator iter(*this);
+			while (increment > 0 && iter.node != nullptr)
+			{
+				unsigned int remaining = iter.node->count - iter.index;
+				if (increment < remaining)
+				{
+					iter.index += increment;
+					break;
+				}
+				increment -= remaining;
+				iter.node = iter.node->next;
+				iter.index = 0;
+			}
+			return iter;
+		}
+
+		UnrolledLinkedListIterator Previous() const
+		{
+			UnrolledLinkedListIterator iter(*this);
+			--iter;
+			return iter;
+		}
+
+		UnrolledLinkedListIterator Previous(unsigned int increment) const
+		{
+			//Skip over whole nodes rather than stepping through each of their elements
+			UnrolledLinkedListIterator iter(*this);
+			if (increment > 0 && iter.node == nullptr)
+			{
+				--iter;
+				--increment;
+			}
+			while (increment > 0 && iter.node != nullptr)
+			{
+				if (increment <= iter.index)
+				{
+					iter.index -= increment;
+					break;
+				}
+				increment -= iter.index + 1;
+				iter.node = iter.node->previous;
+				iter.index = iter.node != nullptr ? iter.node->count - 1 : 0;
+			}
+			return iter;
+		}
+
+		/// <summary>
+		/// ++i operator overload.
+		/// Will move this iterator to point to the next element, moving on to the next node after the last element of a node.
+		/// </summary>
+		/// <returns>This iterator representing the next element.</returns>
+		UnrolledLinkedListIterator& operator++ ()
+		{
+			if (node != nullptr && ++index >= node->count)
+			{
+				node = node->next;
+				index = 0;
+			}
+			return *this;
+		}
+
+		/// <summary>
+		/// --i operator overload.
+		/// Will move this iterator to point to the previous element, moving back to the previous node before the first element of a node.
+		/// </summary>
+		/// <returns>This iterator representing the previous element.</returns>
+		UnrolledLinkedListIterator& operator-- ()
+		{
+			if (node == nullptr)	//Move back from the end to the last element
+			{
+				if (list != nullptr && list->tail != nullptr)
+				{
+					node = list->tail;
+					index = node->count - 1;
+				}
+			}
+			else
+			{
+				if (index > 0)
+					--index;
+				else
+				{
+					node = node->previous;
+					index = node != nullptr ? node->count - 1 : 0;
+				}
+			}
+			return *this;
+		}
+
+		/// <summary>
+		/// * de-reference operator overload.
+		/// Will return the element that the iterator points to.
+		/// </summary>
+		/// <returns>The element that the iterator is representing.</returns>
+		T& operator* () const
+		{
+			if (node != nullptr && index < node->count)
+				return node->data[index];
+
+			//Throw an error if the element does not exist
+			throw out_of_range("Element at this iterator does not exist.");
+		}
+
+		/// <summary>
+		/// -> arrow operator overload.
+		/// Will return a pointer to the element that the iterator points to.
+		/// </summary>
+		/// <returns>The element that the iterator is representing.</returns>
+		T* operator-> () const
+		{
+			return &**this;
+		}
+	};
+
+private:
+	UnrolledLinkedListNode* head;	//The first node, or nullptr if the list is empty
+	UnrolledLinkedListNode* tail;	//The last node, or nullptr if the list is empty
+	unsigned int size;				//The number of elements in the list
+	Allocator allocator;			//Allocates the nodes
+
+	/// <summary>
+	/// Release an array slot that is no longer in use, so a value such as a string gives its memory back straight away.
+	/// </summary>
+	/// <param name="slot">The slot.</param>
+	static void ReleaseSlot(T& slot)
+	{
+		if constexpr (!is_trivially_destructible_v<T>)
+			slot = T();
+	}
+
+	/// <summary>
+	/// Create an empty node and link it in after another.
+	/// </summary>
+	/// <param name="node">The node to link the new node after, or nullptr to link it at the front.</param>
+	/// <returns>The new node.</returns>
+	UnrolledLinkedListNode* LinkNodeAfter(UnrolledLinkedListNode* node)
+	{
+		UnrolledLinkedListNode* next = node != nullptr ? node->next : head;
+		UnrolledLinkedListNode* newNode = allocator.template New<UnrolledLinkedListNode>(next, node);
+		if (node != nullptr)
+			node->next = newNode;
+		else
+			head = newNode;
+		if (next != nullptr)
+			next->previous = newNode;
+		else
+			tail = newNode;
+		return newNode;
+	}
+
+	/// <summary>
+	/// Unlink a node from the list and delete it.
+	/// </summary>
+	/// <param name="node">The node to delete.</param>
+	void DeleteNode(UnrolledLinkedListNode* node)
+	{
+		if (node->previous != nullptr)
+			node->previous->next = node->next;
+		else
+			head = node->next;
+		if (node->next != nullptr)
+			node->next->previous = node->previous;
+		else
+			tail = node->previous;
+		allocator.Delete(node);
+	}
+
+	/// <summary>
+	/// Split a full node in half, moving its second half into a new node after it.
+	/// </summary>
+	/// <param name="node">The node to split.</param>
+	/// <returns>The new node holding the second half.</returns>
+	UnrolledLinkedListNode* Split(UnrolledLinkedListNode* node)
+	{
+		UnrolledLinkedListNode* newNode = LinkNodeAfter(node);
+		unsigned int half = node->count / 2;
+		for (unsigned int i = half; i < node->count; ++i)
+		{
+			newNode->data[i - half] = move(node->data[i]);
+			ReleaseSlot(node->data[i]);
+		}
+		newNode->count = node->count - half;
+		node->count = half;
+		return newNode;
+	}
+
+	/// <summary>
+	/// Move the elements of the next node onto the end of a node, and delete the next node.
+	/// Both nodes' elements must fit in one node.
+	/// </summary>
+	/// <param name="node">The node to merge the next node into.</param>
+	void MergeNext(UnrolledLinkedListNode* node)
+	{
+		UnrolledLinkedListNode* next = node->next;
+		for (unsigned int i = 0; i < next->count; ++i)
+			node->data[node->count + i] = move(next->data[i]);
+		node->count += next->count;
+		DeleteNode(next);
+	}
+
+	/// <summary>
+	/// Keep a node at least half full after an element has been erased from it.
+	/// The next node is merged into it if they fit in one node, otherwise enough of the next node's elements are moved over to even them out.
+	/// The node's elements stay where they are, with the next node's appended after them.
+	/// </summary>
+	/// <param name="node">The node an element was erased from.</param>
+	void Rebalance(UnrolledLinkedListNode* node)
+	{
+		UnrolledLinkedListNode* next = node->next;
+		if (node->count >= K / 2 || next == nullptr)
+			return;
+
+		if (node->count + next->count <= K)
+		{
+			MergeNext(node);
+			return;
+		}
+
+		unsigned int moved = (next->count - node->count) / 2;
+		for (unsigned int i = 0; i < moved; ++i)
+			node->data[node->count + i] = move(next->data[i]);
+		node->count += moved;
+		for (unsigned int i = moved; i < next->count; ++i)
+			next->data[i - moved] = move(next->data[i]);
+		for (unsigned int i = next->count - moved; i < next->count; ++i)
+			ReleaseSlot(next->data[i]);
+		next->count -= moved;
+	}
+
+	/// <summary>
+	/// Merge the next node into a node if their elements fit in one node.
+	/// Used where nodes are joined or cut, so the list doesn't build up small nodes.
+	/// </summary>
+	/// <param name="node">The node to merge the next node into, or nullptr.</param>
+	void MergeIfFits(UnrolledLinkedListNode* node)
+	{
+		if (node != nullptr && node->next != nullptr && node->count + node->next->count <= K)
+			MergeNext(node);
+	}
+
+	/// <summary>
+	/// Cut the list before the element at a position, splitting its node in two if the position is inside it.
+	/// </summary>
+	/// <param name="node">The position's node, or nullptr for the end of the list.</param>
+	/// <param name="index">The position of the element in the node.</param>
+	/// <returns>The node before the cut, or nullptr if the cut is at the front of the list.</returns>
+	UnrolledLinkedListNode* CutBefore(UnrolledLinkedListNode* node, unsigned int index)
+	{
+		if (node == nullptr)
+			return tail;
+		if (index == 0)
+			return node->previous;
+
+		if (index < node->count)
+		{
+			UnrolledLinkedListNode* newNode = LinkNodeAfter(node);
+			for (unsigned int i = index; i < node->count; ++i)
+			{
+				newNode->data[i - index] = move(node->data[i]);
+				ReleaseSlot(node->data[i]);
+			}
+			newNode->count = node->count - index;
+			node->count = index;
+		}
+		return node;
+	}
+
+	/// <summary>
+	/// Push a value to the front of the list, copying or moving it as it was passed.
+	/// </summary>
+	/// <param name="value">The value to push.</param>
+	template <typename V>
+	void PushFrontValue(V&& value)
+	{
+		T copy = forward<V>(value);		//Take the value first as it could be in the node that is shifted
+		if (head == nullptr || head->count == K)
+			LinkNodeAfter(nullptr);
+		for (unsigned int i = head->count; i > 0; --i)
+			head->data[i] = move(head->data[i - 1]);
+		head->data[0] = move(copy);
+		++head->count;
+		++size;
+	}
+
+	/// <summary>
+	/// Push a value to the end of the list, copying or moving it as it was passed.
+	/// </summary>
+	/// <param name="value">The value to push.</param>
+	template <typename V>
+	void PushBackValue(V&& value)
+	{
+		if (tail == nullptr || tail->count == K)
+		{
+			T copy = forward<V>(value);		//Take the value first as it could be in the node that is about to be linked to
+			LinkNodeAfter(tail);
+			tail->data[0] = move(copy);
+		}
+		else
+			tail->data[tail->count] = forward<V>(value);
+		++tail->count;
+		++size;
+	}
+
+	/// <summary>
+	/// Insert a value before the given iterator, copying or moving it as it was passed.
+	/// </summary>
+	/// <param name="iter">The iterator to insert a value before.</param>
+	/// <param name="value">The value to insert.</param>
+	/// <returns>An iterator pointing to the inserted value.</returns>
+	template <typename V>
+	UnrolledLinkedListIterator InsertValue(UnrolledLinkedListIterator iter, V&& value)
+	{
+		UnrolledLinkedListNode* node = iter.node;
+		unsigned int index = iter.index;
+
+		//If the list is empty or the iterator points to the end, push to the back so the last node is filled up
+		if (size == 0 || node == nullptr)
+		{
+			PushBackValue(forward<V>(value));
+			return UnrolledLinkedListIterator(tail, tail->count - 1, this);
+		}
+		else if (index > node->count)
+			return End();
+
+		T copy = forward<V>(value);		//Take the value first as it could be in the node that is shifted
+		if (node->count == K)
+		{
+			UnrolledLinkedListNode* newNode = Split(node);
+			if (index > node->count)
+			{
+				index -= node->count;
+				node = newNode;
+			}
+		}
+
+		for (unsigned int i = node->count; i > index; --i)
+			node->data[i] = move(node->data[i - 1]);
+		node->data[index] = move(copy);
+		++node->count;
+		++size;
+		return UnrolledLinkedListIterator(node, index, this);
+	}
+
+public:
+	/// <summary>
+	/// Default constructor.
+	/// </summary>
+	UnrolledLinkedList()
+	{
+		head = nullptr;
+		tail = nullptr;
+		size = 0;
+	}
+
+	/// <summary>
+	/// Copy constructor.
+	/// </summary>
+	/// <param name="copy">The list we are copying.</param>
+	UnrolledLinkedList(const UnrolledLinkedList& copy)
+	{
+		head = nullptr;
+		tail = nullptr;
+		size = 0;
+		*this = copy;
+	}
+
+	/// <summary>
+	/// Move constructor.
+	/// Takes the nodes of another list without copying them, leaving the other list empty.
+	/// </summary>
+	/// <param name="other">The list to take the nodes from.</param>
+	UnrolledLinkedList(UnrolledLinkedList&& other)
+	{
+		head = nullptr;
+		tail = nullptr;
+		size = 0;
+		*this = move(other);
+	}
+
+	/// <summary>
+	/// Deconstructor.
+	/// </summary>
+	~UnrolledLinkedList()
+	{
+		Clear();
+	}
+
+	/// <summary>
+	/// Push a value to the front of the list.
+	/// The first node's elements are shifted along to make room, starting a new node if it is full.
+	/// </summary>
+	/// <param name="value">The value to push.</param>
+	void PushFront(const T& value)
+	{
+		PushFrontValue(value);
+	}
+
+	/// <summary>
+	/// Push a value to the front of the list, moving it rather than copying it.
+	/// </summary>
+	/// <param name="value">The value to move into the list.</param>
+	void PushFront(T&& value)
+	{
+		PushFrontValue(move(value));
+	}
+
+	/// <summary>
+	/// Pop a value off the front of the list.
+	/// </summary>
+	void PopFront()
+	{
+		if (size == 0)	//If there are no elements, just return
+			return;
+
+		for (unsigned int i = 1; i < head->count; ++i)
+			head->data[i - 1] = move(head->data[i]);
+		ReleaseSlot(head->data[--head->count]);
+		if (head->count == 0)
+			DeleteNode(head);
+		--size;
+	}
+
+	/// <summary>
+	/// Push a value to the end of the list, starting a new node if the last one is full.
+	/// </summary>
+	/// <param name="value">The value to push.</param>
+	void PushBack(const T& value)
+	{
+		PushBackValue(value);
+	}
+
+	/// <summary>
+	/// Push a value to the end of the list, moving it rather than copying it.
+	/// </summary>
+	/// <param name="value">The value to move into the list.</param>
+	void PushBack(T&& value)
+	{
+		PushBackValue(move(value));
+	}
+
+	/// <summary>
+	/// Pop a value off the back of the list.
+	/// </summary>
+	void PopBack()
+	{
+		if (size == 0)	//If there are no elements, just return
+			return;
+
+		ReleaseSlot(tail->data[--tail->count]);
+		if (tail->count == 0)
+			DeleteNode(tail);
+		--size;
+	}
+
+	/// <summary>
+	/// Inserts a value before the given iterator.
+	/// Takes constant time for a given K, as the iterator already points to its node. A full node is split in half first.
+	/// </summary>
+	/// <param name="iter">The iterator to insert a value before.</param>
+	/// <param name="value">The value to insert into the list.</param>
+	/// <returns>An iterator pointing to the inserted value.</returns>
+	UnrolledLinkedListIterator Insert(UnrolledLinkedListIterator iter, const T& value)
+	{
+		return InsertValue(iter, value);
+	}
+
+	/// <summary>
+	/// Inserts a value before the given iterator, moving it rather than copying it.
+	/// Takes constant time for a given K, as the iterator already points to its node. A full node is split in half first.
+	/// </summary>
+	/// <param name="iter">The iterator to insert a value before.</param>
+	/// <param name="value">The value to move into the list.</param>
+	/// <returns>An iterator pointing to the inserted value.</returns>
+	UnrolledLinkedListIterator Insert(UnrolledLinkedListIterator iter, T&& value)
+	{
+		return InsertValue(iter, move(value));
+	}
+
+	/// <summary>
+	/// Remove all occurrences of a specific value from the list.
+	/// Each node is compacted in place in one pass, and merged into the node before it if they fit in one node.
+	/// </summary>
+	/// <param name="value">The value to remove from the list.</param>
+	void Remove(const T& value)
+	{
+		//Copy the value as it could be in a slot that is about to be overwritten
+		T target = value;
+
+		UnrolledLinkedListNode* node = head;
+		while (node != nullptr)
+		{
+			UnrolledLinkedListNode* next = node->next;
+			unsigned int kept = 0;
+			for (unsigned int i = 0; i < node->count; ++i)
+			{
+				if (!(node->data[i] == target))
+				{
+					if (kept != i)
+						node->data[kept] = move(node->data[i]);
+					++kept;
+				}
+			}
+			for (unsigned int i = kept; i < node->count; ++i)
+				ReleaseSlot(node->data[i]);
+			size -= node->count - kept;
+			node->count = kept;
+
+			if (kept == 0)
+				DeleteNode(node);
+			else if (node->previous != nullptr && node->previous->count + kept <= K)
+				MergeNext(node->previous);
+			node = next;
+		}
+	}
+
+	/// <summary>
+	/// Erase a specific element from the list.
+	/// Takes constant time for a given K, as the iterator already points to its node.
+	/// </summary>
+	/// <param name="iter">The position of the element to remove.</param>
+	/// <returns>An iterator pointing to the element after the erased one, so elements can be erased while iterating.</returns>
+	UnrolledLinkedListIterator Erase(UnrolledLinkedListIterator iter)
+	{
+		UnrolledLinkedListNode* node = iter.node;
+		unsigned int index = iter.index;
+		if (size == 0 || node == nullptr || index >= node->count)
+			return End();
+
+		for (unsigned int i = index + 1; i < node->count; ++i)
+			node->data[i - 1] = move(node->data[i]);
+		ReleaseSlot(node->data[--node->count]);
+		--size;
+
+		if (node->count == 0)
+		{
+			UnrolledLinkedListNode* next = node->next;
+			DeleteNode(node);
+			return UnrolledLinkedListIterator(next, 0, this);
+		}
+
+		//Rebalancing only appends elements to the node, so the next element is still at the same position if it was in this node
+		Rebalance(node);
+		if (index < node->count)
+			return UnrolledLinkedListIterator(node, index, this);
+		return UnrolledLinkedListIterator(node->next, 0, this);
+	}
+
+	/// <summary>
+	/// Erase the elements from one iterator up to, but not including, another.
+	/// Takes time proportional to the number of elements erased.
+	/// </summary>
+	/// <param name="first">The first element to remove.</param>
+	/// <param name="last">The element after the last one to remove, e.g. End().</param>
+	/// <returns>An iterator pointing to the element after the erased ones.</returns>
+	UnrolledLinkedListIterator Erase(UnrolledLinkedListIterator first, UnrolledLinkedListIterator last)
+	{
+		//Count the elements first, as erasing moves elements between nodes and invalidates the last iterator
+		unsigned int count = 0;
+		for (UnrolledLinkedListIterator iter = first; iter != last && iter.node != nullptr; ++iter)
+			++count;
+		for (; count > 0; --count)
+			first = Erase(first);
+		return first;
+	}
+
+	/// <summary>
+	/// Move every element of another list into this one before a position, leaving the other list empty.
+	/// The position's node is split in two if the position is inside it, then the other list's nodes are relinked between the halves,
+	/// so it takes constant time for a given K. Nodes either side of the joins are merged if they fit in one node.
+	/// If the allocator doesn't let lists share nodes (e.g. PoolAllocator<>), the values are moved into new nodes instead.
+	/// Iterators into the position's node are invalidated.
+	/// </summary>
+	/// <param name="iter">The position to insert the elements before, e.g. End().</param>
+	/// <param name="other">The list to take the elements from.</param>
+	void Splice(UnrolledLinkedListIterator iter, UnrolledLinkedList& other)
+	{
+		if (&other == this || other.size == 0)
+			return;
+
+		UnrolledLinkedListNode* before = CutBefore(iter.node, iter.index);
+		UnrolledLinkedListNode* after = before != nullptr ? before->next : head;
+		UnrolledLinkedListNode* last;
+		if constexpr (Allocator::SHARED_NODES)
+		{
+			UnrolledLinkedListNode* first = other.head;
+			last = other.tail;
+			first->previous = before;
+			last->next = after;
+			if (before != nullptr)
+				before->next = first;
+			else
+				head = first;
+			if (after != nullptr)
+				after->previous = last;
+			else
+				tail = last;
+
+			size += other.size;
+			other.head = nullptr;
+			other.tail = nullptr;
+			other.size = 0;
+		}
+		else
+		{
+			//Fill new nodes after the cut with the other list's values
+			last = before;
+			for (UnrolledLinkedListNode* node = other.head; node != nullptr; node = node->next)
+				for (unsigned int i = 0; i < node->count; ++i)
+				{
+					if (last == before || last->count == K)
+						last = LinkNodeAfter(last);
+					last->data[last->count++] = move(node->data[i]);
+				}
+			size += other.size;
+			other.Clear();
+		}
+
+		MergeIfFits(last);
+		MergeIfFits(before);
+	}
+
+	/// <summary>
+	/// Split the list in two at a position. This list keeps the elements before the position and the rest are moved to a new list.
+	/// The position's node is split in two if the position is inside it, and the nodes after the cut are relinked rather than copied.
+	/// Counting the moved elements takes time proportional to the number of nodes moved.
+	/// If the allocator doesn't let lists share nodes (e.g. PoolAllocator<>), the values are moved into the new list's nodes instead.
+	/// </summary>
+	/// <param name="iter">The first element to move to the new list.</param>
+	/// <returns>A list of the elements from the position to the end.</returns>
+	UnrolledLinkedList SplitAt(UnrolledLinkedListIterator iter)
+	{
+		UnrolledLinkedList rest;
+		if (size == 0 || iter.node == nullptr)
+			return rest;
+
+		UnrolledLinkedListNode* before = CutBefore(iter.node, iter.index);
+		UnrolledLinkedListNode* first = before != nullptr ? before->next : head;
+		if (first == nullptr)
+			return rest;
+
+		unsigned int count = 0;
+		for (UnrolledLinkedListNode* node = first; node != nullptr; node = node->next)
+			count += node->count;
+
+		if constexpr (Allocator::SHARED_NODES)
+		{
+			rest.head = first;
+			rest.tail = tail;
+			rest.size = count;
+			first->previous = nullptr;
+			if (before != nullptr)
+				before->next = nullptr;
+			else
+				head = nullptr;
+			tail = before;
+		}
+		else
+		{
+			for (UnrolledLinkedListNode* node = first; node != nullptr; node = node->next)
+				for (unsigned int i = 0; i < node->count; ++i)
+					rest.PushBack(move(node->data[i]));
+			while (tail != before)
+				DeleteNode(tail);
+		}
+		size -= count;
+
+		//The cut may have left a small node at the end of this list and at the start of the new one
+		MergeIfFits(before != nullptr ? before->previous : nullptr);
+		rest.MergeIfFits(rest.head);
+		return rest;
+	}
+
+	/// <summary>
+	/// Merge another sorted list into this sorted one, leaving the other list empty.
+	/// The merge is stable: of two equal values, the one already in this list comes first.
+	/// </summary>
+	/// <param name="other">The sorted list to take the elements from.</param>
+	void Merge(UnrolledLinkedList& other)
+	{
+		Merge(other, less<T>());
+	}
+
+	/// <summary>
+	/// Merge another list into this one, both sorted with a custom ordering, leaving the other list empty.
+	/// The other list's nodes are spliced onto the end, then sorted with MergeSort(). Its tim sort finds the two sorted runs
+	/// and merges them in linear time.
+	/// </summary>
+	/// <param name="other">The sorted list to take the elements from.</param>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	template <typename Compare>
+	void Merge(UnrolledLinkedList& other, Compare comp)
+	{
+		if (&other == this || other.size == 0)
+			return;
+
+		Splice(End(), other);
+		MergeSort(comp);
+	}
+
+	/// <summary>
+	/// Clear all values from the list.
+	/// If the allocator can release every node at once and the nodes don't need destroying, this takes constant time.
+	/// </summary>
+	void Clear()
+	{
+		if constexpr (Allocator::BULK_RELEASE && is_trivially_destructible_v<UnrolledLinkedListNode>)
+			allocator.Reset();
+		else
+		{
+			while (head != nullptr)
+			{
+				UnrolledLinkedListNode* next = head->next;
+				allocator.Delete(head);
+				head = next;
+			}
+		}
+		head = nullptr;
+		tail = nullptr;
+		size = 0;
+	}
+
+	/// <summary>
+	/// Getter for the size of the list.
+	/// </summary>
+	/// <returns>The number of elements in the list.</returns>
+	unsigned int Size() const
+	{
+		return size;
+	}
+
+	/// <summary>
+	/// Check if the list is empty.
+	/// </summary>
+	/// <returns>True, if empty.</returns>
+	bool Empty() const
+	{
+		return size == 0;
+	}
+
+	/// <summary>
+	/// Sort the list using a bubble sort.
+	/// Takes O(n^2) time, so MergeSort() should be preferred. Neighbouring elements in a node are compared without following a pointer.
+	/// </summary>
+	void BubbleSort()
+	{
+		if (size < 2)
+			return;
+
+		bool sorted = false;
+		while (!sorted)
+		{
+			sorted = true;
+
+			//Compare each element with the one before it, which is in the previous node for the first element of a node
+			T* previous = nullptr;
+			for (UnrolledLinkedListNode* node = head; node != nullptr; node = node->next)
+				for (unsigned int i = 0; i < node->count; ++i)
+				{
+					if (previous != nullptr && *previous > node->data[i])
+					{
+						swap(*previous, node->data[i]);
+						sorted = false;
+					}
+					previous = &node->data[i];
+				}
+		}
+	}
+
+	/// <summary>
+	/// Sort the list using a stable merge sort.
+	/// </summary>
+	void MergeSort()
+	{
+		MergeSort(less<T>());
+	}
+
+	/// <summary>
+	/// Sort the list using a stable merge sort with a custom ordering.
+	/// The elements are moved out into a list, sorted with its tim sort (a merge sort that takes advantage of any order already in the list) and moved back,
+	/// as merging arrays is faster than relinking nodes that each hold K elements. The nodes stay where they are.
+	/// </summary>
+	/// <param name="comp">Returns true if the first value should be ordered before the second.</param>
+	template <typename Compare>
+	void MergeSort(Compare comp)
+	{
+		if (size < 2)
+			return;
+
+		List<T> values(size);
+		for (UnrolledLinkedListNode* node = head; node != nullptr; node = node->next)
+			for (unsigned int i = 0; i < node->count; ++i)
+				values.Push(move(node->data[i]));
+
+		values.TimSort(comp);
+
+		size_t v = 0;
+		for (UnrolledLinkedListNode* node = head; node != nullptr; node = node->next)
+			for (unsigned int i = 0; i < node->count; ++i)
+				node->data[i] = move(values[v++]);
+	}
+
+	/// <summary>
+	/// Performa basic linear search for a value.
+	/// Scans each node's array directly rather than going through the iterator's checks.
+	/// </summary>
+	/// <param name="value">The value to search for.</param>
+	/// <returns>The iterator pointing to the value if found, otherwise points to End().</returns>
+	UnrolledLinkedListIterator LinearSearch(const T& value) const
+	{
+		for (UnrolledLinkedListNode* node = head; node != nullptr; node = node->next)
+			for (unsigned int i = 0; i < node->count; ++i)
+				if (node->data[i] == value)
+					return UnrolledLinkedListIterator(node, i, this);
+		return End();
+	}
+
+	/// <summary>
+	/// Write the list to a binary writer, in the same format as a LinkedList so either can read the other's data.
+	/// Each node's array is written in one piece.
+	/// </summary>
+	/// <param name="writer">The writer to write to.</param>
+	void Serialize(BinaryWriter& writer) const
+	{
+		writer.WriteHeader<T>(SERIAL_LINKED_LIST, size);
+		for (UnrolledLinkedListNode* node = head; node != nullptr; node = node->next)
+			writer.WriteValues(node->data, node->count);
+	}
+
+	/// <summary>
+	/// Replace the values of the list with a linked list read from a binary reader.
+	/// The values are read straight into full nodes.
+	/// </summary>
+	/// <param name="reader">The reader to read from.</param>
+	void Deserialize(BinaryReader& reader)
+	{
+		size_t count = reader.ReadHeader<T>(SERIAL_LINKED_LIST);
+		if (count > numeric_limits<unsigned int>::max())
+			throw length_error("The stream holds more values than a list can fit.");
+
+		Clear();
+		try
+		{
+			while (count > 0)
+			{
+				unsigned int read = count < K ? (unsigned int)count : (unsigned int)K;
+				LinkNodeAfter(tail);
+				reader.ReadValues(tail->data, read);
+				tail->count = read;
+				size += read;
+				count -= read;
+			}
+		}
+		catch (...)
+		{
+			Clear();
+			throw;
+		}
+	}
+
+	/// <summary>
+	/// Getter for the first value in the list.
+	/// </summary>
+	/// <returns>The first value in the list.</returns>
+	T& First() const
+	{
+		if (size > 0)
+			return head->data[0];
+
+		//Throw an error if the list is empty
+		throw out_of_range("First value does not exist.");
+	}
+
+	/// <summary>
+	/// Getter for the last value in the list.
+	/// </summary>
+	/// <returns>The last value in the list.</returns>
+	T& Last() const
+	{
+		if (size > 0)
+			return tail->data[tail->count - 1];
+
+		//Throw an error if the list is empty
+		throw out_of_range("Last value does not exist.");
+	}
+
+	/// <summary>
+	/// A getter for an iterator pointing to the beginning of the list.
+	/// </summary>
+	/// <returns>An iterator at the start of the list.</returns>
+	UnrolledLinkedListIterator Begin() const
+	{
+		return UnrolledLinkedListIterator(head, 0, this);
+	}
+
+	/// <summary>
+	/// A getter for an iterator pointing to the end of the list.
+	/// It has no node, so it is the same however the list changes and is cheap to compare against in a loop.
+	/// </summary>
+	/// <returns>An iterator one past the last element.</returns>
+	UnrolledLinkedListIterator End() const
+	{
+		return UnrolledLinkedListIterator(nullptr, 0, this);
+	}
+
+	/// <summary>
+	/// Assignment operator overload.
+	/// Assigns this list the values of another list, filling each node.
+	/// </summary>
+	/// <param name="other">The list to copy the values from.</param>
+	/// <returns>This list with the values from the other list.</returns>
+	UnrolledLinkedList& operator= (const UnrolledLinkedList& other)
+	{
+		if (this != &other)
+		{
+			Clear();
+			for (UnrolledLinkedListNode* node = other.head; node != nullptr; node = node->next)
+				for (unsigned int i = 0; i < node->count; ++i)
+					PushBack(node->data[i]);
+		}
+		return *this;
+	}
+
+	/// <summary>
+	/// Move assignment operator overload.
+	/// Takes the nodes of another list without copying them, leaving the other list empty.
+	/// If the allocator doesn't let lists share nodes (e.g. PoolAllocator<>), the values are moved over instead.
+	/// </summary>
+	/// <param name="other">The list to take the nodes from.</param>
+	/// <returns>This list with the nodes from the other list.</returns>
+	UnrolledLinkedList& operator= (UnrolledLinkedList&& other)
+	{
+		if (this != &other)
+		{
+			Clear();
+			if constexpr (Allocator::SHARED_NODES)
+			{
+				swap(head, other.head);
+				swap(tail, other.tail);
+				swap(size, other.size);
+			}
+			else
+			{
+				for (UnrolledLinkedListNode* node = other.head; node != nullptr; node = node->next)
+					for (unsigned int i = 0; i < node->count; ++i)
+						PushBack(move(node->data[i]));
+				other.Clear();
+			}
+		}
+		return *this;
+	}
+
+	/// <summary>
+	/// << operator overload.
+	/// Allows displaying the list to an output stream.
+	/// </summary>
+	/// <param name="os">The output stream to display to.</param>
+	/// <param name="list">The list to display.</param>
+	/// <returns>The output stream with the list displayed to it.</returns>
+	friend ostream& operator<< (ostream& os, const UnrolledLinkedList& list)
+	{
+		os << "[";
+		for (auto i = list.Begin(); i != list.End(); ++i)
+		{
+			if (i != list.Begin())
+				os << ", ";
+			os << *i;
+		}
+		os << "]";
+		return os;
+	}
+
+	/// <summary>
+	/// Append the list to a text buffer in the same format as the << operator.
+	/// Scans each node's array directly rather than going through the iterator's checks.
+	/// </summary>
+	/// <param name="buffer">The buffer to append to.</param>
+	/// <param name="maxElements">The most elements to show, the rest are replaced by "...".</param>
+	void Format(TextBuffer& buffer, size_t maxElements = FORMAT_ALL) const
+	{
+		size_t shown = size < maxElements ? size : maxElements;
+		buffer.Append('[');
+		size_t i = 0;
+		for (UnrolledLinkedListNode* node = head; node != nullptr && i < shown; node = node->next)
+			for (unsigned int j = 0; j < node->count && i < shown; ++j, ++i)
+			{
+				if (i != 0)
+					buffer.Append(", ");
+				buffer.Append(node->data[j]);
+			}
+		if (shown < size)
+			buffer.Append(shown == 0 ? "..." : ", ...");
+		buffer.Append(']');
+	}
+
+	/// <summary>
+	/// Print details about the list to std::cout.
+	/// The line is formatted in a buffer and written in one piece, without flushing std::cout.
+	/// </summary>
+	/// <param name="maxElements">The most elements to show, the rest are replaced by "...".</param>
+	void PrintDetails(size_t maxElements = FORMAT_ALL) const
+	{
+		size_t shown = size < maxElements ? size : maxElements;
+		TextBuffer& buffer = ScratchTextBuffer();
+		buffer.Append("Size: ").Append(size).Append("   ");
+		size_t i = 0;
+		for (UnrolledLinkedListNode* node = head; node != nullptr && i < shown; node = node->next)
+			for (unsigned int j = 0; j < node->count && i < shown; ++j, ++i)
+				buffer.Append(node->data[j]).Append(' ');
+		if (shown < size)
+			buffer.Append("... ");
+		buffer.Append('\n').WriteTo(cout);
+	}
+
+	/// <summary>
+	/// Get the list represented as a string.
+	/// </summary>
+	/// <param name="maxElements">The most elements to show, the rest are replaced by "...".</param>
+	/// <returns>A string representation of the list.</returns>
+	string ToString(size_t maxElements = FORMAT_ALL) const
+	{
+		TextBuffer buffer;
+		Format(buffer, maxElements);
+		return buffer.Str();
+	}
+};
\ No newline at end of file